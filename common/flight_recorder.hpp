@@ -2,11 +2,16 @@
 
 #include <config.h>
 
-#include <common/utils.hpp>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
 
-#include <fstream>
-#include <iomanip>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
 #include <iostream>
+#include <memory>
 #include <vector>
 namespace pldm
 {
@@ -15,35 +20,92 @@ namespace flightrecorder
 
 using ReqOrResponse = bool;
 using FlightRecorderData = std::vector<uint8_t>;
-using FlightRecorderTimeStamp = std::string;
-using FlightRecorderRecord =
-    std::tuple<FlightRecorderTimeStamp, ReqOrResponse, FlightRecorderData>;
-using FlightRecorderCassette = std::vector<FlightRecorderRecord>;
 
-static constexpr auto flightRecorderDumpPath = "/tmp/pldm_flight_recorder";
+static constexpr auto flightRecorderDumpPath = FLIGHT_RECORDER_DUMP_PATH;
+
+/** @brief Size of a slot of the recorder, messages longer than what fits in
+ *  a slot are truncated
+ */
+static constexpr size_t flightRecorderSlotSize = 256;
+
+/** @brief Number of slots in the ring, kept nonzero so that the ring
+ *  arithmetic still compiles when the recorder is disabled with
+ *  FLIGHT_RECORDER_MAX_ENTRIES set to 0
+ */
+static constexpr size_t flightRecorderEntries =
+    std::max<size_t>(1, FLIGHT_RECORDER_MAX_ENTRIES);
+
+/** @struct FlightRecorderSlot
+ *
+ *  A message in the recorder. The slots are dumped as they are, after a
+ *  FlightRecorderFileHeader.
+ */
+struct FlightRecorderSlot
+{
+    /** @brief position of the message in the recorder's history plus one,
+     *  0 while the slot is empty or being written
+     */
+    uint64_t sequence;
+    /** @brief CLOCK_MONOTONIC time the message was recorded at, in ns */
+    uint64_t timestamp;
+    /** @brief length of the message, which may exceed the data kept */
+    uint32_t length;
+    /** @brief whether the message was sent (Tx) or received (Rx) */
+    uint8_t isTx;
+    uint8_t reserved[3];
+    uint8_t data[flightRecorderSlotSize - 24];
+};
+static_assert(sizeof(FlightRecorderSlot) == flightRecorderSlotSize);
+
+static constexpr char flightRecorderMagic[8] = {'P', 'L', 'D', 'M',
+                                                'F', 'R', 'E', 'C'};
+static constexpr uint32_t flightRecorderVersion = 1;
+
+/** @struct FlightRecorderFileHeader
+ *
+ *  Header of a flight recorder dump. The two clock readings let a decoder
+ *  turn the monotonic timestamps of the slots into wall clock time.
+ */
+struct FlightRecorderFileHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t slotSize;
+    uint32_t entries;
+    uint32_t reserved;
+    /** @brief CLOCK_MONOTONIC time of the dump, in ns */
+    uint64_t monotonicTime;
+    /** @brief CLOCK_REALTIME time of the dump, in ns */
+    uint64_t realTime;
+};
 
 /** @class FlightRecorder
  *
  *  The class for implementing the PLDM flight recorder logic. This class
  *  handles the insertion of the data into the recorder and also provides
  *  API's to dump the flight recorder into a file.
+ *
+ *  The recorder is a ring of flightRecorderEntries fixed size slots
+ *  allocated up front, so recording a message costs a clock read and a
+ *  copy. Writers claim slots with an atomic counter and never block.
  */
 
 class FlightRecorder
 {
   private:
-    FlightRecorder() : index(0)
+    FlightRecorder() : next(0)
     {
         flightRecorderPolicy = FLIGHT_RECORDER_MAX_ENTRIES ? true : false;
         if (flightRecorderPolicy)
         {
-            tapeRecorder = FlightRecorderCassette(FLIGHT_RECORDER_MAX_ENTRIES);
+            tapeRecorder =
+                std::make_unique<FlightRecorderSlot[]>(flightRecorderEntries);
         }
     }
 
   protected:
-    int index;
-    FlightRecorderCassette tapeRecorder;
+    std::atomic<uint64_t> next;
+    std::unique_ptr<FlightRecorderSlot[]> tapeRecorder;
     bool flightRecorderPolicy;
 
   public:
@@ -68,58 +130,140 @@ class FlightRecorder
      *  @return void
      */
     void saveRecord(const FlightRecorderData& buffer, ReqOrResponse isRequest)
+    {
+        saveRecord(buffer.data(), buffer.size(), isRequest);
+    }
+
+    /** @brief Add records to the flightRecorder
+     *
+     *  @param[in] buffer  - The request/respose bytes
+     *  @param[in] length  - length of buffer
+     *  @param[in] isRequest - bool that captures if it is a request message or
+     *                         a response message
+     *
+     *  @return void
+     */
+    void saveRecord(const uint8_t* buffer, size_t length,
+                    ReqOrResponse isRequest)
     {
         // if the flight recorder policy is enabled, then only insert the
         // messages into the flight recorder, if not this function will be just
         // a no-op
-        if (flightRecorderPolicy)
+        if (!flightRecorderPolicy)
         {
-            int currentIndex = index++;
-            tapeRecorder[currentIndex] = std::make_tuple(
-                pldm::utils::getCurrentSystemTime(), isRequest, buffer);
-            index =
-                (currentIndex == FLIGHT_RECORDER_MAX_ENTRIES - 1) ? 0 : index;
+            return;
         }
+
+        auto sequence = next.fetch_add(1, std::memory_order_relaxed);
+        auto& slot = tapeRecorder[sequence % flightRecorderEntries];
+        std::atomic_ref<uint64_t> slotSequence(slot.sequence);
+        slotSequence.store(0, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        slot.timestamp =
+            std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch())
+                .count();
+        slot.length = length;
+        slot.isTx = isRequest;
+        std::memcpy(slot.data, buffer, std::min(length, sizeof(slot.data)));
+
+        slotSequence.store(sequence + 1, std::memory_order_release);
     }
 
     /** @brief play flight recorder
+     *
+     *  Dumps the recorded messages, oldest first, into flightRecorderDumpPath
+     *  in the binary format that pldmtool flightrecorder decodes.
      *
      *  @return void
      */
 
     void playRecorder()
     {
-        if (flightRecorderPolicy)
+        if (!flightRecorderPolicy)
+        {
+            std::cerr << "Fight recorder policy is disabled\n";
+            return;
+        }
+
+        std::cout << "Dumping the flight recorder into : "
+                  << flightRecorderDumpPath << "\n";
+
+        size_t maxSize =
+            sizeof(FlightRecorderFileHeader) +
+            flightRecorderEntries * sizeof(FlightRecorderSlot);
+        int fd = open(flightRecorderDumpPath, O_RDWR | O_CREAT | O_TRUNC,
+                      S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH);
+        if (fd < 0)
+        {
+            std::cerr << "Failed to open the flight recorder dump, errno="
+                      << errno << "\n";
+            return;
+        }
+        if (ftruncate(fd, maxSize) < 0)
         {
-            std::ofstream recorderOutputFile(flightRecorderDumpPath);
-            std::cout << "Dumping the flight recorder into : "
-                      << flightRecorderDumpPath << "\n";
+            std::cerr << "Failed to size the flight recorder dump, errno="
+                      << errno << "\n";
+            close(fd);
+            return;
+        }
+        auto dump = static_cast<uint8_t*>(
+            mmap(nullptr, maxSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0));
+        if (dump == MAP_FAILED)
+        {
+            std::cerr << "Failed to map the flight recorder dump, errno="
+                      << errno << "\n";
+            close(fd);
+            return;
+        }
 
-            for (const auto& message : tapeRecorder)
+        auto slots = reinterpret_cast<FlightRecorderSlot*>(
+            dump + sizeof(FlightRecorderFileHeader));
+        uint32_t entries = 0;
+        auto end = next.load(std::memory_order_acquire);
+        auto begin =
+            end > flightRecorderEntries ? end - flightRecorderEntries : 0;
+        for (auto sequence = begin; sequence < end; ++sequence)
+        {
+            auto& slot = tapeRecorder[sequence % flightRecorderEntries];
+            std::atomic_ref<uint64_t> slotSequence(slot.sequence);
+            if (slotSequence.load(std::memory_order_acquire) != sequence + 1)
+            {
+                continue;
+            }
+            std::memcpy(&slots[entries], &slot, sizeof(slot));
+            std::atomic_thread_fence(std::memory_order_acquire);
+            // Skip a slot that got overwritten while it was being copied
+            if (slotSequence.load(std::memory_order_relaxed) == sequence + 1)
             {
-                recorderOutputFile << std::get<FlightRecorderTimeStamp>(message)
-                                   << " : ";
-                if (std::get<ReqOrResponse>(message))
-                {
-                    recorderOutputFile << "Tx : \n";
-                }
-                else
-                {
-                    recorderOutputFile << "Rx : \n";
-                }
-                for (const auto& word : std::get<FlightRecorderData>(message))
-                {
-                    recorderOutputFile << std::setfill('0') << std::setw(2)
-                                       << std::hex << (unsigned)word << " ";
-                }
-                recorderOutputFile << std::endl;
+                ++entries;
             }
-            recorderOutputFile.close();
         }
-        else
+
+        FlightRecorderFileHeader header{};
+        std::memcpy(header.magic, flightRecorderMagic, sizeof(header.magic));
+        header.version = flightRecorderVersion;
+        header.slotSize = sizeof(FlightRecorderSlot);
+        header.entries = entries;
+        header.monotonicTime =
+            std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch())
+                .count();
+        header.realTime =
+            std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::system_clock::now().time_since_epoch())
+                .count();
+        std::memcpy(dump, &header, sizeof(header));
+
+        munmap(dump, maxSize);
+        if (ftruncate(fd, sizeof(header) +
+                              entries * sizeof(FlightRecorderSlot)) < 0)
         {
-            std::cerr << "Fight recorder policy is disabled\n";
+            std::cerr << "Failed to trim the flight recorder dump, errno="
+                      << errno << "\n";
         }
+        close(fd);
     }
 };
 
@@ -36,4 +36,7 @@ class MockdBusHandler : public pldm::utils::DBusHandler
 
     MOCK_METHOD(pldm::utils::PropertyValue, getDbusPropertyVariant,
                 (const char*, const char*, const char*), (const override));
+
+    MOCK_METHOD(pldm::utils::PropertyMap, getDbusProperties,
+                (const char*, const char*), (const override));
 };
@@ -7,6 +7,7 @@
 
 #include <sys/time.h>
 
+#include <sdbusplus/bus/match.hpp>
 #include <xyz/openbmc_project/Common/error.hpp>
 
 #include <algorithm>
@@ -16,6 +17,7 @@
 #include <fstream>
 #include <iostream>
 #include <map>
+#include <memory>
 #include <stdexcept>
 #include <string>
 #include <vector>
@@ -40,39 +42,35 @@ std::vector<std::vector<uint8_t>> findStateEffecterPDR(uint8_t /*tid*/,
     std::vector<std::vector<uint8_t>> pdrs;
     try
     {
-        do
+        for (record = pldm_pdr_find_record_by_type(
+                 repo, PLDM_STATE_EFFECTER_PDR, nullptr, &outData, &size);
+             record; record = pldm_pdr_get_next_record_by_type(
+                         record, &outData, &size))
         {
-            record = pldm_pdr_find_record_by_type(repo, PLDM_STATE_EFFECTER_PDR,
-                                                  record, &outData, &size);
-            if (record)
+            auto pdr = reinterpret_cast<pldm_state_effecter_pdr*>(outData);
+            auto compositeEffecterCount = pdr->composite_effecter_count;
+            auto possible_states_start = pdr->possible_states;
+
+            for (auto effecters = 0x00; effecters < compositeEffecterCount;
+                 effecters++)
             {
-                auto pdr = reinterpret_cast<pldm_state_effecter_pdr*>(outData);
-                auto compositeEffecterCount = pdr->composite_effecter_count;
-                auto possible_states_start = pdr->possible_states;
+                auto possibleStates =
+                    reinterpret_cast<state_effecter_possible_states*>(
+                        possible_states_start);
+                auto setId = possibleStates->state_set_id;
+                auto possibleStateSize = possibleStates->possible_states_size;
 
-                for (auto effecters = 0x00; effecters < compositeEffecterCount;
-                     effecters++)
+                if (pdr->entity_type == entityID && setId == stateSetId)
                 {
-                    auto possibleStates =
-                        reinterpret_cast<state_effecter_possible_states*>(
-                            possible_states_start);
-                    auto setId = possibleStates->state_set_id;
-                    auto possibleStateSize =
-                        possibleStates->possible_states_size;
-
-                    if (pdr->entity_type == entityID && setId == stateSetId)
-                    {
-                        std::vector<uint8_t> effecter_pdr(&outData[0],
-                                                          &outData[size]);
-                        pdrs.emplace_back(std::move(effecter_pdr));
-                        break;
-                    }
-                    possible_states_start += possibleStateSize + sizeof(setId) +
-                                             sizeof(possibleStateSize);
+                    std::vector<uint8_t> effecter_pdr(&outData[0],
+                                                      &outData[size]);
+                    pdrs.emplace_back(std::move(effecter_pdr));
+                    break;
                 }
+                possible_states_start += possibleStateSize + sizeof(setId) +
+                                         sizeof(possibleStateSize);
             }
-
-        } while (record);
+        }
     }
     catch (const std::exception& e)
     {
@@ -94,39 +92,34 @@ std::vector<std::vector<uint8_t>> findStateSensorPDR(uint8_t /*tid*/,
     std::vector<std::vector<uint8_t>> pdrs;
     try
     {
-        do
+        for (record = pldm_pdr_find_record_by_type(
+                 repo, PLDM_STATE_SENSOR_PDR, nullptr, &outData, &size);
+             record; record = pldm_pdr_get_next_record_by_type(
+                         record, &outData, &size))
         {
-            record = pldm_pdr_find_record_by_type(repo, PLDM_STATE_SENSOR_PDR,
-                                                  record, &outData, &size);
-            if (record)
+            auto pdr = reinterpret_cast<pldm_state_sensor_pdr*>(outData);
+            auto compositeSensorCount = pdr->composite_sensor_count;
+            auto possible_states_start = pdr->possible_states;
+
+            for (auto sensors = 0x00; sensors < compositeSensorCount; sensors++)
             {
-                auto pdr = reinterpret_cast<pldm_state_sensor_pdr*>(outData);
-                auto compositeSensorCount = pdr->composite_sensor_count;
-                auto possible_states_start = pdr->possible_states;
+                auto possibleStates =
+                    reinterpret_cast<state_sensor_possible_states*>(
+                        possible_states_start);
+                auto setId = possibleStates->state_set_id;
+                auto possibleStateSize = possibleStates->possible_states_size;
 
-                for (auto sensors = 0x00; sensors < compositeSensorCount;
-                     sensors++)
+                if (pdr->entity_type == entityID && setId == stateSetId)
                 {
-                    auto possibleStates =
-                        reinterpret_cast<state_sensor_possible_states*>(
-                            possible_states_start);
-                    auto setId = possibleStates->state_set_id;
-                    auto possibleStateSize =
-                        possibleStates->possible_states_size;
-
-                    if (pdr->entity_type == entityID && setId == stateSetId)
-                    {
-                        std::vector<uint8_t> sensor_pdr(&outData[0],
-                                                        &outData[size]);
-                        pdrs.emplace_back(std::move(sensor_pdr));
-                        break;
-                    }
-                    possible_states_start += possibleStateSize + sizeof(setId) +
-                                             sizeof(possibleStateSize);
+                    std::vector<uint8_t> sensor_pdr(&outData[0],
+                                                    &outData[size]);
+                    pdrs.emplace_back(std::move(sensor_pdr));
+                    break;
                 }
+                possible_states_start += possibleStateSize + sizeof(setId) +
+                                         sizeof(possibleStateSize);
             }
-
-        } while (record);
+        }
     }
     catch (const std::exception& e)
     {
@@ -217,9 +210,76 @@ std::optional<std::vector<set_effecter_state_field>>
     return std::make_optional(std::move(stateField));
 }
 
+namespace
+{
+
+DBusHandlerStats dbusStats{};
+
+/** @brief Services of the (object path, interface) pairs resolved so far, an
+ *         empty interface stands for a lookup without one
+ */
+struct ServiceCache
+{
+    std::map<std::pair<std::string, std::string>, std::string> services;
+    std::unique_ptr<sdbusplus::bus::match::match> nameOwnerChanged;
+    std::unique_ptr<sdbusplus::bus::match::match> interfacesAdded;
+};
+
+ServiceCache& getServiceCache()
+{
+    static ServiceCache cache;
+    if (!cache.nameOwnerChanged)
+    {
+        namespace rules = sdbusplus::bus::match::rules;
+        using Match = sdbusplus::bus::match::match;
+        auto& bus = DBusHandler::getBus();
+
+        // A service that goes away or restarts may come back with its
+        // objects hosted elsewhere
+        cache.nameOwnerChanged = std::make_unique<Match>(
+            bus, rules::nameOwnerChanged(),
+            [](sdbusplus::message::message& msg) {
+                std::string name;
+                std::string oldOwner;
+                std::string newOwner;
+                msg.read(name, oldOwner, newOwner);
+                std::erase_if(cache.services, [&](const auto& entry) {
+                    return entry.second == name || entry.second == oldOwner;
+                });
+            });
+        cache.interfacesAdded = std::make_unique<Match>(
+            bus, rules::interfacesAdded(),
+            [](sdbusplus::message::message& msg) {
+                sdbusplus::message::object_path path;
+                msg.read(path);
+                std::erase_if(cache.services, [&](const auto& entry) {
+                    return entry.first.first == path.str;
+                });
+            });
+    }
+    return cache;
+}
+
+} // namespace
+
+const DBusHandlerStats& DBusHandler::getStats()
+{
+    return dbusStats;
+}
+
 std::string DBusHandler::getService(const char* path,
                                     const char* interface) const
 {
+    auto& cache = getServiceCache();
+    auto key = std::make_pair(std::string(path),
+                              std::string(interface ? interface : ""));
+    auto cached = cache.services.find(key);
+    if (cached != cache.services.end())
+    {
+        ++dbusStats.serviceCacheHits;
+        return cached->second;
+    }
+
     using DbusInterfaceList = std::vector<std::string>;
     std::map<std::string, std::vector<std::string>> mapperResponse;
     auto& bus = DBusHandler::getBus();
@@ -236,10 +296,16 @@ std::string DBusHandler::getService(const char* path,
         mapper.append(path, DbusInterfaceList({}));
     }
 
+    ++dbusStats.mapperCalls;
     auto mapperResponseMsg = bus.call(
         mapper,
         std::chrono::duration_cast<microsec>(sec(DBUS_TIMEOUT)).count());
     mapperResponseMsg.read(mapperResponse);
+    if (mapperResponse.empty())
+    {
+        throw std::runtime_error("No service found for " + key.first);
+    }
+    cache.services.emplace(std::move(key), mapperResponse.begin()->first);
     return mapperResponse.begin()->first;
 }
 
@@ -430,6 +496,7 @@ PropertyValue DBusHandler::getDbusPropertyVariant(
         bus.new_method_call(service.c_str(), objPath, dbusProperties, "Get");
     method.append(dbusInterface, dbusProp);
     PropertyValue value{};
+    ++dbusStats.propertyGets;
     auto reply = bus.call(
         method,
         std::chrono::duration_cast<microsec>(sec(DBUS_TIMEOUT)).count());
@@ -437,6 +504,24 @@ PropertyValue DBusHandler::getDbusPropertyVariant(
     return value;
 }
 
+PropertyMap DBusHandler::getDbusProperties(const char* objPath,
+                                           const char* dbusInterface) const
+{
+    auto& bus = DBusHandler::getBus();
+    auto service = getService(objPath, dbusInterface);
+    auto method =
+        bus.new_method_call(service.c_str(), objPath, dbusProperties, "GetAll");
+    method.append(dbusInterface);
+    PropertyMap properties{};
+    ++dbusStats.propertyGetAlls;
+    auto reply = bus.call(
+        method,
+        std::chrono::duration_cast<microsec>(sec(DBUS_TIMEOUT)).count());
+    reply.read(properties);
+    dbusStats.batchedProperties += properties.size();
+    return properties;
+}
+
 ObjectValueTree DBusHandler::getManagedObj(const char* service,
                                            const char* rootPath)
 {
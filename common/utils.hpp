@@ -195,6 +195,23 @@ class DBusHandlerInterface
     virtual PropertyValue
         getDbusPropertyVariant(const char* objPath, const char* dbusProp,
                                const char* dbusInterface) const = 0;
+
+    virtual PropertyMap getDbusProperties(const char* objPath,
+                                          const char* dbusInterface) const = 0;
+};
+
+/** @struct DBusHandlerStats
+ *
+ *  Counters of the D-Bus calls made through DBusHandler, shared by all the
+ *  instances of the process
+ */
+struct DBusHandlerStats
+{
+    uint64_t mapperCalls;       //!< GetObject calls made to the mapper
+    uint64_t serviceCacheHits;  //!< mapper calls saved by the service cache
+    uint64_t propertyGets;      //!< Properties.Get calls
+    uint64_t propertyGetAlls;   //!< Properties.GetAll calls
+    uint64_t batchedProperties; //!< properties read through GetAll
 };
 
 /**
@@ -219,6 +236,10 @@ class DBusHandler : public DBusHandlerInterface
     /**
      *  @brief Get the DBUS Service name for the input dbus path
      *
+     *  The answers of the mapper are cached for the lifetime of the process,
+     *  an entry is dropped when its service changes owner or when interfaces
+     *  are added to its object.
+     *
      *  @param[in] path - DBUS object path
      *  @param[in] interface - DBUS Interface
      *
@@ -271,6 +292,22 @@ class DBusHandler : public DBusHandlerInterface
         return std::get<Property>(VariantValue);
     }
 
+    /** @brief Get all the properties of an interface of a dbus object with
+     *         a single Properties.GetAll call
+     *
+     *  @param[in] objPath - The Dbus object path
+     *  @param[in] dbusInterface - The Dbus interface
+     *
+     *  @return map of property name to value
+     *
+     *  @throw sdbusplus::exception::exception when it fails
+     */
+    PropertyMap getDbusProperties(const char* objPath,
+                                  const char* dbusInterface) const override;
+
+    /** @brief Get the counters of the D-Bus calls made by this process */
+    static const DBusHandlerStats& getStats();
+
     /** @brief Set Dbus property
      *
      *  @param[in] dBusMap - Object path, property name, interface and property
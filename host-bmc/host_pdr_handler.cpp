@@ -5,6 +5,7 @@
 #include "libpldm/fru.h"
 #include "libpldm/requester/pldm.h"
 #include "libpldm/state_set.h"
+#include "libpldm/utils.h"
 #include "oem/ibm/libpldm/fru.h"
 
 #include "dbus/custom_dbus.hpp"
@@ -19,6 +20,8 @@
 #include <sdeventplus/source/io.hpp>
 #include <sdeventplus/source/time.hpp>
 
+#include <algorithm>
+#include <chrono>
 #include <fstream>
 #include <type_traits>
 
@@ -186,8 +189,13 @@ HostPDRHandler::HostPDRHandler(
                     this->mergedHostParents = false;
                     this->objMapIndex = objPathMap.begin();
                     this->sensorIndex = stateSensorPDRs.begin();
+                    ++this->sensorScanGeneration;
                     this->isHostPdrModified = false;
                     this->modifiedCounter = 0;
+                    // Responses still in flight must not carry on the fetch
+                    ++this->pdrFetchGeneration;
+                    this->pdrWalkNext.reset();
+                    this->pdrWalkTail.reset();
                     fruRecordSetPDRs.clear();
 
                     // After a power off , the remote notes will be deleted
@@ -326,46 +334,207 @@ void HostPDRHandler::getHostPDR(uint32_t nextRecordHandle)
 {
     pdrFetchEvent.reset();
 
-    std::vector<uint8_t> requestMsg(sizeof(pldm_msg_hdr) +
-                                    PLDM_GET_PDR_REQ_BYTES);
-    auto request = reinterpret_cast<pldm_msg*>(requestMsg.data());
-    uint32_t recordHandle{};
-    if (!nextRecordHandle && (!modifiedPDRRecordHandles.empty()) &&
-        isHostPdrModified)
+    // Requests still in flight belong to the fetch this one supersedes
+    ++pdrFetchGeneration;
+    pdrWalkNext.reset();
+    pdrWalkTail.reset();
+    pdrListReachedEnd = false;
+
+    bool listed = (isHostPdrModified && !modifiedPDRRecordHandles.empty()) ||
+                  !pdrRecordHandles.empty();
+    if (nextRecordHandle || !listed)
     {
-        recordHandle = modifiedPDRRecordHandles.front();
-        modifiedPDRRecordHandles.pop_front();
+        pdrWalkNext = nextRecordHandle;
     }
-    else if (!nextRecordHandle && (!pdrRecordHandles.empty()))
+    fillPDRFetchWindow();
+}
+
+void HostPDRHandler::fillPDRFetchWindow()
+{
+    while (pdrFetchWindow.size() < HOST_PDR_FETCH_WINDOW)
     {
-        recordHandle = pdrRecordHandles.front();
-        pdrRecordHandles.pop_front();
+        uint32_t recordHandle{};
+        bool listed = true;
+        bool speculative = false;
+        if (isHostPdrModified && !modifiedPDRRecordHandles.empty())
+        {
+            recordHandle = modifiedPDRRecordHandles.front();
+            modifiedPDRRecordHandles.pop_front();
+        }
+        else if (!pdrRecordHandles.empty())
+        {
+            recordHandle = pdrRecordHandles.front();
+            pdrRecordHandles.pop_front();
+        }
+        else if (pdrWalkNext)
+        {
+            recordHandle = *pdrWalkNext;
+            listed = false;
+            pdrWalkNext.reset();
+        }
+        else if (pdrWalkTail && *pdrWalkTail && *pdrWalkTail != UINT32_MAX)
+        {
+            // Host repos are mostly numbered sequentially, so ask for the
+            // record after the last one before the host names it. A wrong
+            // guess costs a discarded response.
+            recordHandle = *pdrWalkTail + 1;
+            listed = false;
+            speculative = true;
+        }
+        else
+        {
+            break;
+        }
+
+        if (!sendGetPDR(recordHandle, listed, speculative))
+        {
+            break;
+        }
     }
-    else
+}
+
+bool HostPDRHandler::sendGetPDR(uint32_t recordHandle, bool listed,
+                                bool speculative)
+{
+    auto seq = pdrFetchSeq++;
+    pdrFetchWindow.emplace(seq, PDRFetch{recordHandle, pdrFetchGeneration,
+                                         speculative, listed, false, false,
+                                         {}, 0});
+    if (!requestPDRPart(seq, 0, PLDM_GET_FIRSTPART))
     {
-        recordHandle = nextRecordHandle;
+        pdrFetchWindow.erase(seq);
+        return false;
     }
-    auto instanceId = requester.getInstanceId(mctp_eid);
 
-    auto rc =
-        encode_get_pdr_req(instanceId, recordHandle, 0, PLDM_GET_FIRSTPART,
-                           UINT16_MAX, 0, request, PLDM_GET_PDR_REQ_BYTES);
+    if (!listed)
+    {
+        pdrWalkTail = recordHandle;
+    }
+    return true;
+}
+
+bool HostPDRHandler::requestPDRPart(uint32_t seq, uint32_t dataTransferHandle,
+                                    uint8_t transferOpFlag)
+{
+    uint8_t instanceId{};
+    try
+    {
+        instanceId = requester.getInstanceId(mctp_eid);
+    }
+    catch (const std::exception& e)
+    {
+        // The window gets refilled as the requests in flight complete
+        std::cerr << "Failed to get an instance ID for GetPDR, ERROR="
+                  << e.what() << "\n";
+        return false;
+    }
+
+    std::vector<uint8_t> requestMsg(sizeof(pldm_msg_hdr) +
+                                    PLDM_GET_PDR_REQ_BYTES);
+    auto request = reinterpret_cast<pldm_msg*>(requestMsg.data());
+    auto rc = encode_get_pdr_req(
+        instanceId, pdrFetchWindow.at(seq).recordHandle, dataTransferHandle,
+        transferOpFlag, PDR_TRANSFER_CHUNK_SIZE, 0, request,
+        PLDM_GET_PDR_REQ_BYTES);
     if (rc != PLDM_SUCCESS)
     {
         requester.markFree(mctp_eid, instanceId);
         std::cerr << "Failed to encode_get_pdr_req, rc = " << rc << std::endl;
-        return;
+        return false;
     }
 
     rc = handler->registerRequest(
         mctp_eid, instanceId, PLDM_PLATFORM, PLDM_GET_PDR,
         std::move(requestMsg),
-        std::move(std::bind_front(&HostPDRHandler::processHostPDRs, this)));
+        [this, seq](mctp_eid_t /*eid*/, const pldm_msg* response,
+                    size_t respMsgLen) {
+            this->processHostPDRs(seq, response, respMsgLen);
+        });
     if (rc)
     {
         std::cerr << "Failed to send the GetPDR request to Host \n";
+        return false;
     }
+    return true;
 }
+
+bool HostPDRHandler::receivePDRPart(uint32_t seq, PDRFetch& fetch,
+                                    const pldm_msg* response,
+                                    size_t respMsgLen)
+{
+    uint8_t completionCode{};
+    uint32_t nextDataTransferHandle{};
+    uint8_t transferFlag{};
+    uint16_t respCount{};
+    uint8_t transferCRC{};
+    auto offset = fetch.pdr.size();
+    auto rc = decode_get_pdr_resp(response, respMsgLen, &completionCode,
+                                  &fetch.nextRecordHandle,
+                                  &nextDataTransferHandle, &transferFlag,
+                                  &respCount, nullptr, 0, &transferCRC);
+    if (rc == PLDM_SUCCESS && completionCode == PLDM_SUCCESS)
+    {
+        fetch.pdr.resize(offset + respCount);
+        rc = decode_get_pdr_resp(response, respMsgLen, &completionCode,
+                                 &fetch.nextRecordHandle,
+                                 &nextDataTransferHandle, &transferFlag,
+                                 &respCount, fetch.pdr.data() + offset,
+                                 respCount, &transferCRC);
+    }
+    if (rc != PLDM_SUCCESS || completionCode != PLDM_SUCCESS)
+    {
+        // A guess past the host's last record handle is expected to fail
+        if (!fetch.speculative)
+        {
+            std::cerr << "Failed to decode_get_pdr_resp, rc = " << rc
+                      << ", cc=" << static_cast<unsigned>(completionCode)
+                      << ", RECORD_HANDLE=" << fetch.recordHandle
+                      << std::endl;
+        }
+        fetch.pdr.clear();
+        return true;
+    }
+
+    bool start =
+        transferFlag == PLDM_START || transferFlag == PLDM_START_AND_END;
+    bool last = transferFlag == PLDM_END || transferFlag == PLDM_START_AND_END;
+    if (start != !offset || (!start && !last && transferFlag != PLDM_MIDDLE))
+    {
+        std::cerr << "Unexpected GetPDR transfer flag "
+                  << static_cast<unsigned>(transferFlag)
+                  << ", RECORD_HANDLE=" << fetch.recordHandle << std::endl;
+        fetch.pdr.clear();
+        return true;
+    }
+
+    if (!last)
+    {
+        // No use carrying on with a transfer whose record gets dropped
+        if (fetch.generation != pdrFetchGeneration || fetch.discard ||
+            !requestPDRPart(seq, nextDataTransferHandle, PLDM_GET_NEXTPART))
+        {
+            fetch.pdr.clear();
+            return true;
+        }
+        return false;
+    }
+
+    if (transferFlag == PLDM_END &&
+        crc8(fetch.pdr.data(), fetch.pdr.size()) != transferCRC)
+    {
+        std::cerr << "GetPDR transfer CRC mismatch, RECORD_HANDLE="
+                  << fetch.recordHandle << std::endl;
+        fetch.pdr.clear();
+    }
+    else if (fetch.pdr.size() < sizeof(pldm_pdr_hdr))
+    {
+        std::cerr << "Short PDR from the Host, RECORD_HANDLE="
+                  << fetch.recordHandle << std::endl;
+        fetch.pdr.clear();
+    }
+    return true;
+}
+
 std::string HostPDRHandler::updateLedGroupPath(const std::string& path)
 {
 
@@ -658,12 +827,133 @@ void HostPDRHandler::parseStateSensorPDRs()
     }
 }
 
-void HostPDRHandler::processHostPDRs(mctp_eid_t /*eid*/,
-                                     const pldm_msg* response,
+void HostPDRHandler::processHostPDRs(uint32_t seq, const pldm_msg* response,
                                      size_t respMsgLen)
 {
-    static bool merged = false;
-    uint32_t nextRecordHandle{};
+    auto it = pdrFetchWindow.find(seq);
+    if (it == pdrFetchWindow.end())
+    {
+        return;
+    }
+    if (response == nullptr || !respMsgLen)
+    {
+        std::cerr << "Failed to receive response for the GetPDR"
+                     " command, RECORD_HANDLE="
+                  << it->second.recordHandle << "\n";
+        it->second.pdr.clear();
+    }
+    else if (!receivePDRPart(seq, it->second, response, respMsgLen))
+    {
+        // The rest of the record is still on its way
+        return;
+    }
+    it->second.done = true;
+
+    // Commit the PDRs to the repo in the order they were asked for
+    while (!pdrFetchWindow.empty() && pdrFetchWindow.begin()->second.done)
+    {
+        auto fetch = std::move(pdrFetchWindow.begin()->second);
+        pdrFetchWindow.erase(pdrFetchWindow.begin());
+
+        bool current = fetch.generation == pdrFetchGeneration;
+        if (fetch.speculative &&
+            (!current || fetch.discard ||
+             fetch.recordHandle != pdrWalkExpected))
+        {
+            continue;
+        }
+
+        uint32_t nextRecordHandle = fetch.nextRecordHandle;
+        bool processed =
+            !fetch.pdr.empty() && processHostPDR(fetch.pdr, nextRecordHandle);
+        if (!current)
+        {
+            continue;
+        }
+
+        if (fetch.listed)
+        {
+            pdrListReachedEnd = pdrListReachedEnd ||
+                                (processed && !nextRecordHandle);
+            bool moreListed =
+                (isHostPdrModified && !modifiedPDRRecordHandles.empty()) ||
+                !pdrRecordHandles.empty() ||
+                std::any_of(pdrFetchWindow.begin(), pdrFetchWindow.end(),
+                            [this](const auto& entry) {
+                                return entry.second.listed &&
+                                       entry.second.generation ==
+                                           pdrFetchGeneration;
+                            });
+            if (moreListed)
+            {
+                continue;
+            }
+
+            if (pdrListReachedEnd)
+            {
+                pdrListReachedEnd = false;
+                completePDRExchange();
+            }
+            else if (processed && isHostPdrModified)
+            {
+                isHostPdrModified = false;
+            }
+            else if (processed)
+            {
+                pdrWalkNext = nextRecordHandle;
+            }
+            continue;
+        }
+
+        if (!processed)
+        {
+            // The host could not give us the record it named, stop the walk
+            for (auto& [fetchSeq, pending] : pdrFetchWindow)
+            {
+                pending.discard = pending.discard || pending.speculative;
+            }
+            pdrWalkNext.reset();
+            pdrWalkTail.reset();
+            continue;
+        }
+
+        pdrWalkExpected = nextRecordHandle;
+        if (!nextRecordHandle)
+        {
+            // Speculative requests past the end no longer match
+            pdrWalkTail.reset();
+            completePDRExchange();
+            continue;
+        }
+
+        auto nextWalk = std::find_if(
+            pdrFetchWindow.begin(), pdrFetchWindow.end(),
+            [this](const auto& entry) {
+                return !entry.second.listed && !entry.second.discard &&
+                       entry.second.generation == pdrFetchGeneration;
+            });
+        if (nextWalk == pdrFetchWindow.end() ||
+            nextWalk->second.recordHandle != nextRecordHandle)
+        {
+            // Wrong guess, or nothing asked for yet: carry on from the
+            // record handle the host named
+            for (auto& [fetchSeq, pending] : pdrFetchWindow)
+            {
+                pending.discard = pending.discard || pending.speculative;
+            }
+            pdrWalkTail.reset();
+            pdrWalkNext = nextRecordHandle;
+        }
+    }
+
+    deferredFetchPDREvent = std::make_unique<sdeventplus::source::Defer>(
+        event, std::bind(std::mem_fn(&HostPDRHandler::_processFetchPDREvent),
+                         this, std::placeholders::_1));
+}
+
+bool HostPDRHandler::processHostPDR(std::vector<uint8_t>& pdr,
+                                    uint32_t nextRecordHandle)
+{
     uint32_t prevRh{};
     uint8_t tlEid = 0;
     bool tlValid = true;
@@ -672,274 +962,207 @@ void HostPDRHandler::processHostPDRs(mctp_eid_t /*eid*/,
     uint16_t pdrTerminusHandle = 0;
     uint8_t tid = 0;
 
-    uint8_t completionCode{};
-    uint32_t nextDataTransferHandle{};
-    uint8_t transferFlag{};
-    uint16_t respCount{};
-    uint8_t transferCRC{};
-    if (response == nullptr || !respMsgLen)
+    // when nextRecordHandle is 0, we need the recordHandle of the last
+    // PDR and not 0-1.
+    if (!nextRecordHandle)
     {
-        std::cerr << "Failed to receive response for the GetPDR"
-                     " command \n";
-        return;
+        rh = nextRecordHandle;
+    }
+    else
+    {
+        rh = nextRecordHandle - 1;
     }
 
-    auto rc = decode_get_pdr_resp(
-        response, respMsgLen /*- sizeof(pldm_msg_hdr)*/, &completionCode,
-        &nextRecordHandle, &nextDataTransferHandle, &transferFlag, &respCount,
-        nullptr, 0, &transferCRC);
-    std::vector<uint8_t> responsePDRMsg;
-    responsePDRMsg.resize(respMsgLen + sizeof(pldm_msg_hdr));
-    memcpy(responsePDRMsg.data(), response, respMsgLen + sizeof(pldm_msg_hdr));
-    if (rc != PLDM_SUCCESS)
+    auto pdrHdr = reinterpret_cast<pldm_pdr_hdr*>(pdr.data());
+    if (!rh)
     {
-        std::cerr << "Failed to decode_get_pdr_resp, rc = " << rc << std::endl;
-        return;
+        rh = pdrHdr->record_handle;
+    }
+
+    if (pdrHdr->type == PLDM_PDR_ENTITY_ASSOCIATION)
+    {
+        this->mergeEntityAssociations(pdr);
+        mergedEntityAssociations = true;
     }
     else
     {
-        std::vector<uint8_t> pdr(respCount, 0);
-        rc = decode_get_pdr_resp(response, respMsgLen, &completionCode,
-                                 &nextRecordHandle, &nextDataTransferHandle,
-                                 &transferFlag, &respCount, pdr.data(),
-                                 respCount, &transferCRC);
-        if (rc != PLDM_SUCCESS || completionCode != PLDM_SUCCESS)
+        if (pdrHdr->type == PLDM_TERMINUS_LOCATOR_PDR)
         {
-            std::cerr << "Failed to decode_get_pdr_resp: "
-                      << "rc= "
-                      << ", NextRecordhandle :" << rc << nextRecordHandle
-                      << ", cc=" << static_cast<unsigned>(completionCode)
+            pdrTerminusHandle =
+                extractTerminusHandle<pldm_terminus_locator_pdr>(pdr);
+            auto tlpdr =
+                reinterpret_cast<const pldm_terminus_locator_pdr*>(pdr.data());
+
+            terminusHandle = tlpdr->terminus_handle;
+            tid = tlpdr->tid;
+            std::cerr << "Got a terminus Locator PDR with TID:"
+                      << (unsigned)tid
+                      << " and Terminus handle:" << terminusHandle
+                      << " with Valid bit as:" << (unsigned)tlpdr->validity
                       << std::endl;
-            return;
-        }
-        else
-        {
-            // when nextRecordHandle is 0, we need the recordHandle of the last
-            // PDR and not 0-1.
-            if (!nextRecordHandle)
+            auto terminus_locator_type = tlpdr->terminus_locator_type;
+            if (terminus_locator_type == PLDM_TERMINUS_LOCATOR_TYPE_MCTP_EID)
             {
-                rh = nextRecordHandle;
+                auto locatorValue = reinterpret_cast<
+                    const pldm_terminus_locator_type_mctp_eid*>(
+                    tlpdr->terminus_locator_value);
+                tlEid = static_cast<uint8_t>(locatorValue->eid);
             }
-            else
+            if (tlpdr->validity == 0)
             {
-                rh = nextRecordHandle - 1;
+                tlValid = false;
             }
+            tlPDRInfo.insert_or_assign(
+                tlpdr->terminus_handle,
+                std::make_tuple(tlpdr->tid, tlEid, tlpdr->validity));
+        }
+        else if (pdrHdr->type == PLDM_STATE_SENSOR_PDR)
+        {
+            pdrTerminusHandle =
+                extractTerminusHandle<pldm_state_sensor_pdr>(pdr);
+            updateContanierId<pldm_state_sensor_pdr>(entityTree, pdr);
+            stateSensorPDRs.emplace_back(pdr);
+        }
+        else if (pdrHdr->type == PLDM_PDR_FRU_RECORD_SET)
+        {
+            pdrTerminusHandle =
+                extractTerminusHandle<pldm_pdr_fru_record_set>(pdr);
+            updateContanierId<pldm_pdr_fru_record_set>(entityTree, pdr);
+            fruRecordSetPDRs.emplace_back(pdr);
+        }
+        else if (pdrHdr->type == PLDM_STATE_EFFECTER_PDR)
+        {
+            pdrTerminusHandle =
+                extractTerminusHandle<pldm_state_effecter_pdr>(pdr);
+            updateContanierId<pldm_state_effecter_pdr>(entityTree, pdr);
+        }
+        else if (pdrHdr->type == PLDM_NUMERIC_EFFECTER_PDR)
+        {
+            pdrTerminusHandle =
+                extractTerminusHandle<pldm_numeric_effecter_value_pdr>(pdr);
+            updateContanierId<pldm_numeric_effecter_value_pdr>(entityTree,
+                                                               pdr);
+        }
 
-            auto pdrHdr = reinterpret_cast<pldm_pdr_hdr*>(pdr.data());
-            if (!rh)
+        // if the TLPDR is invalid update the repo accordingly
+        if (!tlValid)
+        {
+            pldm_pdr_update_TL_pdr(repo, terminusHandle, tid, tlEid, tlValid);
+        }
+        else
+        {
+            if ((isHostPdrModified == true) || !(modifiedCounter == 0))
             {
-                rh = pdrHdr->record_handle;
-            }
+                bool recFound =
+                    pldm_pdr_find_prev_record_handle(repo, rh, &prevRh);
 
-            if (pdrHdr->type == PLDM_PDR_ENTITY_ASSOCIATION)
-            {
-                this->mergeEntityAssociations(pdr);
-                merged = true;
-            }
-            else
-            {
-                if (pdrHdr->type == PLDM_TERMINUS_LOCATOR_PDR)
+                if (recFound)
                 {
-                    pdrTerminusHandle =
-                        extractTerminusHandle<pldm_terminus_locator_pdr>(pdr);
-                    auto tlpdr =
-                        reinterpret_cast<const pldm_terminus_locator_pdr*>(
-                            pdr.data());
-
-                    terminusHandle = tlpdr->terminus_handle;
-                    tid = tlpdr->tid;
-                    std::cerr
-                        << "Got a terminus Locator PDR with TID:"
-                        << (unsigned)tid
-                        << " and Terminus handle:" << terminusHandle
-                        << " with Valid bit as:" << (unsigned)tlpdr->validity
-                        << std::endl;
-                    auto terminus_locator_type = tlpdr->terminus_locator_type;
-                    if (terminus_locator_type ==
-                        PLDM_TERMINUS_LOCATOR_TYPE_MCTP_EID)
-                    {
-                        auto locatorValue = reinterpret_cast<
-                            const pldm_terminus_locator_type_mctp_eid*>(
-                            tlpdr->terminus_locator_value);
-                        tlEid = static_cast<uint8_t>(locatorValue->eid);
-                    }
-                    if (tlpdr->validity == 0)
+                    // pldm_delete_by_record_handle to delete
+                    // the effecter from the repo using record handle.
+                    pldm_delete_by_record_handle(repo, rh, true);
+
+                    // call pldm_pdr_add_after_prev_record to add the
+                    // record into the repo from where it was deleted
+                    pldm_pdr_add_after_prev_record(repo, pdr.data(), pdr.size(),
+                                                   rh, true, prevRh,
+                                                   pdrTerminusHandle);
+
+                    if ((pdrHdr->type == PLDM_STATE_EFFECTER_PDR) &&
+                        (oemPlatformHandler != nullptr))
                     {
-                        tlValid = false;
+                        auto effecterPdr =
+                            reinterpret_cast<const pldm_state_effecter_pdr*>(
+                                pdr.data());
+                        auto entityType = effecterPdr->entity_type;
+                        auto statesPtr = effecterPdr->possible_states;
+                        auto compEffCount =
+                            effecterPdr->composite_effecter_count;
+
+                        while (compEffCount--)
+                        {
+                            auto state = reinterpret_cast<
+                                const state_effecter_possible_states*>(
+                                statesPtr);
+                            auto stateSetID = state->state_set_id;
+                            oemPlatformHandler->modifyPDROemActions(
+                                entityType, stateSetID);
+
+                            if (compEffCount)
+                            {
+                                statesPtr +=
+                                    sizeof(state_effecter_possible_states) +
+                                    state->possible_states_size - 1;
+                            }
+                        }
                     }
-                    tlPDRInfo.insert_or_assign(
-                        tlpdr->terminus_handle,
-                        std::make_tuple(tlpdr->tid, tlEid, tlpdr->validity));
-                }
-                else if (pdrHdr->type == PLDM_STATE_SENSOR_PDR)
-                {
-                    pdrTerminusHandle =
-                        extractTerminusHandle<pldm_state_sensor_pdr>(pdr);
-                    updateContanierId<pldm_state_sensor_pdr>(entityTree, pdr);
-                    stateSensorPDRs.emplace_back(pdr);
-                }
-                else if (pdrHdr->type == PLDM_PDR_FRU_RECORD_SET)
-                {
-                    pdrTerminusHandle =
-                        extractTerminusHandle<pldm_pdr_fru_record_set>(pdr);
-                    updateContanierId<pldm_pdr_fru_record_set>(entityTree, pdr);
-                    fruRecordSetPDRs.emplace_back(pdr);
+                    modifiedCounter--;
                 }
-                else if (pdrHdr->type == PLDM_STATE_EFFECTER_PDR)
-                {
-                    pdrTerminusHandle =
-                        extractTerminusHandle<pldm_state_effecter_pdr>(pdr);
-                    updateContanierId<pldm_state_effecter_pdr>(entityTree, pdr);
-                }
-                else if (pdrHdr->type == PLDM_NUMERIC_EFFECTER_PDR)
+            }
+            // We need to look for an optimal solution for this, we are
+            // unexpectedly entering this path when we receive multiple
+            // modified PDR repo change events
+            else if ((isHostPdrModified != true) && (modifiedCounter == 0))
+            {
+                bool recFound =
+                    pldm_pdr_find_prev_record_handle(repo, rh, &prevRh);
+                if (recFound)
                 {
-                    pdrTerminusHandle =
-                        extractTerminusHandle<pldm_numeric_effecter_value_pdr>(
-                            pdr);
-                    updateContanierId<pldm_numeric_effecter_value_pdr>(
-                        entityTree, pdr);
-                }
+                    pldm_delete_by_record_handle(repo, rh, true);
 
-                // if the TLPDR is invalid update the repo accordingly
-                if (!tlValid)
-                {
-                    pldm_pdr_update_TL_pdr(repo, terminusHandle, tid, tlEid,
-                                           tlValid);
+                    pldm_pdr_add_after_prev_record(repo, pdr.data(), pdr.size(),
+                                                   rh, true, prevRh,
+                                                   pdrTerminusHandle);
                 }
                 else
                 {
-                    if ((isHostPdrModified == true) || !(modifiedCounter == 0))
-                    {
-                        bool recFound =
-                            pldm_pdr_find_prev_record_handle(repo, rh, &prevRh);
-
-                        if (recFound)
-                        {
-                            // pldm_delete_by_record_handle to delete
-                            // the effecter from the repo using record handle.
-                            pldm_delete_by_record_handle(repo, rh, true);
-
-                            // call pldm_pdr_add_after_prev_record to add the
-                            // record into the repo from where it was deleted
-                            pldm_pdr_add_after_prev_record(
-                                repo, pdr.data(), respCount, rh, true, prevRh,
-                                pdrTerminusHandle);
-
-                            if ((pdrHdr->type == PLDM_STATE_EFFECTER_PDR) &&
-                                (oemPlatformHandler != nullptr))
-                            {
-                                auto effecterPdr = reinterpret_cast<
-                                    const pldm_state_effecter_pdr*>(pdr.data());
-                                auto entityType = effecterPdr->entity_type;
-                                auto statesPtr = effecterPdr->possible_states;
-                                auto compEffCount =
-                                    effecterPdr->composite_effecter_count;
-
-                                while (compEffCount--)
-                                {
-                                    auto state = reinterpret_cast<
-                                        const state_effecter_possible_states*>(
-                                        statesPtr);
-                                    auto stateSetID = state->state_set_id;
-                                    oemPlatformHandler->modifyPDROemActions(
-                                        entityType, stateSetID);
-
-                                    if (compEffCount)
-                                    {
-                                        statesPtr +=
-                                            sizeof(
-                                                state_effecter_possible_states) +
-                                            state->possible_states_size - 1;
-                                    }
-                                }
-                            }
-                            modifiedCounter--;
-                        }
-                    }
-                    // We need to look for an optimal solution for this, we are
-                    // unexpectedly entering this path when we receive multiple
-                    // modified PDR repo change events
-                    else if ((isHostPdrModified != true) &&
-                             (modifiedCounter == 0))
-                    {
-                        bool recFound =
-                            pldm_pdr_find_prev_record_handle(repo, rh, &prevRh);
-                        if (recFound)
-                        {
-                            pldm_delete_by_record_handle(repo, rh, true);
-
-                            pldm_pdr_add_after_prev_record(
-                                repo, pdr.data(), respCount, rh, true, prevRh,
-                                pdrTerminusHandle);
-                        }
-                        else
-                        {
-                            pldm_pdr_add(repo, pdr.data(), respCount, rh, true,
-                                         pdrTerminusHandle);
-                        }
-                    }
+                    pldm_pdr_add(repo, pdr.data(), pdr.size(), rh, true,
+                                 pdrTerminusHandle);
                 }
             }
         }
     }
-    if (!nextRecordHandle)
-    {
-        pldm_pdr_record* firstRecord = repo->first;
-        pldm_pdr_record* lastRecord = repo->last;
-        std::cerr << "First Record in the repo after PDR exchange is: "
-                  << firstRecord->record_handle << std::endl;
-        std::cerr << "Last Record in the repo after PDR exchange is:"
-                  << lastRecord->record_handle << std::endl;
+    return true;
+}
 
-        pldm::hostbmc::utils::updateEntityAssociation(
-            entityAssociations, entityTree, objPathMap, oemPlatformHandler);
+void HostPDRHandler::completePDRExchange()
+{
+    pldm_pdr_record* firstRecord = repo->first;
+    pldm_pdr_record* lastRecord = repo->last;
+    std::cerr << "First Record in the repo after PDR exchange is: "
+              << firstRecord->record_handle << std::endl;
+    std::cerr << "Last Record in the repo after PDR exchange is:"
+              << lastRecord->record_handle << std::endl;
 
-        pldm::serialize::Serialize::getSerialize().setObjectPathMaps(
-            objPathMap);
+    pldm::hostbmc::utils::updateEntityAssociation(
+        entityAssociations, entityTree, objPathMap, oemPlatformHandler);
 
-        if (oemPlatformHandler != nullptr)
-        {
-            pldm::hostbmc::utils::setCoreCount(entityAssociations);
-        }
+    pldm::serialize::Serialize::getSerialize().setObjectPathMaps(objPathMap);
 
-        /*received last record*/
-        this->parseStateSensorPDRs();
-        this->createDbusObjects();
-        if (isHostUp())
-        {
-            std::cout << "Host is UP & Completed the PDR Exchange with host\n";
-            this->setHostSensorState();
-        }
-
-        entityAssociations.clear();
-        mergedHostParents = false;
+    if (oemPlatformHandler != nullptr)
+    {
+        pldm::hostbmc::utils::setCoreCount(entityAssociations);
+    }
 
-        if (merged)
-        {
-            merged = false;
-            deferredPDRRepoChgEvent =
-                std::make_unique<sdeventplus::source::Defer>(
-                    event,
-                    std::bind(
-                        std::mem_fn((&HostPDRHandler::_processPDRRepoChgEvent)),
-                        this, std::placeholders::_1));
-        }
+    /*received last record*/
+    this->parseStateSensorPDRs();
+    this->createDbusObjects();
+    if (isHostUp())
+    {
+        std::cout << "Host is UP & Completed the PDR Exchange with host\n";
+        this->setHostSensorState();
     }
-    else
+
+    entityAssociations.clear();
+    mergedHostParents = false;
+
+    if (mergedEntityAssociations)
     {
-        if (modifiedPDRRecordHandles.empty() && isHostPdrModified)
-        {
-            isHostPdrModified = false;
-        }
-        else
-        {
-            deferredFetchPDREvent =
-                std::make_unique<sdeventplus::source::Defer>(
-                    event,
-                    std::bind(
-                        std::mem_fn((&HostPDRHandler::_processFetchPDREvent)),
-                        this, nextRecordHandle, std::placeholders::_1));
-        }
+        mergedEntityAssociations = false;
+        deferredPDRRepoChgEvent = std::make_unique<sdeventplus::source::Defer>(
+            event,
+            std::bind(std::mem_fn((&HostPDRHandler::_processPDRRepoChgEvent)),
+                      this, std::placeholders::_1));
     }
 }
 
@@ -958,20 +1181,10 @@ void HostPDRHandler::_processPDRRepoChgEvent(
 }
 
 void HostPDRHandler::_processFetchPDREvent(
-    uint32_t nextRecordHandle, sdeventplus::source::EventBase& /*source */)
+    sdeventplus::source::EventBase& /*source */)
 {
     deferredFetchPDREvent.reset();
-    if (!this->pdrRecordHandles.empty())
-    {
-        nextRecordHandle = this->pdrRecordHandles.front();
-        this->pdrRecordHandles.pop_front();
-    }
-    else if (isHostPdrModified && (!this->modifiedPDRRecordHandles.empty()))
-    {
-        nextRecordHandle = this->modifiedPDRRecordHandles.front();
-        this->modifiedPDRRecordHandles.pop_front();
-    }
-    this->getHostPDR(nextRecordHandle);
+    fillPDRFetchWindow();
 }
 
 void HostPDRHandler::setHostFirmwareCondition()
@@ -1021,7 +1234,13 @@ bool HostPDRHandler::isHostUp()
 
 void HostPDRHandler::setHostSensorState()
 {
+    // Responses to an earlier scan no longer count against the window
+    ++sensorScanGeneration;
     sensorIndex = stateSensorPDRs.begin();
+    sensorReadsInFlight = 0;
+    sensorReadsFailed = 0;
+    sensorScanEid = pldm::utils::readHostEID();
+    sensorScanStart = std::chrono::steady_clock::now();
     _setHostSensorState();
 }
 
@@ -1033,199 +1252,202 @@ void HostPDRHandler::_setHostSensorState()
             << "set host state sensor begin : Host is off, stopped sending sensor state commands\n";
         return;
     }
-    if (sensorIndex != stateSensorPDRs.end())
-    {
-        uint8_t mctpEid = pldm::utils::readHostEID();
-        std::vector<uint8_t> stateSensorPDR = *sensorIndex;
-        auto pdr = reinterpret_cast<const pldm_state_sensor_pdr*>(
-            stateSensorPDR.data());
 
-        if (!pdr)
+    while (sensorReadsInFlight < HOST_SENSOR_READ_WINDOW &&
+           sensorIndex != stateSensorPDRs.end())
+    {
+        if (!sendGetStateSensorReadings(*sensorIndex))
         {
-            std::cerr << "Failed to get State sensor PDR" << std::endl;
-            pldm::utils::reportError(
-                "xyz.openbmc_project.PLDM.Error.SetHostSensorState.GetStateSensorPDRFail",
-                pldm::PelSeverity::ERROR);
-            return;
+            if (sensorReadsInFlight)
+            {
+                // Try this sensor again once a read in flight completes
+                break;
+            }
+            ++sensorReadsFailed;
         }
+        ++sensorIndex;
+    }
 
-        uint16_t sensorId = pdr->sensor_id;
-
-        for (const auto& [terminusHandle, terminusInfo] : tlPDRInfo)
-        {
-            if (terminusHandle == pdr->terminus_handle)
-            {
-                if (std::get<2>(terminusInfo) == PLDM_TL_PDR_VALID)
-                {
-                    mctpEid = std::get<1>(terminusInfo);
-                }
+    if (!sensorReadsInFlight && sensorIndex == stateSensorPDRs.end())
+    {
+        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - sensorScanStart);
+        std::cerr << "Host state sensors synchronized, SENSORS="
+                  << stateSensorPDRs.size() << " FAILED=" << sensorReadsFailed
+                  << " TIME=" << elapsed.count() << "ms\n";
+    }
+}
 
-                bitfield8_t sensorRearm;
-                sensorRearm.byte = 0;
-                uint8_t tid = std::get<0>(terminusInfo);
+bool HostPDRHandler::sendGetStateSensorReadings(
+    const std::vector<uint8_t>& stateSensorPDR)
+{
+    auto pdr =
+        reinterpret_cast<const pldm_state_sensor_pdr*>(stateSensorPDR.data());
+    uint16_t sensorId = pdr->sensor_id;
 
-                auto instanceId = requester.getInstanceId(mctpEid);
-                std::vector<uint8_t> requestMsg(
-                    sizeof(pldm_msg_hdr) +
-                    PLDM_GET_STATE_SENSOR_READINGS_REQ_BYTES);
-                auto request = reinterpret_cast<pldm_msg*>(requestMsg.data());
-                auto rc = encode_get_state_sensor_readings_req(
-                    instanceId, sensorId, sensorRearm, 0, request);
+    auto terminusInfo = tlPDRInfo.find(pdr->terminus_handle);
+    if (terminusInfo == tlPDRInfo.end())
+    {
+        std::cerr << "No terminus locator PDR for the state sensor, SensorId="
+                  << sensorId << std::endl;
+        return false;
+    }
 
-                if (rc != PLDM_SUCCESS)
-                {
-                    requester.markFree(mctpEid, instanceId);
-                    std::cerr << "Failed to "
-                                 "encode_get_state_sensor_readings_req, rc = "
-                              << rc << " SensorId=" << sensorId << std::endl;
-                    pldm::utils::reportError(
-                        "xyz.openbmc_project.PLDM.Error.SetHostSensorState.EncodeStateSensorFail",
-                        pldm::PelSeverity::ERROR);
-                    return;
-                }
+    uint8_t mctpEid = sensorScanEid;
+    if (std::get<2>(terminusInfo->second) == PLDM_TL_PDR_VALID)
+    {
+        mctpEid = std::get<1>(terminusInfo->second);
+    }
+    uint8_t tid = std::get<0>(terminusInfo->second);
 
-                auto getStateSensorReadingRespHandler = [=, this](
-                                                            mctp_eid_t /*eid*/,
-                                                            const pldm_msg*
-                                                                response,
-                                                            size_t respMsgLen) {
-                    if (response == nullptr || !respMsgLen)
-                    {
-                        std::cerr
-                            << "Failed to receive response for "
-                               "getStateSensorReading command for sensor id="
-                            << sensorId << std::endl;
-                        if (this->isHostOff)
-                        {
-                            std::cerr
-                                << "set host state sensor : Host is off, stopped sending sensor state commands\n";
-                            return;
-                        }
-                        if (sensorIndex == stateSensorPDRs.end())
-                        {
-                            return;
-                        }
-                        ++sensorIndex;
-                        _setHostSensorState();
-                        return;
-                    }
-                    std::array<get_sensor_state_field, 8> stateField{};
-                    uint8_t completionCode = 0;
-                    uint8_t comp_sensor_count = 0;
+    uint8_t instanceId{};
+    try
+    {
+        instanceId = requester.getInstanceId(mctpEid);
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << "Failed to get an instance ID for "
+                     "GetStateSensorReadings, ERROR="
+                  << e.what() << " SensorId=" << sensorId << std::endl;
+        return false;
+    }
 
-                    auto rc = decode_get_state_sensor_readings_resp(
-                        response, respMsgLen, &completionCode,
-                        &comp_sensor_count, stateField.data());
+    bitfield8_t sensorRearm;
+    sensorRearm.byte = 0;
+    std::vector<uint8_t> requestMsg(sizeof(pldm_msg_hdr) +
+                                    PLDM_GET_STATE_SENSOR_READINGS_REQ_BYTES);
+    auto request = reinterpret_cast<pldm_msg*>(requestMsg.data());
+    auto rc = encode_get_state_sensor_readings_req(instanceId, sensorId,
+                                                   sensorRearm, 0, request);
+    if (rc != PLDM_SUCCESS)
+    {
+        requester.markFree(mctpEid, instanceId);
+        std::cerr << "Failed to encode_get_state_sensor_readings_req, rc = "
+                  << rc << " SensorId=" << sensorId << std::endl;
+        pldm::utils::reportError(
+            "xyz.openbmc_project.PLDM.Error.SetHostSensorState.EncodeStateSensorFail",
+            pldm::PelSeverity::ERROR);
+        return false;
+    }
 
-                    if (rc != PLDM_SUCCESS || completionCode != PLDM_SUCCESS)
-                    {
-                        std::cerr
-                            << "Failed to "
-                               "decode_get_state_sensor_readings_resp, rc = "
-                            << rc
-                            << " cc=" << static_cast<unsigned>(completionCode)
-                            << " SensorId=" << sensorId << std::endl;
-                        if (sensorIndex == stateSensorPDRs.end())
-                        {
-                            return;
-                        }
-                        ++sensorIndex;
-                        _setHostSensorState();
-                        return;
-                    }
+    auto generation = sensorScanGeneration;
+    auto getStateSensorReadingRespHandler =
+        [this, generation, tid, sensorId](mctp_eid_t /*eid*/,
+                                          const pldm_msg* response,
+                                          size_t respMsgLen) {
+            if (generation != sensorScanGeneration)
+            {
+                return;
+            }
+            --sensorReadsInFlight;
+            if (response == nullptr || !respMsgLen)
+            {
+                std::cerr << "Failed to receive response for "
+                             "getStateSensorReading command for sensor id="
+                          << sensorId << std::endl;
+                ++sensorReadsFailed;
+            }
+            else
+            {
+                processStateSensorReadings(tid, sensorId, response,
+                                           respMsgLen);
+            }
+            _setHostSensorState();
+        };
 
-                    uint8_t eventState;
-                    uint8_t previousEventState;
-                    uint8_t sensorOffset = comp_sensor_count - 1;
+    rc = handler->registerRequest(
+        mctpEid, instanceId, PLDM_PLATFORM, PLDM_GET_STATE_SENSOR_READINGS,
+        std::move(requestMsg), std::move(getStateSensorReadingRespHandler));
+    if (rc != PLDM_SUCCESS)
+    {
+        std::cerr << " Failed to send request to get State sensor "
+                     "reading on Host,"
+                  << " SensorId=" << sensorId << std::endl;
+        return false;
+    }
+    ++sensorReadsInFlight;
+    return true;
+}
 
-                    for (size_t i = 0; i < comp_sensor_count; i++)
-                    {
-                        eventState = stateField[i].present_state;
-                        previousEventState = stateField[i].previous_state;
+void HostPDRHandler::processStateSensorReadings(uint8_t tid, uint16_t sensorId,
+                                                const pldm_msg* response,
+                                                size_t respMsgLen)
+{
+    std::array<get_sensor_state_field, 8> stateField{};
+    uint8_t completionCode = 0;
+    uint8_t comp_sensor_count = 0;
 
-                        emitStateSensorEventSignal(tid, sensorId, sensorOffset,
-                                                   eventState,
-                                                   previousEventState);
+    auto rc = decode_get_state_sensor_readings_resp(
+        response, respMsgLen, &completionCode, &comp_sensor_count,
+        stateField.data());
 
-                        SensorEntry sensorEntry{tid, sensorId};
+    if (rc != PLDM_SUCCESS || completionCode != PLDM_SUCCESS)
+    {
+        std::cerr << "Failed to decode_get_state_sensor_readings_resp, rc = "
+                  << rc << " cc=" << static_cast<unsigned>(completionCode)
+                  << " SensorId=" << sensorId << std::endl;
+        return;
+    }
 
-                        pldm::pdr::EntityInfo entityInfo{};
-                        pldm::pdr::CompositeSensorStates
-                            compositeSensorStates{};
-                        std::vector<pldm::pdr::StateSetId> stateSetIds{};
+    uint8_t eventState;
+    uint8_t previousEventState;
+    uint8_t sensorOffset = comp_sensor_count - 1;
 
-                        try
-                        {
-                            std::tie(entityInfo, compositeSensorStates,
-                                     stateSetIds) =
-                                lookupSensorInfo(sensorEntry);
-                        }
-                        catch (const std::out_of_range& e)
-                        {
-                            try
-                            {
-                                sensorEntry.terminusID = PLDM_TID_RESERVED;
-                                std::tie(entityInfo, compositeSensorStates,
-                                         stateSetIds) =
-                                    lookupSensorInfo(sensorEntry);
-                            }
-                            catch (const std::out_of_range& e)
-                            {
-                                std::cerr << "No mapping for the events"
-                                          << std::endl;
-                                continue;
-                            }
-                        }
+    for (size_t i = 0; i < comp_sensor_count; i++)
+    {
+        eventState = stateField[i].present_state;
+        previousEventState = stateField[i].previous_state;
 
-                        if (sensorOffset > compositeSensorStates.size())
-                        {
-                            std::cerr
-                                << " Error Invalid data, Invalid sensor offset,"
-                                << " SensorId=" << sensorId << std::endl;
-                            return;
-                        }
+        emitStateSensorEventSignal(tid, sensorId, sensorOffset, eventState,
+                                   previousEventState);
 
-                        const auto& possibleStates =
-                            compositeSensorStates[sensorOffset];
-                        if (possibleStates.find(eventState) ==
-                            possibleStates.end())
-                        {
-                            std::cerr
-                                << " Error invalid_data, Invalid event state,"
-                                << " SensorId=" << sensorId << std::endl;
-                            return;
-                        }
-                        const auto& [containerId, entityType, entityInstance] =
-                            entityInfo;
-                        auto stateSetId = stateSetIds[sensorOffset];
-                        pldm::responder::events::StateSensorEntry
-                            stateSensorEntry{containerId,    entityType,
-                                             entityInstance, sensorOffset,
-                                             false,          stateSetId};
-                        handleStateSensorEvent(stateSetIds, stateSensorEntry,
-                                               eventState);
-                    }
-                    if (sensorIndex == stateSensorPDRs.end())
-                    {
-                        return;
-                    }
-                    ++sensorIndex;
-                    _setHostSensorState();
-                };
+        SensorEntry sensorEntry{tid, sensorId};
 
-                rc = handler->registerRequest(
-                    mctpEid, instanceId, PLDM_PLATFORM,
-                    PLDM_GET_STATE_SENSOR_READINGS, std::move(requestMsg),
-                    std::move(getStateSensorReadingRespHandler));
+        pldm::pdr::EntityInfo entityInfo{};
+        pldm::pdr::CompositeSensorStates compositeSensorStates{};
+        std::vector<pldm::pdr::StateSetId> stateSetIds{};
 
-                if (rc != PLDM_SUCCESS)
-                {
-                    std::cerr << " Failed to send request to get State sensor "
-                                 "reading on Host,"
-                              << " SensorId=" << sensorId << std::endl;
-                }
+        try
+        {
+            std::tie(entityInfo, compositeSensorStates, stateSetIds) =
+                lookupSensorInfo(sensorEntry);
+        }
+        catch (const std::out_of_range& e)
+        {
+            try
+            {
+                sensorEntry.terminusID = PLDM_TID_RESERVED;
+                std::tie(entityInfo, compositeSensorStates, stateSetIds) =
+                    lookupSensorInfo(sensorEntry);
             }
+            catch (const std::out_of_range& e)
+            {
+                std::cerr << "No mapping for the events" << std::endl;
+                continue;
+            }
+        }
+
+        if (sensorOffset > compositeSensorStates.size())
+        {
+            std::cerr << " Error Invalid data, Invalid sensor offset,"
+                      << " SensorId=" << sensorId << std::endl;
+            return;
+        }
+
+        const auto& possibleStates = compositeSensorStates[sensorOffset];
+        if (possibleStates.find(eventState) == possibleStates.end())
+        {
+            std::cerr << " Error invalid_data, Invalid event state,"
+                      << " SensorId=" << sensorId << std::endl;
+            return;
         }
+        const auto& [containerId, entityType, entityInstance] = entityInfo;
+        auto stateSetId = stateSetIds[sensorOffset];
+        pldm::responder::events::StateSensorEntry stateSensorEntry{
+            containerId,  entityType, entityInstance,
+            sensorOffset, false,      stateSetId};
+        handleStateSensorEvent(stateSetIds, stateSensorEntry, eventState);
     }
 }
 
@@ -17,10 +17,12 @@
 #include <sdeventplus/event.hpp>
 #include <sdeventplus/source/event.hpp>
 
+#include <chrono>
 #include <deque>
 #include <filesystem>
 #include <map>
 #include <memory>
+#include <optional>
 #include <vector>
 
 namespace pldm
@@ -155,8 +157,11 @@ class HostPDRHandler
      */
     void parseStateSensorPDRs();
 
-    /** @brief this function sends a GetPDR request to Host firmware.
-     *  And processes the PDRs based on type
+    /** @brief this function starts fetching PDRs from Host firmware, either
+     *  the record handles queued by fetchPDR() or the host's repo starting
+     *  at nextRecordHandle. Up to HOST_PDR_FETCH_WINDOW GetPDR requests are
+     *  kept in flight, and the PDRs are processed based on type, in the
+     *  order they were requested in.
      *
      *  @param[in] - nextRecordHandle - the next record handle to ask for
      */
@@ -172,6 +177,11 @@ class HostPDRHandler
 
      */
     void setHostSensorState();
+
+    /** @brief send GetStateSensorReadings requests until
+     *  HOST_SENSOR_READ_WINDOW of them are in flight or every state sensor
+     *  was asked for
+     */
     void _setHostSensorState();
 
     /** @brief check whether Host is running when pldmd starts
@@ -205,6 +215,35 @@ class HostPDRHandler
     void deleteDbusObjects(const std::vector<uint16_t> types);
 
   private:
+    /** @struct PDRFetch
+     *
+     *  A GetPDR request in the fetch window
+     */
+    struct PDRFetch
+    {
+        /** @brief record handle asked for */
+        uint32_t recordHandle;
+        /** @brief fetch the request belongs to, see getHostPDR() */
+        uint32_t generation;
+        /** @brief the record handle is a guess at the next one of the
+         *  host's repo, made before the host named it
+         */
+        bool speculative;
+        /** @brief the record handle came from the lists fetchPDR() got */
+        bool listed;
+        /** @brief a speculative request that turned out to be a wrong guess
+         */
+        bool discard;
+        /** @brief whether the response (or the failure) came in */
+        bool done;
+        /** @brief the record, gathered from the parts of a multipart
+         *  transfer, empty on failure
+         */
+        std::vector<uint8_t> pdr;
+        /** @brief next record handle the host named in its response */
+        uint32_t nextRecordHandle;
+    };
+
     /** @brief set the FRU presence based on the host off signal
      */
     void setPresenceFrus();
@@ -231,25 +270,90 @@ class HostPDRHandler
      */
     void mergeEntityAssociations(const std::vector<uint8_t>& pdr);
 
-    /** @brief process the Host's PDR and add to BMC's PDR repo
-     *  @param[in] eid - MCTP id of Host
+    /** @brief send a GetPDR request to Host and add it to the fetch window
+     *  @param[in] recordHandle - record handle to ask for
+     *  @param[in] listed - whether recordHandle came from the lists
+     *                      fetchPDR() got, rather than from walking the
+     *                      host's repo
+     *  @param[in] speculative - whether recordHandle is a guess at the next
+     *                           record handle of the host's repo
+     *  @return true if the request was sent
+     */
+    bool sendGetPDR(uint32_t recordHandle, bool listed, bool speculative);
+
+    /** @brief send a GetPDR request for a part of a record in the fetch
+     *  window
+     *  @param[in] seq - sequence number of the record in the fetch window
+     *  @param[in] dataTransferHandle - handle of the part, from the response
+     *                                  to the previous part
+     *  @param[in] transferOpFlag - PLDM_GET_FIRSTPART or PLDM_GET_NEXTPART
+     *  @return true if the request was sent
+     */
+    bool requestPDRPart(uint32_t seq, uint32_t dataTransferHandle,
+                        uint8_t transferOpFlag);
+
+    /** @brief add a part of a multipart GetPDR transfer to the record and
+     *  ask for the next part
+     *  @param[in] seq - sequence number of the record in the fetch window
+     *  @param[in,out] fetch - the record in the fetch window
+     *  @param[in] response - response from Host for GetPDR
+     *  @param[in] respMsgLen - response message length
+     *  @return true if the transfer is over, whether the record came in
+     *          whole or not
+     */
+    bool receivePDRPart(uint32_t seq, PDRFetch& fetch,
+                        const pldm_msg* response, size_t respMsgLen);
+
+    /** @brief send GetPDR requests until the fetch window is full or there
+     *  is nothing left to ask for
+     */
+    void fillPDRFetchWindow();
+
+    /** @brief store a GetPDR response in the fetch window and commit the
+     *  responses that are now in order
+     *  @param[in] seq - sequence number of the request in the fetch window
      *  @param[in] response - response from Host for GetPDR
      *  @param[in] respMsgLen - response message length
      */
-    void processHostPDRs(mctp_eid_t eid, const pldm_msg* response,
+    void processHostPDRs(uint32_t seq, const pldm_msg* response,
                          size_t respMsgLen);
 
+    /** @brief process the Host's PDR and add to BMC's PDR repo
+     *  @param[in] pdr - the PDR the Host sent
+     *  @param[in] nextRecordHandle - next record handle in the host's repo
+     *  @return true if the PDR was processed
+     */
+    bool processHostPDR(std::vector<uint8_t>& pdr, uint32_t nextRecordHandle);
+
+    /** @brief wrap up after the last PDR of the host's repo was processed
+     */
+    void completePDRExchange();
+
     /** @brief send PDR Repo change after merging Host's PDR to BMC PDR repo
      *  @param[in] source - sdeventplus event source
      */
     void _processPDRRepoChgEvent(sdeventplus::source::EventBase& source);
 
-    /** @brief fetch the next PDR based on the record handle sent by Host
-     *  @param[in] nextRecordHandle - next record handle
+    /** @brief send the next GetPDR requests of the fetch window
      *  @param[in] source - sdeventplus event source
      */
-    void _processFetchPDREvent(uint32_t nextRecordHandle,
-                               sdeventplus::source::EventBase& source);
+    void _processFetchPDREvent(sdeventplus::source::EventBase& source);
+
+    /** @brief send a GetStateSensorReadings request for a host state sensor
+     *  @param[in] stateSensorPDR - state sensor PDR of the sensor
+     *  @return true if the request was sent
+     */
+    bool sendGetStateSensorReadings(const std::vector<uint8_t>& stateSensorPDR);
+
+    /** @brief update the D-Bus objects with the states the host reported
+     *  @param[in] tid - terminus ID of the sensor
+     *  @param[in] sensorId - sensor ID
+     *  @param[in] response - response from Host for GetStateSensorReadings
+     *  @param[in] respMsgLen - response message length
+     */
+    void processStateSensorReadings(uint8_t tid, uint16_t sensorId,
+                                    const pldm_msg* response,
+                                    size_t respMsgLen);
 
     /** @brief Get FRU record table metadata by host
      */
@@ -382,6 +486,40 @@ class HostPDRHandler
     /** @brief list of PDR record handles modified pointing to host's PDRs */
     PDRRecordHandles modifiedPDRRecordHandles;
 
+    /** @brief GetPDR requests in flight, keyed by the order in which their
+     *  PDRs are committed to the repo
+     */
+    std::map<uint32_t, PDRFetch> pdrFetchWindow;
+
+    /** @brief sequence number of the next GetPDR request */
+    uint32_t pdrFetchSeq = 0;
+
+    /** @brief bumped by getHostPDR(), responses to the requests of an older
+     *  fetch are still processed but no longer drive the fetch
+     */
+    uint32_t pdrFetchGeneration = 0;
+
+    /** @brief record handle the walk of the host's repo has to ask for next
+     */
+    std::optional<uint32_t> pdrWalkNext;
+
+    /** @brief last record handle asked for by the walk, speculative
+     *  requests carry on from it
+     */
+    std::optional<uint32_t> pdrWalkTail;
+
+    /** @brief next record handle named by the last PDR the walk committed */
+    uint32_t pdrWalkExpected = 0;
+
+    /** @brief whether one of the listed record handles was the host's last
+     *  PDR
+     */
+    bool pdrListReachedEnd = false;
+
+    /** @brief whether entity association PDRs were merged during the fetch
+     */
+    bool mergedEntityAssociations = false;
+
     /** @brief maps an entity type to parent pldm_entity from the BMC's entity
      *  association tree
      */
@@ -400,6 +538,25 @@ class HostPDRHandler
 
     PDRList::const_iterator sensorIndex;
     PDRList stateSensorPDRs;
+
+    /** @brief GetStateSensorReadings requests in flight */
+    size_t sensorReadsInFlight = 0;
+
+    /** @brief state sensors of the current scan that could not be read */
+    size_t sensorReadsFailed = 0;
+
+    /** @brief bumped by setHostSensorState(), responses to an older scan
+     *  are ignored
+     */
+    uint32_t sensorScanGeneration = 0;
+
+    /** @brief host EID read once per scan, for sensors whose terminus
+     *  locator PDR is not valid
+     */
+    uint8_t sensorScanEid = 0;
+
+    /** @brief when the current scan started */
+    std::chrono::steady_clock::time_point sensorScanStart;
     /** @brief whether response received from Host */
     bool responseReceived;
 
@@ -889,12 +889,10 @@ struct pldm_bios_table_iter {
 	size_t (*entry_length_handler)(const void *table_entry);
 };
 
-struct pldm_bios_table_iter *
-pldm_bios_table_iter_create(const void *table, size_t length,
-			    enum pldm_bios_table_types type)
+static void pldm_bios_table_iter_init(struct pldm_bios_table_iter *iter,
+				      const void *table, size_t length,
+				      enum pldm_bios_table_types type)
 {
-	struct pldm_bios_table_iter *iter = malloc(sizeof(*iter));
-	assert(iter != NULL);
 	iter->table_data = table;
 	iter->table_len = length;
 	iter->current_pos = 0;
@@ -910,7 +908,15 @@ pldm_bios_table_iter_create(const void *table, size_t length,
 		iter->entry_length_handler = attr_value_table_entry_length;
 		break;
 	}
+}
 
+struct pldm_bios_table_iter *
+pldm_bios_table_iter_create(const void *table, size_t length,
+			    enum pldm_bios_table_types type)
+{
+	struct pldm_bios_table_iter *iter = malloc(sizeof(*iter));
+	assert(iter != NULL);
+	pldm_bios_table_iter_init(iter, table, length, type);
 	return iter;
 }
 
@@ -961,12 +967,9 @@ pldm_bios_table_entry_find_from_table(const void *table, size_t length,
 				      enum pldm_bios_table_types type,
 				      equal_handler equal, const void *key)
 {
-	struct pldm_bios_table_iter *iter =
-	    pldm_bios_table_iter_create(table, length, type);
-	const void *entry =
-	    pldm_bios_table_entry_find_by_iter(iter, key, equal);
-	pldm_bios_table_iter_free(iter);
-	return entry;
+	struct pldm_bios_table_iter iter;
+	pldm_bios_table_iter_init(&iter, table, length, type);
+	return pldm_bios_table_entry_find_by_iter(&iter, key, equal);
 }
 
 static bool string_table_handle_equal(const void *entry, const void *key)
@@ -1061,6 +1064,256 @@ pldm_bios_table_attr_value_find_by_handle(const void *table, size_t length,
 	    attr_value_table_handle_equal, &handle);
 }
 
+typedef uint16_t (*entry_handle_handler)(const void *entry);
+
+struct pldm_bios_table_index {
+	const uint8_t *table_data;
+	size_t table_len;
+	enum pldm_bios_table_types type;
+	/* log2 of the number of slots in each hash table */
+	unsigned bits;
+	/* primary key: string handle or attribute handle */
+	entry_handle_handler handle_of;
+	uint32_t *by_handle;
+	/* secondary key: string of a string table entry, string handle of an
+	 * attribute table entry, NULL for the attribute value table */
+	entry_handle_handler key_handle_of;
+	uint32_t *by_key;
+	/* slots hold the offset of an entry plus one, 0 for an empty slot */
+	uint32_t slots[];
+};
+
+static uint16_t string_entry_handle(const void *entry)
+{
+	return pldm_bios_table_string_entry_decode_handle(entry);
+}
+
+static uint16_t attr_entry_handle(const void *entry)
+{
+	return pldm_bios_table_attr_entry_decode_attribute_handle(entry);
+}
+
+static uint16_t attr_entry_string_handle(const void *entry)
+{
+	return pldm_bios_table_attr_entry_decode_string_handle(entry);
+}
+
+static uint16_t attr_value_entry_handle(const void *entry)
+{
+	return pldm_bios_table_attr_value_entry_decode_handle(entry);
+}
+
+static uint32_t index_slot(uint32_t hash, unsigned bits)
+{
+	return (uint32_t)(hash * 2654435769u) >> (32 - bits);
+}
+
+static uint32_t index_string_hash(const char *str, uint16_t str_length)
+{
+	/* FNV-1a */
+	uint32_t hash = 2166136261u;
+	for (uint16_t i = 0; i < str_length; i++) {
+		hash ^= (uint8_t)str[i];
+		hash *= 16777619u;
+	}
+	return hash;
+}
+
+static const void *index_entry(const struct pldm_bios_table_index *index,
+			       uint32_t slot_value)
+{
+	return index->table_data + slot_value - 1;
+}
+
+static const void *index_find_handle(const struct pldm_bios_table_index *index,
+				     const uint32_t *slots,
+				     entry_handle_handler handle_of,
+				     uint16_t handle)
+{
+	uint32_t mask = (1u << index->bits) - 1;
+	uint32_t i = index_slot(handle, index->bits);
+	for (; slots[i] != 0; i = (i + 1) & mask) {
+		const void *entry = index_entry(index, slots[i]);
+		if (handle_of(entry) == handle)
+			return entry;
+	}
+	return NULL;
+}
+
+static void index_insert_handle(struct pldm_bios_table_index *index,
+				uint32_t *slots, entry_handle_handler handle_of,
+				uint32_t offset)
+{
+	uint16_t handle = handle_of(index->table_data + offset);
+	uint32_t mask = (1u << index->bits) - 1;
+	uint32_t i = index_slot(handle, index->bits);
+	for (; slots[i] != 0; i = (i + 1) & mask) {
+		/* the first entry wins, as it does for a linear search */
+		if (handle_of(index_entry(index, slots[i])) == handle)
+			return;
+	}
+	slots[i] = offset + 1;
+}
+
+static const void *index_find_string(const struct pldm_bios_table_index *index,
+				     const struct string_equal_arg *arg)
+{
+	uint32_t mask = (1u << index->bits) - 1;
+	uint32_t i = index_slot(index_string_hash(arg->str, arg->str_length),
+				index->bits);
+	for (; index->by_key[i] != 0; i = (i + 1) & mask) {
+		const void *entry = index_entry(index, index->by_key[i]);
+		if (string_table_string_equal(entry, arg))
+			return entry;
+	}
+	return NULL;
+}
+
+static void index_insert_string(struct pldm_bios_table_index *index,
+				uint32_t offset)
+{
+	const struct pldm_bios_string_table_entry *entry =
+	    (const void *)(index->table_data + offset);
+	struct string_equal_arg arg = {
+	    pldm_bios_table_string_entry_decode_string_length(entry),
+	    entry->name};
+	uint32_t mask = (1u << index->bits) - 1;
+	uint32_t i = index_slot(index_string_hash(arg.str, arg.str_length),
+				index->bits);
+	for (; index->by_key[i] != 0; i = (i + 1) & mask) {
+		if (string_table_string_equal(
+			index_entry(index, index->by_key[i]), &arg))
+			return;
+	}
+	index->by_key[i] = offset + 1;
+}
+
+struct pldm_bios_table_index *
+pldm_bios_table_index_create(const void *table, size_t length,
+			     enum pldm_bios_table_types type)
+{
+	entry_handle_handler handle_of = NULL;
+	entry_handle_handler key_handle_of = NULL;
+	bool has_key = true;
+	switch (type) {
+	case PLDM_BIOS_STRING_TABLE:
+		handle_of = string_entry_handle;
+		break;
+	case PLDM_BIOS_ATTR_TABLE:
+		handle_of = attr_entry_handle;
+		key_handle_of = attr_entry_string_handle;
+		break;
+	case PLDM_BIOS_ATTR_VAL_TABLE:
+		handle_of = attr_value_entry_handle;
+		has_key = false;
+		break;
+	default:
+		return NULL;
+	}
+	if (table == NULL || length >= UINT32_MAX)
+		return NULL;
+
+	struct pldm_bios_table_iter iter;
+	size_t count = 0;
+	pldm_bios_table_iter_init(&iter, table, length, type);
+	while (!pldm_bios_table_iter_is_end(&iter)) {
+		count++;
+		pldm_bios_table_iter_next(&iter);
+	}
+
+	/* keep the load factor at or below one half, so that probing is
+	 * short and always reaches an empty slot */
+	unsigned bits = 4;
+	while (((size_t)1 << bits) < count * 2)
+		bits++;
+	size_t slots = (size_t)1 << bits;
+	size_t tables = has_key ? 2 : 1;
+
+	struct pldm_bios_table_index *index =
+	    calloc(1, sizeof(*index) + tables * slots * sizeof(uint32_t));
+	if (index == NULL)
+		return NULL;
+
+	index->table_data = table;
+	index->table_len = length;
+	index->type = type;
+	index->bits = bits;
+	index->handle_of = handle_of;
+	index->by_handle = index->slots;
+	index->key_handle_of = key_handle_of;
+	index->by_key = has_key ? index->slots + slots : NULL;
+
+	pldm_bios_table_iter_init(&iter, table, length, type);
+	while (!pldm_bios_table_iter_is_end(&iter)) {
+		uint32_t offset = iter.current_pos;
+		index_insert_handle(index, index->by_handle, handle_of, offset);
+		if (key_handle_of != NULL)
+			index_insert_handle(index, index->by_key, key_handle_of,
+					    offset);
+		else if (has_key)
+			index_insert_string(index, offset);
+		pldm_bios_table_iter_next(&iter);
+	}
+
+	return index;
+}
+
+void pldm_bios_table_index_free(struct pldm_bios_table_index *index)
+{
+	free(index);
+}
+
+const struct pldm_bios_string_table_entry *
+pldm_bios_table_index_string_find_by_handle(
+    const struct pldm_bios_table_index *index, uint16_t handle)
+{
+	if (index == NULL || index->type != PLDM_BIOS_STRING_TABLE)
+		return NULL;
+	return index_find_handle(index, index->by_handle, index->handle_of,
+				 handle);
+}
+
+const struct pldm_bios_string_table_entry *
+pldm_bios_table_index_string_find_by_string(
+    const struct pldm_bios_table_index *index, const char *str)
+{
+	if (index == NULL || index->type != PLDM_BIOS_STRING_TABLE ||
+	    str == NULL)
+		return NULL;
+	struct string_equal_arg arg = {strlen(str), str};
+	return index_find_string(index, &arg);
+}
+
+const struct pldm_bios_attr_table_entry *
+pldm_bios_table_index_attr_find_by_handle(
+    const struct pldm_bios_table_index *index, uint16_t handle)
+{
+	if (index == NULL || index->type != PLDM_BIOS_ATTR_TABLE)
+		return NULL;
+	return index_find_handle(index, index->by_handle, index->handle_of,
+				 handle);
+}
+
+const struct pldm_bios_attr_table_entry *
+pldm_bios_table_index_attr_find_by_string_handle(
+    const struct pldm_bios_table_index *index, uint16_t handle)
+{
+	if (index == NULL || index->type != PLDM_BIOS_ATTR_TABLE)
+		return NULL;
+	return index_find_handle(index, index->by_key, index->key_handle_of,
+				 handle);
+}
+
+const struct pldm_bios_attr_val_table_entry *
+pldm_bios_table_index_attr_value_find_by_handle(
+    const struct pldm_bios_table_index *index, uint16_t handle)
+{
+	if (index == NULL || index->type != PLDM_BIOS_ATTR_VAL_TABLE)
+		return NULL;
+	return index_find_handle(index, index->by_handle, index->handle_of,
+				 handle);
+}
+
 int pldm_bios_table_attr_value_copy_and_update(
     const void *src_table, size_t src_length, void *dest_table,
     size_t *dest_length, const void *entry, size_t entry_length)
@@ -1109,6 +1362,113 @@ out:
 	return rc;
 }
 
+/* Multiply a 32x32 GF(2) matrix by a vector, as in zlib's crc32_combine */
+static uint32_t gf2_matrix_times(const uint32_t *mat, uint32_t vec)
+{
+	uint32_t sum = 0;
+	while (vec) {
+		if (vec & 1)
+			sum ^= *mat;
+		vec >>= 1;
+		mat++;
+	}
+	return sum;
+}
+
+static void gf2_matrix_square(uint32_t *square, const uint32_t *mat)
+{
+	for (int n = 0; n < 32; n++)
+		square[n] = gf2_matrix_times(mat, mat[n]);
+}
+
+/* Advance a zero-initialised CRC32 register over len zero bytes, in
+ * O(log(len)) */
+static uint32_t crc32_shift_zeros(uint32_t crc, size_t len)
+{
+	uint32_t even[32];
+	uint32_t odd[32];
+
+	if (len == 0 || crc == 0)
+		return crc;
+
+	/* operator for one zero bit */
+	odd[0] = 0xedb88320;
+	uint32_t row = 1;
+	for (int n = 1; n < 32; n++) {
+		odd[n] = row;
+		row <<= 1;
+	}
+	/* two zero bits, then four */
+	gf2_matrix_square(even, odd);
+	gf2_matrix_square(odd, even);
+
+	/* apply len zero bytes, squaring the operator for each bit of len */
+	do {
+		gf2_matrix_square(even, odd);
+		if (len & 1)
+			crc = gf2_matrix_times(even, crc);
+		len >>= 1;
+		if (len == 0)
+			break;
+		gf2_matrix_square(odd, even);
+		if (len & 1)
+			crc = gf2_matrix_times(odd, crc);
+		len >>= 1;
+	} while (len != 0);
+
+	return crc;
+}
+
+int pldm_bios_table_attr_value_entry_update_in_place(
+    void *table, size_t length,
+    const struct pldm_bios_attr_val_table_entry *dest_entry, const void *entry,
+    size_t entry_length)
+{
+	POINTER_CHECK(table);
+	POINTER_CHECK(dest_entry);
+	POINTER_CHECK(entry);
+
+	const size_t header_length =
+	    sizeof(struct pldm_bios_attr_val_table_entry);
+	uint8_t *start = table;
+	uint8_t *dest = (uint8_t *)dest_entry;
+	if (length < sizeof(uint32_t) || dest < start ||
+	    (size_t)(dest - start) + header_length > length - sizeof(uint32_t))
+		return PLDM_ERROR_INVALID_DATA;
+	if (entry_length < header_length)
+		return PLDM_ERROR_INVALID_LENGTH;
+
+	const struct pldm_bios_attr_val_table_entry *to_update = entry;
+	if (dest_entry->attr_handle != to_update->attr_handle ||
+	    dest_entry->attr_type != to_update->attr_type)
+		return PLDM_ERROR_INVALID_DATA;
+
+	size_t offset = dest - start;
+	size_t checked_length = length - sizeof(uint32_t);
+	size_t dest_length = attr_value_table_entry_length(dest_entry);
+	if (offset + dest_length > checked_length)
+		return PLDM_ERROR_INVALID_DATA;
+	if (dest_length != entry_length)
+		return PLDM_ERROR_INVALID_LENGTH;
+
+	/* The CRC is affine in the message: the CRCs of two messages that
+	 * only differ in one region differ by the zero-initialised CRC of the
+	 * xor of the regions, advanced over the bytes following the region.
+	 * The former is the xor of the CRCs of the old and new region. */
+	uint32_t delta = crc32(dest, dest_length) ^ crc32(entry, entry_length);
+	delta = crc32_shift_zeros(delta,
+				  checked_length - offset - dest_length);
+
+	uint32_t checksum;
+	memcpy(&checksum, start + checked_length, sizeof(checksum));
+	checksum = htole32(le32toh(checksum) ^ delta);
+
+	memcpy(dest, entry, entry_length);
+	memcpy(start + checked_length, &checksum, sizeof(checksum));
+
+	return PLDM_SUCCESS;
+}
+
 bool pldm_bios_table_checksum(const uint8_t *table, size_t size)
 {
 	if (table == NULL)
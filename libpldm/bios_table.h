@@ -683,6 +683,85 @@ const struct pldm_bios_attr_val_table_entry *
 pldm_bios_table_attr_value_find_by_handle(const void *table, size_t length,
 					  uint16_t handle);
 
+/** @struct pldm_bios_table_index
+ *
+ *  Hash index over a BIOS table, for lookups without a linear scan. The
+ *  index refers to the table memory, the table must outlive the index and
+ *  the index must be recreated whenever the table changes.
+ */
+struct pldm_bios_table_index;
+
+/** @brief Create an index over a BIOS table
+ *
+ *  String table entries are indexed by handle and by string, attribute
+ *  table entries by attribute handle and by string handle and attribute
+ *  value table entries by attribute handle.
+ *
+ *  @param[in] table - Pointer to a buffer of a bios table
+ *  @param[in] length - Length of the table
+ *  @param[in] type - Type of the table
+ *  @return Pointer to the index, NULL if the type is invalid or on failure
+ *          to allocate
+ */
+struct pldm_bios_table_index *
+pldm_bios_table_index_create(const void *table, size_t length,
+			     enum pldm_bios_table_types type);
+
+/** @brief Release an index
+ *  @param[in] index - Pointer to the index
+ */
+void pldm_bios_table_index_free(struct pldm_bios_table_index *index);
+
+/** @brief Find an entry in the string table by handle
+ *  @param[in] index - Index of the BIOS String Table
+ *  @param[in] handle - Handle of the string
+ *  @return Pointer to the entry, NULL if not found or the index is not over
+ *          a string table
+ */
+const struct pldm_bios_string_table_entry *
+pldm_bios_table_index_string_find_by_handle(
+    const struct pldm_bios_table_index *index, uint16_t handle);
+
+/** @brief Find an entry in the string table by string
+ *  @param[in] index - Index of the BIOS String Table
+ *  @param[in] str - The string to look for
+ *  @return Pointer to the entry, NULL if not found or the index is not over
+ *          a string table
+ */
+const struct pldm_bios_string_table_entry *
+pldm_bios_table_index_string_find_by_string(
+    const struct pldm_bios_table_index *index, const char *str);
+
+/** @brief Find an entry in the attribute table by handle
+ *  @param[in] index - Index of the BIOS Attribute Table
+ *  @param[in] handle - The attribute handle
+ *  @return Pointer to the entry, NULL if not found or the index is not over
+ *          an attribute table
+ */
+const struct pldm_bios_attr_table_entry *
+pldm_bios_table_index_attr_find_by_handle(
+    const struct pldm_bios_table_index *index, uint16_t handle);
+
+/** @brief Find an entry in the attribute table by string handle
+ *  @param[in] index - Index of the BIOS Attribute Table
+ *  @param[in] handle - The string handle
+ *  @return Pointer to the entry, NULL if not found or the index is not over
+ *          an attribute table
+ */
+const struct pldm_bios_attr_table_entry *
+pldm_bios_table_index_attr_find_by_string_handle(
+    const struct pldm_bios_table_index *index, uint16_t handle);
+
+/** @brief Find an entry in the attribute value table by handle
+ *  @param[in] index - Index of the BIOS Attribute Value Table
+ *  @param[in] handle - The attribute handle
+ *  @return Pointer to the entry, NULL if not found or the index is not over
+ *          an attribute value table
+ */
+const struct pldm_bios_attr_val_table_entry *
+pldm_bios_table_index_attr_value_find_by_handle(
+    const struct pldm_bios_table_index *index, uint16_t handle);
+
 /** @brief Get the size of pad and checksum
  *  @param[in] size_without_pad - Table size without pad
  *  @return The size of pad and checksum
@@ -714,6 +793,29 @@ int pldm_bios_table_attr_value_copy_and_update(
     const void *src_table, size_t src_length, void *dest_table,
     size_t *dest_length, const void *entry, size_t entry_length);
 
+/** @brief Update an entry of the attribute value table in place
+ *
+ *  The new entry has to be the same length as the entry it replaces, which
+ *  holds for enumeration and integer values and for string values of an
+ *  unchanged length. The checksum of the table is fixed up from the changed
+ *  bytes alone, so the cost does not depend on the size of the table.
+ *
+ *  @param[in,out] table - Pointer to a buffer of a bios table with pad and
+ *                         checksum
+ *  @param[in] length - Length of the table
+ *  @param[in] dest_entry - Pointer to the entry to replace, within table
+ *  @param[in] entry - Pointer to the new entry
+ *  @param[in] entry_length - Size of the new entry
+ *  @return PLDM_SUCCESS, PLDM_ERROR_INVALID_LENGTH if the new entry does not
+ *          fit in place of the old one, PLDM_ERROR_INVALID_DATA if dest_entry
+ *          is not within the table or the new entry has another handle or
+ *          type
+ */
+int pldm_bios_table_attr_value_entry_update_in_place(
+    void *table, size_t length,
+    const struct pldm_bios_attr_val_table_entry *dest_entry, const void *entry,
+    size_t entry_length);
+
 /** @brief Verify the crc value of the complete table
  *  @param[in] table - Pointer to a buffer of a bios table
  *  @param[in] size - Size of the buffer of a bios table
@@ -10,76 +10,608 @@
 #include "oem/ibm/libpldm/pdr_oem_ibm.h"
 #endif
 
-static inline uint32_t get_next_record_handle(const pldm_pdr *repo,
-					      const pldm_pdr_record *record)
+/* The record handle index is an open hash table with chaining through
+ * pldm_pdr_record.hash_next. Its size is always a power of two, and it is
+ * allocated on the first insert so that short-lived scratch repos stay cheap.
+ */
+#define PDR_HANDLE_INDEX_MIN_SIZE 64
+
+static inline uint32_t handle_index_slot(const pldm_pdr *repo,
+					 uint32_t record_handle)
+{
+	/* Fibonacci hashing spreads both the sequential BMC handles and the
+	 * sparse host handle ranges over the table */
+	return (uint32_t)(record_handle * 2654435769u) &
+	       (repo->handle_index_size - 1);
+}
+
+static void handle_index_rebuild(pldm_pdr *repo, uint32_t index_size)
+{
+	assert(repo != NULL);
+	assert(index_size != 0 && (index_size & (index_size - 1)) == 0);
+
+	pldm_pdr_record **index = calloc(index_size, sizeof(pldm_pdr_record *));
+	assert(index != NULL);
+	free(repo->handle_index);
+	repo->handle_index = index;
+	repo->handle_index_size = index_size;
+
+	/* Walk backwards so that each chain keeps list order */
+	pldm_pdr_record *record = repo->last;
+	while (record != NULL) {
+		uint32_t slot = handle_index_slot(repo, record->record_handle);
+		record->hash_next = index[slot];
+		index[slot] = record;
+		record = record->prev;
+	}
+}
+
+static void handle_index_insert(pldm_pdr *repo, pldm_pdr_record *record)
 {
 	assert(repo != NULL);
 	assert(record != NULL);
 
-	if (record == repo->last) {
+	/* Keep the load factor at or below one; the rebuild picks up the new
+	 * record since it is already linked into the list */
+	if (repo->record_count > repo->handle_index_size) {
+		uint32_t index_size = repo->handle_index_size
+					  ? repo->handle_index_size * 2
+					  : PDR_HANDLE_INDEX_MIN_SIZE;
+		handle_index_rebuild(repo, index_size);
+		return;
+	}
+
+	uint32_t slot = handle_index_slot(repo, record->record_handle);
+	record->hash_next = repo->handle_index[slot];
+	repo->handle_index[slot] = record;
+}
+
+static void handle_index_remove(pldm_pdr *repo, pldm_pdr_record *record)
+{
+	assert(repo != NULL);
+	assert(record != NULL);
+
+	if (repo->handle_index == NULL) {
+		return;
+	}
+
+	pldm_pdr_record **link =
+	    &repo->handle_index[handle_index_slot(repo, record->record_handle)];
+	while (*link != NULL) {
+		if (*link == record) {
+			*link = record->hash_next;
+			break;
+		}
+		link = &(*link)->hash_next;
+	}
+	record->hash_next = NULL;
+}
+
+static pldm_pdr_record *find_record_by_handle(const pldm_pdr *repo,
+					      uint32_t record_handle)
+{
+	assert(repo != NULL);
+
+	if (repo->handle_index == NULL) {
+		return NULL;
+	}
+
+	pldm_pdr_record *record =
+	    repo->handle_index[handle_index_slot(repo, record_handle)];
+	while (record != NULL && record->record_handle != record_handle) {
+		record = record->hash_next;
+	}
+	return record;
+}
+
+static pldm_pdr_record *find_record_by_handle_and_origin(const pldm_pdr *repo,
+							 uint32_t record_handle,
+							 bool is_remote)
+{
+	pldm_pdr_record *record = find_record_by_handle(repo, record_handle);
+	while (record != NULL && (record->record_handle != record_handle ||
+				  record->is_remote != is_remote)) {
+		record = record->hash_next;
+	}
+	return record;
+}
+
+/* Every record sits in the bucket of its PDR type, chained through
+ * type_next/type_prev in repository order
+ */
+#define PDR_TYPE_BUCKET_COUNT (UINT8_MAX + 1)
+
+static void type_bucket_insert(pldm_pdr *repo, pldm_pdr_record *record)
+{
+	assert(repo != NULL);
+	assert(record != NULL);
+
+	if (repo->type_buckets == NULL) {
+		repo->type_buckets = calloc(PDR_TYPE_BUCKET_COUNT,
+					    sizeof(pldm_pdr_type_bucket));
+		assert(repo->type_buckets != NULL);
+	}
+	pldm_pdr_type_bucket *bucket = &repo->type_buckets[record->pdr_type];
+
+	/* Appends go straight to the bucket tail. Otherwise look for the
+	 * nearest record of the same type on either side of the new one.
+	 */
+	pldm_pdr_record *type_prev = NULL;
+	if (record->next == NULL) {
+		type_prev = bucket->last;
+	} else if (bucket->record_count != 0) {
+		pldm_pdr_record *back = record->prev;
+		pldm_pdr_record *fwd = record->next;
+		while (back != NULL || fwd != NULL) {
+			if (back != NULL && back->pdr_type == record->pdr_type) {
+				type_prev = back;
+				break;
+			}
+			if (fwd != NULL && fwd->pdr_type == record->pdr_type) {
+				type_prev = fwd->type_prev;
+				break;
+			}
+			back = back != NULL ? back->prev : NULL;
+			fwd = fwd != NULL ? fwd->next : NULL;
+		}
+	}
+
+	record->type_prev = type_prev;
+	record->type_next = type_prev != NULL ? type_prev->type_next
+					      : bucket->first;
+	if (record->type_next != NULL) {
+		record->type_next->type_prev = record;
+	} else {
+		bucket->last = record;
+	}
+	if (type_prev != NULL) {
+		type_prev->type_next = record;
+	} else {
+		bucket->first = record;
+	}
+	++bucket->record_count;
+}
+
+static pldm_pdr_record *type_bucket_first(const pldm_pdr *repo,
+					  uint8_t pdr_type)
+{
+	assert(repo != NULL);
+
+	if (repo->type_buckets == NULL) {
+		return NULL;
+	}
+	return repo->type_buckets[pdr_type].first;
+}
+
+static void type_bucket_remove(pldm_pdr *repo, pldm_pdr_record *record)
+{
+	assert(repo != NULL);
+	assert(record != NULL);
+	assert(repo->type_buckets != NULL);
+
+	pldm_pdr_type_bucket *bucket = &repo->type_buckets[record->pdr_type];
+	if (record->type_prev != NULL) {
+		record->type_prev->type_next = record->type_next;
+	} else {
+		bucket->first = record->type_next;
+	}
+	if (record->type_next != NULL) {
+		record->type_next->type_prev = record->type_prev;
+	} else {
+		bucket->last = record->type_prev;
+	}
+	record->type_next = NULL;
+	record->type_prev = NULL;
+	--bucket->record_count;
+}
+
+/* Sensor and effecter PDRs are also indexed by (kind, is_remote, id). The
+ * key is computed once when the record is linked, and a key of 0 means the
+ * record is not in the id index.
+ */
+enum pdr_id_kind {
+	PDR_ID_KIND_SENSOR = 1,
+	PDR_ID_KIND_EFFECTER = 2,
+};
+
+static inline uint32_t make_id_key(enum pdr_id_kind kind, bool is_remote,
+				   uint16_t id)
+{
+	return ((uint32_t)kind << 17) | ((uint32_t)is_remote << 16) | id;
+}
+
+static uint32_t record_id_key(const pldm_pdr_record *record)
+{
+	/* Sensor and effecter PDRs all carry their id right after the
+	 * terminus handle */
+	if (record->data == NULL ||
+	    record->size < offsetof(struct pldm_state_sensor_pdr, sensor_id) +
+			       sizeof(uint16_t)) {
 		return 0;
 	}
-	return record->next->record_handle;
+
+	enum pdr_id_kind kind;
+	switch (record->pdr_type) {
+	case PLDM_STATE_SENSOR_PDR:
+		kind = PDR_ID_KIND_SENSOR;
+		break;
+	case PLDM_STATE_EFFECTER_PDR:
+	case PLDM_NUMERIC_EFFECTER_PDR:
+		kind = PDR_ID_KIND_EFFECTER;
+		break;
+	default:
+		return 0;
+	}
+
+	const struct pldm_state_sensor_pdr *pdr =
+	    (const struct pldm_state_sensor_pdr *)record->data;
+	return make_id_key(kind, record->is_remote, le16toh(pdr->sensor_id));
 }
 
-static void add_record(pldm_pdr *repo, pldm_pdr_record *record)
+static inline uint32_t id_index_slot(const pldm_pdr *repo, uint32_t id_key)
+{
+	return (uint32_t)(id_key * 2654435769u) & (repo->id_index_size - 1);
+}
+
+static void id_index_rebuild(pldm_pdr *repo, uint32_t index_size)
+{
+	assert(repo != NULL);
+	assert(index_size != 0 && (index_size & (index_size - 1)) == 0);
+
+	pldm_pdr_record **index = calloc(index_size, sizeof(pldm_pdr_record *));
+	assert(index != NULL);
+	free(repo->id_index);
+	repo->id_index = index;
+	repo->id_index_size = index_size;
+
+	pldm_pdr_record *record = repo->last;
+	while (record != NULL) {
+		if (record->id_key != 0) {
+			uint32_t slot = id_index_slot(repo, record->id_key);
+			record->id_next = index[slot];
+			index[slot] = record;
+		}
+		record = record->prev;
+	}
+}
+
+static void id_index_insert(pldm_pdr *repo, pldm_pdr_record *record)
 {
 	assert(repo != NULL);
 	assert(record != NULL);
 
-	if (repo->first == NULL) {
-		assert(repo->last == NULL);
-		repo->first = record;
-		repo->last = record;
+	record->id_key = record_id_key(record);
+	record->id_next = NULL;
+	if (record->id_key == 0) {
+		return;
+	}
+
+	++repo->id_index_count;
+	if (repo->id_index_count > repo->id_index_size) {
+		uint32_t index_size = repo->id_index_size
+					  ? repo->id_index_size * 2
+					  : PDR_HANDLE_INDEX_MIN_SIZE;
+		id_index_rebuild(repo, index_size);
+		return;
+	}
+
+	/* Append, so that records sharing an id stay in insertion order */
+	pldm_pdr_record **link =
+	    &repo->id_index[id_index_slot(repo, record->id_key)];
+	while (*link != NULL) {
+		link = &(*link)->id_next;
+	}
+	*link = record;
+}
+
+static void id_index_remove(pldm_pdr *repo, pldm_pdr_record *record)
+{
+	assert(repo != NULL);
+	assert(record != NULL);
+
+	if (record->id_key == 0) {
+		return;
+	}
+
+	pldm_pdr_record **link =
+	    &repo->id_index[id_index_slot(repo, record->id_key)];
+	while (*link != NULL) {
+		if (*link == record) {
+			*link = record->id_next;
+			--repo->id_index_count;
+			break;
+		}
+		link = &(*link)->id_next;
+	}
+	record->id_next = NULL;
+	record->id_key = 0;
+}
+
+#define PDR_TYPE_ANY 0
+
+static pldm_pdr_record *find_record_by_id(const pldm_pdr *repo,
+					  enum pdr_id_kind kind,
+					  uint8_t pdr_type, bool is_remote,
+					  uint16_t id)
+{
+	assert(repo != NULL);
+
+	if (repo->id_index == NULL) {
+		return NULL;
+	}
+
+	uint32_t id_key = make_id_key(kind, is_remote, id);
+	pldm_pdr_record *record = repo->id_index[id_index_slot(repo, id_key)];
+	while (record != NULL &&
+	       (record->id_key != id_key ||
+		(pdr_type != PDR_TYPE_ANY && record->pdr_type != pdr_type))) {
+		record = record->id_next;
+	}
+	return record;
+}
+
+/* Return whichever of two distinct records comes first in the repo. Both are
+ * walked forward in step, so the cost is bounded by their distance rather
+ * than by the repo size.
+ */
+static pldm_pdr_record *first_in_repo(pldm_pdr_record *a, pldm_pdr_record *b)
+{
+	pldm_pdr_record *from_a = a;
+	pldm_pdr_record *from_b = b;
+	while (from_a != NULL && from_b != NULL) {
+		from_a = from_a->next;
+		from_b = from_b->next;
+		if (from_a == b) {
+			return a;
+		}
+		if (from_b == a) {
+			return b;
+		}
+	}
+	return from_a == NULL ? b : a;
+}
+
+/* Lookups that do not say which side owns the id match the first record in
+ * repo order, whether it is local or remote
+ */
+static pldm_pdr_record *find_record_by_id_any_origin(const pldm_pdr *repo,
+						     enum pdr_id_kind kind,
+						     uint8_t pdr_type,
+						     uint16_t id)
+{
+	pldm_pdr_record *local =
+	    find_record_by_id(repo, kind, pdr_type, false, id);
+	pldm_pdr_record *remote =
+	    find_record_by_id(repo, kind, pdr_type, true, id);
+	if (local == NULL) {
+		return remote;
+	}
+	if (remote == NULL) {
+		return local;
+	}
+	return first_in_repo(local, remote);
+}
+
+/* Link a record into the repo after prev, or at the head if prev is NULL */
+static void link_record_after(pldm_pdr *repo, pldm_pdr_record *prev,
+			      pldm_pdr_record *record)
+{
+	assert(repo != NULL);
+	assert(record != NULL);
+
+	record->prev = prev;
+	record->next = prev != NULL ? prev->next : repo->first;
+	if (record->next != NULL) {
+		record->next->prev = record;
 	} else {
-		repo->last->next = record;
 		repo->last = record;
 	}
+	if (prev != NULL) {
+		prev->next = record;
+	} else {
+		repo->first = record;
+	}
 	repo->size += record->size;
 	++repo->record_count;
+	handle_index_insert(repo, record);
+
+	record->pdr_type = record->data != NULL
+			       ? ((struct pldm_pdr_hdr *)record->data)->type
+			       : 0;
+	type_bucket_insert(repo, record);
+	id_index_insert(repo, record);
 }
 
-static void add_hotplug_record(pldm_pdr *repo, pldm_pdr_record *record,
-			       uint32_t prev_record_handle)
+static void unlink_record(pldm_pdr *repo, pldm_pdr_record *record)
 {
-	// the new record
-	// needs to be added after prev_record_handle
 	assert(repo != NULL);
 	assert(record != NULL);
-	record->next = NULL;
-	bool recordAdded = false;
-	if (repo->first == NULL) {
-		assert(repo->last == NULL);
-		repo->first = record;
-		repo->last = record;
-		recordAdded = true;
+
+	handle_index_remove(repo, record);
+	type_bucket_remove(repo, record);
+	id_index_remove(repo, record);
+	if (record->prev != NULL) {
+		record->prev->next = record->next;
 	} else {
-		pldm_pdr_record *curr = repo->first;
-		while (curr != NULL) {
-			if (curr->record_handle == prev_record_handle) {
-				record->next = curr->next;
-				curr->next = record;
-				if (record->next == NULL) {
-					repo->last->next = record;
-					repo->last = record;
-				}
-				recordAdded = true;
-				break;
+		repo->first = record->next;
+	}
+	if (record->next != NULL) {
+		record->next->prev = record->prev;
+	} else {
+		repo->last = record->prev;
+	}
+	record->next = NULL;
+	record->prev = NULL;
+	repo->size -= record->size;
+	--repo->record_count;
+}
+
+/* In arena mode, records and their data are carved out of chunks which are
+ * kept per (is_remote, terminus_handle) origin, see pldm_pdr_init_arena()
+ */
+#define PDR_ARENA_DEFAULT_CHUNK_SIZE (16 * 1024)
+#define PDR_ARENA_ALIGN(size) (((size) + 7) & ~(size_t)7)
+#define PDR_ARENA_CHUNK_HDR_SIZE PDR_ARENA_ALIGN(sizeof(pldm_pdr_arena_chunk))
+#define PDR_ARENA_RECORD_SIZE PDR_ARENA_ALIGN(sizeof(pldm_pdr_record))
+
+static pldm_pdr_arena_chunk *arena_chunk_new(size_t capacity, bool is_remote,
+					     uint16_t terminus_handle)
+{
+	pldm_pdr_arena_chunk *chunk =
+	    malloc(PDR_ARENA_CHUNK_HDR_SIZE + capacity);
+	assert(chunk != NULL);
+	chunk->next = NULL;
+	chunk->capacity = capacity;
+	chunk->used = 0;
+	chunk->live_records = 0;
+	chunk->is_remote = is_remote;
+	chunk->terminus_handle = terminus_handle;
+	chunk->free_slots = NULL;
+
+	return chunk;
+}
+
+static pldm_pdr_record *arena_alloc_record(pldm_pdr *repo, uint32_t size,
+					   bool has_data, bool is_remote,
+					   uint16_t terminus_handle)
+{
+	assert(repo != NULL);
+	assert(repo->arena_chunk_size != 0);
+
+	size_t need = PDR_ARENA_RECORD_SIZE;
+	if (has_data) {
+		need += PDR_ARENA_ALIGN((size_t)size);
+	}
+
+	/* Chunks are pushed at the front, so the first chunk of an origin is
+	 * the one being filled. Freed slots of the origin go first, picking
+	 * the smallest one the record fits in. */
+	pldm_pdr_arena_chunk *open = NULL;
+	pldm_pdr_arena_chunk *chunk = NULL;
+	pldm_pdr_arena_slot **best = NULL;
+	for (pldm_pdr_arena_chunk *it = repo->arena; it != NULL;
+	     it = it->next) {
+		if (it->is_remote != is_remote ||
+		    it->terminus_handle != terminus_handle) {
+			continue;
+		}
+		if (open == NULL) {
+			open = it;
+		}
+		for (pldm_pdr_arena_slot **link = &it->free_slots;
+		     *link != NULL; link = &(*link)->next) {
+			if ((*link)->size >= need &&
+			    (best == NULL || (*link)->size < (*best)->size)) {
+				best = link;
+				chunk = it;
 			}
-			curr = curr->next;
 		}
-		// printf("\nadding the fru hotplug here
-		// curr->record_handle=%d",curr->record_handle);
-		// printf("repo-last=%x, curr=%x, curr-next=%x",(unsigned
-		// int)repo->last, (unsigned int)curr, (unsigned
-		// int)curr->next);
 	}
-	if (recordAdded == false) {
+
+	pldm_pdr_record *record = NULL;
+	size_t slot_size = need;
+	if (best != NULL) {
+		pldm_pdr_arena_slot *slot = *best;
+		*best = slot->next;
+		slot_size = slot->size;
+		record = (pldm_pdr_record *)slot;
+	} else {
+		chunk = open;
+		if (need > repo->arena_chunk_size) {
+			/* Oversized records get a chunk of their own, queued
+			 * behind the open chunk so that it stays open */
+			chunk =
+			    arena_chunk_new(need, is_remote, terminus_handle);
+			pldm_pdr_arena_chunk **link =
+			    open != NULL ? &open->next : &repo->arena;
+			chunk->next = *link;
+			*link = chunk;
+		} else if (chunk == NULL ||
+			   chunk->capacity - chunk->used < need) {
+			chunk = arena_chunk_new(repo->arena_chunk_size,
+						is_remote, terminus_handle);
+			chunk->next = repo->arena;
+			repo->arena = chunk;
+		}
+		uint8_t *start = (uint8_t *)chunk + PDR_ARENA_CHUNK_HDR_SIZE;
+		record = (pldm_pdr_record *)(start + chunk->used);
+		chunk->used += need;
+	}
+
+	record->chunk = chunk;
+	record->slot_size = slot_size;
+	record->data = has_data ? (uint8_t *)record + PDR_ARENA_RECORD_SIZE
+				: NULL;
+	++chunk->live_records;
+
+	return record;
+}
+
+static void free_record(pldm_pdr *repo, pldm_pdr_record *record)
+{
+	assert(repo != NULL);
+	assert(record != NULL);
+
+	pldm_pdr_arena_chunk *chunk = record->chunk;
+	if (chunk == NULL) {
+		free(record->data);
 		free(record);
-		assert(recordAdded != false);
+		return;
 	}
-	repo->size += record->size;
-	++repo->record_count;
+
+	assert(chunk->live_records != 0);
+	if (--chunk->live_records == 0) {
+		pldm_pdr_arena_chunk **link = &repo->arena;
+		while (*link != chunk) {
+			link = &(*link)->next;
+		}
+		*link = chunk->next;
+		free(chunk);
+		return;
+	}
+
+	/* The last slot of the chunk goes back to the unused tail, any other
+	 * one on the free list */
+	size_t slot_size = record->slot_size;
+	uint8_t *start = (uint8_t *)chunk + PDR_ARENA_CHUNK_HDR_SIZE;
+	if ((uint8_t *)record + slot_size == start + chunk->used) {
+		chunk->used -= slot_size;
+		return;
+	}
+	pldm_pdr_arena_slot *slot = (pldm_pdr_arena_slot *)record;
+	slot->size = slot_size;
+	slot->next = chunk->free_slots;
+	chunk->free_slots = slot;
+}
+
+/* Put new_record in the position held by record and free record */
+static void replace_record(pldm_pdr *repo, pldm_pdr_record *record,
+			   pldm_pdr_record *new_record)
+{
+	pldm_pdr_record *prev = record->prev;
+	unlink_record(repo, record);
+	link_record_after(repo, prev, new_record);
+	free_record(repo, record);
+}
+
+static inline uint32_t get_next_record_handle(const pldm_pdr *repo,
+					      const pldm_pdr_record *record)
+{
+	assert(repo != NULL);
+	assert(record != NULL);
+
+	if (record == repo->last) {
+		return 0;
+	}
+	return record->next->record_handle;
+}
+
+static void add_record(pldm_pdr *repo, pldm_pdr_record *record)
+{
+	assert(repo != NULL);
+	assert(record != NULL);
+
+	link_record_after(repo, repo->last, record);
 }
 
 static void add_record_after_record_handle(pldm_pdr *repo,
@@ -88,33 +620,17 @@ static void add_record_after_record_handle(pldm_pdr *repo,
 {
 	assert(repo != NULL);
 	assert(record != NULL);
-	bool recordAdded = false;
+
 	if (repo->first == NULL) {
 		assert(repo->last == NULL);
-		repo->first = record;
-		repo->last = record;
-		recordAdded = true;
-	} else {
-		pldm_pdr_record *curr = repo->first;
-		while (curr != NULL) {
-			if (curr->record_handle == prev_record_handle) {
-				record->next = curr->next;
-				curr->next = record;
-				if (record->next == NULL) {
-					repo->last = record;
-				}
-				recordAdded = true;
-				break;
-			}
-			curr = curr->next;
-		}
-	}
-	if (recordAdded == false) {
-		free(record);
-		assert(recordAdded != false);
+		link_record_after(repo, NULL, record);
+		return;
 	}
-	repo->size += record->size;
-	++repo->record_count;
+
+	pldm_pdr_record *prev = find_record_by_handle(repo, prev_record_handle);
+	assert(prev != NULL);
+	/* Without asserts, keep the record rather than dropping it */
+	link_record_after(repo, prev != NULL ? prev : repo->last, record);
 }
 
 static inline uint32_t get_new_record_handle(const pldm_pdr *repo)
@@ -127,16 +643,28 @@ static inline uint32_t get_new_record_handle(const pldm_pdr *repo)
 	return last_used_hdl + 1;
 }
 
-static pldm_pdr_record *make_new_record(const pldm_pdr *repo,
-					const uint8_t *data, uint32_t size,
-					uint32_t record_handle, bool is_remote,
+static pldm_pdr_record *make_new_record(pldm_pdr *repo, const uint8_t *data,
+					uint32_t size, uint32_t record_handle,
+					bool is_remote,
 					uint16_t terminus_handle)
 {
 	assert(repo != NULL);
 	assert(size != 0);
 
-	pldm_pdr_record *record = malloc(sizeof(pldm_pdr_record));
-	assert(record != NULL);
+	pldm_pdr_record *record = NULL;
+	if (repo->arena_chunk_size != 0) {
+		record = arena_alloc_record(repo, size, data != NULL,
+					    is_remote, terminus_handle);
+	} else {
+		record = malloc(sizeof(pldm_pdr_record));
+		assert(record != NULL);
+		record->chunk = NULL;
+		record->data = NULL;
+		if (data != NULL) {
+			record->data = malloc(size);
+			assert(record->data != NULL);
+		}
+	}
 	if (record_handle == 0) {
 		record->record_handle = get_new_record_handle(repo);
 	}
@@ -153,8 +681,6 @@ static pldm_pdr_record *make_new_record(const pldm_pdr *repo,
 	record->is_remote = is_remote;
 	record->terminus_handle = terminus_handle;
 	if (data != NULL) {
-		record->data = malloc(size);
-		assert(record->data != NULL);
 		memcpy(record->data, data, size);
 		/* If record handle is 0, that is an indication for this API to
 		 * compute a new handle. For that reason, the computed handle
@@ -167,6 +693,13 @@ static pldm_pdr_record *make_new_record(const pldm_pdr *repo,
 		hdr->record_handle = htole32(record->record_handle);
 	}
 	record->next = NULL;
+	record->prev = NULL;
+	record->hash_next = NULL;
+	record->type_next = NULL;
+	record->type_prev = NULL;
+	record->id_next = NULL;
+	record->id_key = 0;
+	record->pdr_type = 0;
 
 	return record;
 }
@@ -196,7 +729,7 @@ uint32_t pldm_pdr_add_hotplug_record(pldm_pdr *repo, const uint8_t *data,
 
 	pldm_pdr_record *record = make_new_record(
 	    repo, data, size, record_handle, is_remote, terminus_handle);
-	add_hotplug_record(repo, record, prev_record_handle);
+	add_record_after_record_handle(repo, record, prev_record_handle);
 	return record->record_handle;
 }
 
@@ -224,6 +757,24 @@ pldm_pdr *pldm_pdr_init()
 	repo->size = 0;
 	repo->first = NULL;
 	repo->last = NULL;
+	repo->handle_index = NULL;
+	repo->handle_index_size = 0;
+	repo->type_buckets = NULL;
+	repo->id_index = NULL;
+	repo->id_index_size = 0;
+	repo->id_index_count = 0;
+	repo->arena = NULL;
+	repo->arena_chunk_size = 0;
+
+	return repo;
+}
+
+pldm_pdr *pldm_pdr_init_arena(size_t chunk_size)
+{
+	pldm_pdr *repo = pldm_pdr_init();
+	repo->arena_chunk_size =
+	    chunk_size ? PDR_ARENA_ALIGN(chunk_size)
+		       : PDR_ARENA_DEFAULT_CHUNK_SIZE;
 
 	return repo;
 }
@@ -235,13 +786,20 @@ void pldm_pdr_destroy(pldm_pdr *repo)
 	pldm_pdr_record *record = repo->first;
 	while (record != NULL) {
 		pldm_pdr_record *next = record->next;
-		if (record->data) {
-			free(record->data);
-			record->data = NULL;
+		if (record->chunk == NULL) {
+			free_record(repo, record);
 		}
-		free(record);
 		record = next;
 	}
+	pldm_pdr_arena_chunk *chunk = repo->arena;
+	while (chunk != NULL) {
+		pldm_pdr_arena_chunk *next = chunk->next;
+		free(chunk);
+		chunk = next;
+	}
+	free(repo->handle_index);
+	free(repo->type_buckets);
+	free(repo->id_index);
 	free(repo);
 }
 
@@ -255,19 +813,14 @@ const pldm_pdr_record *pldm_pdr_find_record(const pldm_pdr *repo,
 	assert(size != NULL);
 	assert(next_record_handle != NULL);
 
-	if (!record_handle && (repo->first != NULL)) {
-		record_handle = repo->first->record_handle;
-	}
-	pldm_pdr_record *record = repo->first;
-	while (record != NULL) {
-		if (record->record_handle == record_handle) {
-			*size = record->size;
-			*data = record->data;
-			*next_record_handle =
-			    get_next_record_handle(repo, record);
-			return record;
-		}
-		record = record->next;
+	pldm_pdr_record *record = record_handle
+				      ? find_record_by_handle(repo, record_handle)
+				      : repo->first;
+	if (record != NULL) {
+		*size = record->size;
+		*data = record->data;
+		*next_record_handle = get_next_record_handle(repo, record);
+		return record;
 	}
 
 	*size = 0;
@@ -280,17 +833,15 @@ bool pldm_pdr_find_prev_record_handle(pldm_pdr *repo, uint32_t record_handle,
 {
 
 	assert(repo != NULL);
-	pldm_pdr_record *curr = repo->first;
-	pldm_pdr_record *prev = repo->first;
-	while (curr != NULL) {
-		if (curr->record_handle == record_handle) {
-			*prev_record_handle = prev->record_handle;
-			return true;
-		}
-		prev = curr;
-		curr = curr->next;
+	pldm_pdr_record *record = find_record_by_handle(repo, record_handle);
+	if (record == NULL) {
+		return false;
 	}
-	return false;
+	/* The first record is reported as its own predecessor */
+	*prev_record_handle = record->prev != NULL
+				  ? record->prev->record_handle
+				  : record->record_handle;
+	return true;
 }
 
 const pldm_pdr_record *
@@ -317,6 +868,20 @@ pldm_pdr_get_next_record(const pldm_pdr *repo,
 	return curr_record->next;
 }
 
+static const pldm_pdr_record *
+pdr_record_out(const pldm_pdr_record *record, uint8_t **data, uint32_t *size)
+{
+	if (record != NULL) {
+		if (data && size) {
+			*size = record->size;
+			*data = record->data;
+		}
+	} else if (size) {
+		*size = 0;
+	}
+	return record;
+}
+
 const pldm_pdr_record *
 pldm_pdr_find_record_by_type(const pldm_pdr *repo, uint8_t pdr_type,
 			     const pldm_pdr_record *curr_record, uint8_t **data,
@@ -324,26 +889,61 @@ pldm_pdr_find_record_by_type(const pldm_pdr *repo, uint8_t pdr_type,
 {
 	assert(repo != NULL);
 
-	pldm_pdr_record *record = repo->first;
-	if (curr_record != NULL) {
+	const pldm_pdr_record *record = NULL;
+	if (curr_record == NULL) {
+		record = type_bucket_first(repo, pdr_type);
+	} else if (curr_record->pdr_type == pdr_type) {
+		record = curr_record->type_next;
+	} else {
 		record = curr_record->next;
-	}
-	while (record != NULL) {
-		struct pldm_pdr_hdr *hdr = (struct pldm_pdr_hdr *)record->data;
-		if (hdr->type == pdr_type) {
-			if (data && size) {
-				*size = record->size;
-				*data = record->data;
-			}
-			return record;
+		while (record != NULL && record->pdr_type != pdr_type) {
+			record = record->next;
 		}
-		record = record->next;
 	}
 
-	if (size) {
-		*size = 0;
+	return pdr_record_out(record, data, size);
+}
+
+const pldm_pdr_record *
+pldm_pdr_get_next_record_by_type(const pldm_pdr_record *curr_record,
+				 uint8_t **data, uint32_t *size)
+{
+	assert(curr_record != NULL);
+
+	return pdr_record_out(curr_record->type_next, data, size);
+}
+
+uint32_t pldm_pdr_get_record_count_by_type(const pldm_pdr *repo,
+					   uint8_t pdr_type)
+{
+	assert(repo != NULL);
+
+	if (repo->type_buckets == NULL) {
+		return 0;
 	}
-	return NULL;
+	return repo->type_buckets[pdr_type].record_count;
+}
+
+const pldm_pdr_record *
+pldm_pdr_find_record_by_sensor_id(const pldm_pdr *repo, uint16_t sensor_id,
+				  bool is_remote, uint8_t **data,
+				  uint32_t *size)
+{
+	return pdr_record_out(find_record_by_id(repo, PDR_ID_KIND_SENSOR,
+						PDR_TYPE_ANY, is_remote,
+						sensor_id),
+			      data, size);
+}
+
+const pldm_pdr_record *
+pldm_pdr_find_record_by_effecter_id(const pldm_pdr *repo, uint16_t effecter_id,
+				    bool is_remote, uint8_t **data,
+				    uint32_t *size)
+{
+	return pdr_record_out(find_record_by_id(repo, PDR_ID_KIND_EFFECTER,
+						PDR_TYPE_ANY, is_remote,
+						effecter_id),
+			      data, size);
 }
 
 uint32_t pldm_pdr_get_record_count(const pldm_pdr *repo)
@@ -458,42 +1058,22 @@ uint32_t pldm_pdr_remove_fru_record_set_by_rsi(pldm_pdr *repo, uint16_t fru_rsi,
 	assert(repo != NULL);
 
 	uint32_t delete_hdl = 0;
-	pldm_pdr_record *record = repo->first;
-	pldm_pdr_record *prev = NULL;
+	pldm_pdr_record *record =
+	    type_bucket_first(repo, PLDM_PDR_FRU_RECORD_SET);
 	while (record != NULL) {
-		pldm_pdr_record *next = record->next;
+		pldm_pdr_record *next = record->type_next;
 		struct pldm_pdr_hdr *hdr = (struct pldm_pdr_hdr *)record->data;
-		if ((record->is_remote == is_remote) &&
-		    hdr->type == PLDM_PDR_FRU_RECORD_SET) {
+		if (record->is_remote == is_remote) {
 			struct pldm_pdr_fru_record_set *fru =
 			    (struct pldm_pdr_fru_record_set
 				 *)((uint8_t *)record->data +
 				    sizeof(struct pldm_pdr_hdr));
 			if (fru->fru_rsi == fru_rsi) {
 				delete_hdl = hdr->record_handle;
-				if (repo->first == record) {
-					repo->first = next;
-				} else {
-					prev->next = next;
-				}
-				if (repo->last == record) {
-					repo->last = prev;
-					if (prev != NULL) {
-						prev->next = NULL; // sm00
-					}
-				}
-				--repo->record_count;
-				repo->size -= record->size;
-				if (record->data) {
-					free(record->data);
-				}
-				free(record);
+				unlink_record(repo, record);
+				free_record(repo, record);
 				break;
-			} else {
-				prev = record;
 			}
-		} else {
-			prev = record;
 		}
 		record = next;
 	}
@@ -532,32 +1112,11 @@ void pldm_delete_by_record_handle(pldm_pdr *repo, uint32_t record_handle,
 {
 	assert(repo != NULL);
 
-	pldm_pdr_record *record = repo->first;
-	pldm_pdr_record *prev = NULL;
-	while (record != NULL) {
-		pldm_pdr_record *next = record->next;
-		struct pldm_pdr_hdr *hdr = (struct pldm_pdr_hdr *)record->data;
-		if ((record->is_remote == is_remote) &&
-		    (hdr->record_handle == record_handle)) {
-			if (repo->first == record) {
-				repo->first = next;
-			} else {
-				prev->next = next;
-			}
-			if (repo->last == record) {
-				repo->last = prev;
-			}
-			if (record->data) {
-				free(record->data);
-			}
-			--repo->record_count;
-			repo->size -= record->size;
-			free(record);
-			break;
-		} else {
-			prev = record;
-		}
-		record = next;
+	pldm_pdr_record *record =
+	    find_record_by_handle_and_origin(repo, record_handle, is_remote);
+	if (record != NULL) {
+		unlink_record(repo, record);
+		free_record(repo, record);
 	}
 }
 
@@ -567,11 +1126,11 @@ pldm_entity pldm_get_entity_from_record_handle(const pldm_pdr *repo,
 	assert(repo != NULL);
 	pldm_entity element = {0, 0, 0};
 
-	pldm_pdr_record *record = repo->first;
+	pldm_pdr_record *record = find_record_by_handle(repo, record_handle);
 
 	while (record != NULL) {
 		struct pldm_pdr_hdr *hdr = (struct pldm_pdr_hdr *)record->data;
-		if (hdr->record_handle == record_handle) {
+		if (record->record_handle == record_handle) {
 			switch (hdr->type) {
 			case (PLDM_PDR_FRU_RECORD_SET): {
 				struct pldm_pdr_fru_record_set *pdr =
@@ -618,38 +1177,33 @@ pldm_entity pldm_get_entity_from_record_handle(const pldm_pdr *repo,
 				break;
 			}
 		}
-		record = record->next;
+		record = record->hash_next;
 	}
-	return element;
-}
-
-uint16_t pldm_find_container_id(const pldm_pdr *repo, uint16_t entityType,
-				uint16_t entityInstance)
-{
-	assert(repo != NULL);
-
-	pldm_pdr_record *record = repo->first;
-
-	while (record != NULL) {
-		struct pldm_pdr_hdr *hdr = (struct pldm_pdr_hdr *)record->data;
-		if (hdr->type == PLDM_PDR_ENTITY_ASSOCIATION) {
-			struct pldm_pdr_entity_association *pdr =
-			    (struct pldm_pdr_entity_association
-				 *)((uint8_t *)record->data +
-				    sizeof(struct pldm_pdr_hdr));
-			struct pldm_entity *child =
-			    (struct pldm_entity *)(&pdr->children[0]);
-			for (int i = 0; i < pdr->num_children; ++i) {
-				if (pdr->container.entity_type == entityType &&
-				    pdr->container.entity_instance_num ==
-					entityInstance) {
-					uint16_t id =
-					    child->entity_container_id;
-					return id;
-				}
-			}
+	return element;
+}
+
+uint16_t pldm_find_container_id(const pldm_pdr *repo, uint16_t entityType,
+				uint16_t entityInstance)
+{
+	assert(repo != NULL);
+
+	pldm_pdr_record *record =
+	    type_bucket_first(repo, PLDM_PDR_ENTITY_ASSOCIATION);
+
+	while (record != NULL) {
+		struct pldm_pdr_entity_association *pdr =
+		    (struct pldm_pdr_entity_association
+			 *)((uint8_t *)record->data +
+			    sizeof(struct pldm_pdr_hdr));
+		struct pldm_entity *child =
+		    (struct pldm_entity *)(&pdr->children[0]);
+		if (pdr->num_children &&
+		    pdr->container.entity_type == entityType &&
+		    pdr->container.entity_instance_num == entityInstance) {
+			uint16_t id = child->entity_container_id;
+			return id;
 		}
-		record = record->next;
+		record = record->type_next;
 	}
 	return 0;
 }
@@ -660,28 +1214,21 @@ void pldm_change_container_id_of_effecter(const pldm_pdr *repo,
 {
 	assert(repo != NULL);
 
-	pldm_pdr_record *record = repo->first;
+	pldm_pdr_record *record = find_record_by_id_any_origin(
+	    repo, PDR_ID_KIND_EFFECTER, PDR_TYPE_ANY, effecterId);
+	if (record == NULL) {
+		return;
+	}
 
-	while (record != NULL) {
-		struct pldm_pdr_hdr *hdr = (struct pldm_pdr_hdr *)record->data;
-		if (hdr->type == PLDM_NUMERIC_EFFECTER_PDR) {
-			struct pldm_numeric_effecter_value_pdr *pdr =
-			    (struct pldm_numeric_effecter_value_pdr
-				 *)((uint8_t *)record->data);
-			if (pdr->effecter_id == effecterId) {
-				pdr->container_id = containerId;
-				break;
-			}
-		} else if (hdr->type == PLDM_STATE_EFFECTER_PDR) {
-			struct pldm_state_effecter_pdr *pdr =
-			    (struct pldm_state_effecter_pdr *)((uint8_t *)record
-								   ->data);
-			if (pdr->effecter_id == effecterId) {
-				pdr->container_id = containerId;
-				break;
-			}
-		}
-		record = record->next;
+	if (record->pdr_type == PLDM_NUMERIC_EFFECTER_PDR) {
+		struct pldm_numeric_effecter_value_pdr *pdr =
+		    (struct pldm_numeric_effecter_value_pdr *)((uint8_t *)
+								   record->data);
+		pdr->container_id = containerId;
+	} else {
+		struct pldm_state_effecter_pdr *pdr =
+		    (struct pldm_state_effecter_pdr *)((uint8_t *)record->data);
+		pdr->container_id = containerId;
 	}
 }
 
@@ -690,20 +1237,12 @@ void pldm_change_container_id_of_sensor(const pldm_pdr *repo, uint16_t sensorId,
 {
 	assert(repo != NULL);
 
-	pldm_pdr_record *record = repo->first;
-
-	while (record != NULL) {
-		struct pldm_pdr_hdr *hdr = (struct pldm_pdr_hdr *)record->data;
-		if (hdr->type == PLDM_STATE_SENSOR_PDR) {
-			struct pldm_state_sensor_pdr *pdr =
-			    (struct pldm_state_sensor_pdr *)((uint8_t *)
-								 record->data);
-			if (pdr->sensor_id == sensorId) {
-				pdr->container_id = containerId;
-				break;
-			}
-		}
-		record = record->next;
+	pldm_pdr_record *record = find_record_by_id_any_origin(
+	    repo, PDR_ID_KIND_SENSOR, PLDM_STATE_SENSOR_PDR, sensorId);
+	if (record != NULL) {
+		struct pldm_state_sensor_pdr *pdr =
+		    (struct pldm_state_sensor_pdr *)((uint8_t *)record->data);
+		pdr->container_id = containerId;
 	}
 }
 
@@ -713,20 +1252,12 @@ void pldm_change_instance_number_of_effecter(const pldm_pdr *repo,
 {
 	assert(repo != NULL);
 
-	pldm_pdr_record *record = repo->first;
-
-	while (record != NULL) {
-		struct pldm_pdr_hdr *hdr = (struct pldm_pdr_hdr *)record->data;
-		if (hdr->type == PLDM_STATE_EFFECTER_PDR) {
-			struct pldm_state_effecter_pdr *pdr =
-			    (struct pldm_state_effecter_pdr *)((uint8_t *)record
-								   ->data);
-			if (pdr->effecter_id == effecterId) {
-				pdr->entity_instance = instanceNumber;
-				break;
-			}
-		}
-		record = record->next;
+	pldm_pdr_record *record = find_record_by_id_any_origin(
+	    repo, PDR_ID_KIND_EFFECTER, PLDM_STATE_EFFECTER_PDR, effecterId);
+	if (record != NULL) {
+		struct pldm_state_effecter_pdr *pdr =
+		    (struct pldm_state_effecter_pdr *)((uint8_t *)record->data);
+		pdr->entity_instance = instanceNumber;
 	}
 }
 
@@ -736,20 +1267,12 @@ void pldm_change_instance_number_of_sensor(const pldm_pdr *repo,
 {
 	assert(repo != NULL);
 
-	pldm_pdr_record *record = repo->first;
-
-	while (record != NULL) {
-		struct pldm_pdr_hdr *hdr = (struct pldm_pdr_hdr *)record->data;
-		if (hdr->type == PLDM_STATE_SENSOR_PDR) {
-			struct pldm_state_sensor_pdr *pdr =
-			    (struct pldm_state_sensor_pdr *)((uint8_t *)
-								 record->data);
-			if (pdr->sensor_id == sensorId) {
-				pdr->entity_instance = instanceNumber;
-				break;
-			}
-		}
-		record = record->next;
+	pldm_pdr_record *record = find_record_by_id_any_origin(
+	    repo, PDR_ID_KIND_SENSOR, PLDM_STATE_SENSOR_PDR, sensorId);
+	if (record != NULL) {
+		struct pldm_state_sensor_pdr *pdr =
+		    (struct pldm_state_sensor_pdr *)((uint8_t *)record->data);
+		pdr->entity_instance = instanceNumber;
 	}
 }
 
@@ -759,43 +1282,14 @@ uint16_t pldm_delete_by_effecter_id(pldm_pdr *repo, uint16_t effecter_id,
 	assert(repo != NULL);
 
 	uint32_t delete_handle = 0;
-	pldm_pdr_record *record = repo->first;
-	pldm_pdr_record *prev = NULL;
-	while (record != NULL) {
-		pldm_pdr_record *next = record->next;
+	pldm_pdr_record *record =
+	    find_record_by_id(repo, PDR_ID_KIND_EFFECTER,
+			      PLDM_STATE_EFFECTER_PDR, is_remote, effecter_id);
+	if (record != NULL) {
 		struct pldm_pdr_hdr *hdr = (struct pldm_pdr_hdr *)record->data;
-		if ((record->is_remote == is_remote) &&
-		    hdr->type == PLDM_STATE_EFFECTER_PDR) {
-			struct pldm_state_effecter_pdr *pdr =
-			    (struct pldm_state_effecter_pdr *)((uint8_t *)record
-								   ->data);
-			if (pdr->effecter_id == effecter_id) {
-				delete_handle = hdr->record_handle;
-				if (repo->first == record) {
-					repo->first = next;
-				} else {
-					prev->next = next;
-				}
-				if (repo->last == record) {
-					repo->last = prev;
-					if (prev != NULL) {
-						prev->next = NULL;
-					}
-				}
-				--repo->record_count;
-				repo->size -= record->size;
-				if (record->data) {
-					free(record->data);
-				}
-				free(record);
-				break;
-			} else {
-				prev = record;
-			}
-		} else {
-			prev = record;
-		}
-		record = next;
+		delete_handle = hdr->record_handle;
+		unlink_record(repo, record);
+		free_record(repo, record);
 	}
 	return delete_handle;
 }
@@ -806,43 +1300,14 @@ uint16_t pldm_delete_by_sensor_id(pldm_pdr *repo, uint16_t sensor_id,
 	assert(repo != NULL);
 
 	uint32_t delete_handle = 0;
-	pldm_pdr_record *record = repo->first;
-	pldm_pdr_record *prev = NULL;
-	while (record != NULL) {
-		pldm_pdr_record *next = record->next;
+	pldm_pdr_record *record =
+	    find_record_by_id(repo, PDR_ID_KIND_SENSOR, PLDM_STATE_SENSOR_PDR,
+			      is_remote, sensor_id);
+	if (record != NULL) {
 		struct pldm_pdr_hdr *hdr = (struct pldm_pdr_hdr *)record->data;
-		if ((record->is_remote == is_remote) &&
-		    hdr->type == PLDM_STATE_SENSOR_PDR) {
-			struct pldm_state_sensor_pdr *pdr =
-			    (struct pldm_state_sensor_pdr *)((uint8_t *)
-								 record->data);
-			if (pdr->sensor_id == sensor_id) {
-				delete_handle = hdr->record_handle;
-				if (repo->first == record) {
-					repo->first = next;
-				} else {
-					prev->next = next;
-				}
-				if (repo->last == record) {
-					repo->last = prev;
-					if (prev != NULL) {
-						prev->next = NULL;
-					}
-				}
-				--repo->record_count;
-				repo->size -= record->size;
-				if (record->data) {
-					free(record->data);
-				}
-				free(record);
-				break;
-			} else {
-				prev = record;
-			}
-		} else {
-			prev = record;
-		}
-		record = next;
+		delete_handle = hdr->record_handle;
+		unlink_record(repo, record);
+		free_record(repo, record);
 	}
 	return delete_handle;
 }
@@ -850,6 +1315,10 @@ uint16_t pldm_delete_by_sensor_id(pldm_pdr *repo, uint16_t sensor_id,
 typedef struct pldm_entity_association_tree {
 	pldm_entity_node *root;
 	uint16_t last_used_container_id;
+	pldm_entity_node **entity_index;
+	pldm_entity_node **host_index;
+	uint32_t index_size;
+	uint32_t node_count;
 } pldm_entity_association_tree;
 
 typedef struct pldm_entity_node {
@@ -859,8 +1328,216 @@ typedef struct pldm_entity_node {
 	pldm_entity_node *first_child;
 	pldm_entity_node *next_sibling;
 	uint8_t association_type;
+	pldm_entity_node *entity_next;
+	pldm_entity_node *host_next;
 } pldm_entity_node;
 
+/* Every node of a tree sits in two hash tables sized to the node count: the
+ * entity index, keyed on entity type and instance number, and the host index,
+ * keyed on entity type, instance number and host container id. The entity
+ * index leaves the container id out of its key so that the same chains serve
+ * the lookups that do not know it. Chains keep insertion order, so the first
+ * node added wins when several match.
+ */
+#define ENTITY_INDEX_MIN_SIZE 64
+
+static inline uint32_t
+entity_index_slot(const pldm_entity_association_tree *tree,
+		  uint16_t entity_type, uint16_t entity_instance_num,
+		  uint16_t container_id)
+{
+	uint64_t key = ((uint64_t)entity_type << 32) |
+		       ((uint64_t)entity_instance_num << 16) | container_id;
+	return (uint32_t)((key * 0x9e3779b97f4a7c15ull) >> 32) &
+	       (tree->index_size - 1);
+}
+
+static inline uint32_t entity_slot(const pldm_entity_association_tree *tree,
+				   const pldm_entity_node *node)
+{
+	return entity_index_slot(tree, node->entity.entity_type,
+				 node->entity.entity_instance_num, 0);
+}
+
+static inline uint32_t host_slot(const pldm_entity_association_tree *tree,
+				 const pldm_entity_node *node)
+{
+	return entity_index_slot(tree, node->entity.entity_type,
+				 node->entity.entity_instance_num,
+				 node->host_container_id);
+}
+
+static void entity_index_append(pldm_entity_node **index, uint32_t slot,
+				pldm_entity_node *node)
+{
+	pldm_entity_node **link = &index[slot];
+	while (*link != NULL) {
+		link = &(*link)->entity_next;
+	}
+	node->entity_next = NULL;
+	*link = node;
+}
+
+static void host_index_append(pldm_entity_node **index, uint32_t slot,
+			      pldm_entity_node *node)
+{
+	pldm_entity_node **link = &index[slot];
+	while (*link != NULL) {
+		link = &(*link)->host_next;
+	}
+	node->host_next = NULL;
+	*link = node;
+}
+
+static void entity_index_rebuild(pldm_entity_association_tree *tree,
+				 uint32_t index_size)
+{
+	assert(tree != NULL);
+	assert(index_size != 0 && (index_size & (index_size - 1)) == 0);
+
+	pldm_entity_node **entity_index =
+	    calloc(index_size, sizeof(pldm_entity_node *));
+	pldm_entity_node **host_index =
+	    calloc(index_size, sizeof(pldm_entity_node *));
+	assert(entity_index != NULL);
+	assert(host_index != NULL);
+
+	pldm_entity_node **old_entity_index = tree->entity_index;
+	pldm_entity_node **old_host_index = tree->host_index;
+	uint32_t old_size = tree->index_size;
+	tree->entity_index = entity_index;
+	tree->host_index = host_index;
+	tree->index_size = index_size;
+
+	/* Moving the old chains front to back keeps nodes sharing a key in
+	 * insertion order */
+	for (uint32_t i = 0; i < old_size; ++i) {
+		pldm_entity_node *node = old_entity_index[i];
+		while (node != NULL) {
+			pldm_entity_node *next = node->entity_next;
+			entity_index_append(entity_index,
+					    entity_slot(tree, node), node);
+			node = next;
+		}
+		node = old_host_index[i];
+		while (node != NULL) {
+			pldm_entity_node *next = node->host_next;
+			host_index_append(host_index, host_slot(tree, node),
+					  node);
+			node = next;
+		}
+	}
+	free(old_entity_index);
+	free(old_host_index);
+}
+
+static void entity_index_insert(pldm_entity_association_tree *tree,
+				pldm_entity_node *node)
+{
+	assert(tree != NULL);
+	assert(node != NULL);
+
+	++tree->node_count;
+	if (tree->node_count > tree->index_size) {
+		entity_index_rebuild(tree, tree->index_size
+					       ? tree->index_size * 2
+					       : ENTITY_INDEX_MIN_SIZE);
+	}
+	entity_index_append(tree->entity_index, entity_slot(tree, node), node);
+	host_index_append(tree->host_index, host_slot(tree, node), node);
+}
+
+static void entity_index_remove(pldm_entity_association_tree *tree,
+				pldm_entity_node *node)
+{
+	assert(tree != NULL);
+	assert(node != NULL);
+
+	pldm_entity_node **link = &tree->entity_index[entity_slot(tree, node)];
+	while (*link != NULL && *link != node) {
+		link = &(*link)->entity_next;
+	}
+	if (*link != NULL) {
+		*link = node->entity_next;
+	}
+
+	link = &tree->host_index[host_slot(tree, node)];
+	while (*link != NULL && *link != node) {
+		link = &(*link)->host_next;
+	}
+	if (*link != NULL) {
+		*link = node->host_next;
+	}
+
+	node->entity_next = NULL;
+	node->host_next = NULL;
+	--tree->node_count;
+}
+
+static void entity_index_clear(pldm_entity_association_tree *tree)
+{
+	free(tree->entity_index);
+	free(tree->host_index);
+	tree->entity_index = NULL;
+	tree->host_index = NULL;
+	tree->index_size = 0;
+	tree->node_count = 0;
+}
+
+/* Iterative walk over a node, its next siblings and all of their descendants,
+ * in the order the tree has always been visited in: a node, then the subtrees
+ * of its next siblings, then its own children. A node's links are read before
+ * it is handed out, so the caller may free it.
+ */
+struct entity_walk {
+	pldm_entity_node **stack;
+	size_t depth;
+	size_t capacity;
+};
+
+static void entity_walk_push(struct entity_walk *walk, pldm_entity_node *node)
+{
+	if (node == NULL) {
+		return;
+	}
+	if (walk->depth == walk->capacity) {
+		walk->capacity = walk->capacity ? walk->capacity * 2 : 32;
+		walk->stack =
+		    realloc(walk->stack,
+			    walk->capacity * sizeof(pldm_entity_node *));
+		assert(walk->stack != NULL);
+	}
+	walk->stack[walk->depth++] = node;
+}
+
+static void entity_walk_init(struct entity_walk *walk, pldm_entity_node *start)
+{
+	walk->stack = NULL;
+	walk->depth = 0;
+	walk->capacity = 0;
+	entity_walk_push(walk, start);
+}
+
+static pldm_entity_node *entity_walk_next(struct entity_walk *walk)
+{
+	if (walk->depth == 0) {
+		return NULL;
+	}
+
+	pldm_entity_node *node = walk->stack[--walk->depth];
+	entity_walk_push(walk, node->first_child);
+	entity_walk_push(walk, node->next_sibling);
+	return node;
+}
+
+static void entity_walk_fini(struct entity_walk *walk)
+{
+	free(walk->stack);
+	walk->stack = NULL;
+	walk->depth = 0;
+	walk->capacity = 0;
+}
+
 uint16_t next_container_id(pldm_entity_association_tree *tree)
 {
 	assert(tree != NULL);
@@ -893,6 +1570,10 @@ pldm_entity_association_tree *pldm_entity_association_tree_init()
 	assert(tree != NULL);
 	tree->root = NULL;
 	tree->last_used_container_id = 0;
+	tree->entity_index = NULL;
+	tree->host_index = NULL;
+	tree->index_size = 0;
+	tree->node_count = 0;
 
 	return tree;
 }
@@ -972,6 +1653,8 @@ pldm_entity_node *pldm_entity_association_tree_add(
 	    entity_instance_number != 0xFFFF ? entity_instance_number : 1;
 	node->association_type = association_type;
 	node->host_container_id = 0;
+	node->entity_next = NULL;
+	node->host_next = NULL;
 
 	if (tree->root == NULL) {
 		assert(parent == NULL);
@@ -1046,38 +1729,12 @@ pldm_entity_node *pldm_entity_association_tree_add(
 	if (is_update_contanier_id) {
 		entity->entity_container_id = node->entity.entity_container_id;
 	}
+	entity_index_insert(tree, node);
 
 	/*printf("\nexit pldm_entity_association_tree_add"); */
 	return node;
 }
 
-static void get_num_nodes(pldm_entity_node *node, size_t *num)
-{
-	if (node == NULL) {
-		return;
-	}
-
-	++(*num);
-	get_num_nodes(node->next_sibling, num);
-	get_num_nodes(node->first_child, num);
-}
-
-static void entity_association_tree_visit(pldm_entity_node *node,
-					  pldm_entity *entities, size_t *index)
-{
-	if (node == NULL) {
-		return;
-	}
-
-	pldm_entity *entity = &entities[*index];
-	++(*index);
-	entity->entity_type = node->entity.entity_type;
-	entity->entity_instance_num = node->entity.entity_instance_num;
-	entity->entity_container_id = node->entity.entity_container_id;
-	entity_association_tree_visit(node->next_sibling, entities, index);
-	entity_association_tree_visit(node->first_child, entities, index);
-}
-
 void pldm_entity_association_tree_visit(pldm_entity_association_tree *tree,
 					pldm_entity **entities, size_t *size)
 {
@@ -1090,21 +1747,26 @@ void pldm_entity_association_tree_visit(pldm_entity_association_tree *tree,
 		return;
 	}
 
-	get_num_nodes(tree->root, size);
-	*entities = malloc(*size * sizeof(pldm_entity));
-	size_t index = 0;
-	entity_association_tree_visit(tree->root, *entities, &index);
+	*entities = malloc(tree->node_count * sizeof(pldm_entity));
+	assert(*entities != NULL);
+	struct entity_walk walk;
+	entity_walk_init(&walk, tree->root);
+	pldm_entity_node *node = NULL;
+	while ((node = entity_walk_next(&walk)) != NULL) {
+		assert(*size < tree->node_count);
+		(*entities)[(*size)++] = node->entity;
+	}
+	entity_walk_fini(&walk);
 }
 
 static void entity_association_tree_destroy(pldm_entity_node *node)
 {
-	if (node == NULL) {
-		return;
+	struct entity_walk walk;
+	entity_walk_init(&walk, node);
+	while ((node = entity_walk_next(&walk)) != NULL) {
+		free(node);
 	}
-
-	entity_association_tree_destroy(node->next_sibling);
-	entity_association_tree_destroy(node->first_child);
-	free(node);
+	entity_walk_fini(&walk);
 }
 
 void pldm_entity_association_tree_destroy(pldm_entity_association_tree *tree)
@@ -1112,6 +1774,7 @@ void pldm_entity_association_tree_destroy(pldm_entity_association_tree *tree)
 	assert(tree != NULL);
 
 	entity_association_tree_destroy(tree->root);
+	entity_index_clear(tree);
 	free(tree);
 }
 
@@ -1135,17 +1798,7 @@ void pldm_entity_association_tree_delete_node(
 	pldm_entity_node *start = parent->first_child;
 	pldm_entity_node *prev = parent->first_child;
 	while (start != NULL) {
-		pldm_entity current_entity;
-		current_entity.entity_type = start->entity.entity_type;
-		current_entity.entity_instance_num =
-		    start->entity.entity_instance_num;
-		current_entity.entity_container_id =
-		    start->entity.entity_container_id;
-		if (current_entity.entity_type == entity.entity_type &&
-		    current_entity.entity_instance_num ==
-			entity.entity_instance_num &&
-		    current_entity.entity_container_id ==
-			entity.entity_container_id) {
+		if (start == node) {
 			if (start == parent->first_child) {
 				parent->first_child = start->next_sibling;
 			} else {
@@ -1157,7 +1810,19 @@ void pldm_entity_association_tree_delete_node(
 		prev = start;
 		start = start->next_sibling;
 	}
-	entity_association_tree_destroy(node);
+	/* The node is still linked somewhere else in the tree, leave it be
+	 * rather than free it from under its real parent */
+	if (start == NULL) {
+		return;
+	}
+
+	struct entity_walk walk;
+	entity_walk_init(&walk, node);
+	while ((node = entity_walk_next(&walk)) != NULL) {
+		entity_index_remove(tree, node);
+		free(node);
+	}
+	entity_walk_fini(&walk);
 }
 
 inline bool pldm_entity_is_node_parent(pldm_entity_node *node)
@@ -1329,21 +1994,16 @@ static void entity_association_pdr_add(pldm_entity_node *curr, pldm_pdr *repo,
 				       uint16_t terminus_handle,
 				       uint32_t record_handle)
 {
-	if (curr == NULL) {
-		return;
-	}
-	bool to_add = true;
-	to_add = is_present(curr->entity, entities, num_entities);
-	if (to_add) {
-		entity_association_pdr_add_entry(
-		    curr, repo, is_remote, terminus_handle, record_handle);
+	struct entity_walk walk;
+	entity_walk_init(&walk, curr);
+	while ((curr = entity_walk_next(&walk)) != NULL) {
+		if (is_present(curr->entity, entities, num_entities)) {
+			entity_association_pdr_add_entry(curr, repo, is_remote,
+							 terminus_handle,
+							 record_handle);
+		}
 	}
-	entity_association_pdr_add(curr->next_sibling, repo, entities,
-				   num_entities, is_remote, terminus_handle,
-				   record_handle);
-	entity_association_pdr_add(curr->first_child, repo, entities,
-				   num_entities, is_remote, terminus_handle,
-				   record_handle);
+	entity_walk_fini(&walk);
 }
 
 void pldm_entity_association_pdr_add(pldm_entity_association_tree *tree,
@@ -1380,9 +2040,10 @@ uint32_t find_record_handle_by_contained_entity(pldm_pdr *repo,
 	uint32_t record_handle = 0;
 	bool found = false;
 	assert(repo != NULL);
-	pldm_pdr_record *record = repo->first;
+	pldm_pdr_record *record =
+	    type_bucket_first(repo, PLDM_PDR_ENTITY_ASSOCIATION);
 	while (record != NULL && !found) {
-		pldm_pdr_record *next = record->next;
+		pldm_pdr_record *next = record->type_next;
 		struct pldm_pdr_hdr *hdr = (struct pldm_pdr_hdr *)record->data;
 		if ((record->is_remote == is_remote) &&
 		    hdr->type == PLDM_PDR_ENTITY_ASSOCIATION) {
@@ -1436,15 +2097,15 @@ uint32_t pldm_entity_association_pdr_remove_contained_entity(
 	/*	printf("\npldm_entity_association_pdr_remove_contained_entity
 	   found " "the record handle to delete %d", updated_hdl);*/
 
-	pldm_pdr_record *record = repo->first;
-	pldm_pdr_record *prev = repo->first;
+	pldm_pdr_record *record = find_record_by_handle(repo, updated_hdl);
 	pldm_pdr_record *new_record = malloc(sizeof(pldm_pdr_record));
+	new_record->chunk = NULL;
 	new_record->data = NULL; // sm00
 	// new_record->data = malloc(record->size - sizeof(pldm_entity)); //sm00
 	// new_record->next = NULL; //sm00
 	// uint8_t *new_data = new_record->data; //sm00
 	while (record != NULL) {
-		pldm_pdr_record *next = record->next;
+		pldm_pdr_record *next = record->hash_next;
 		struct pldm_pdr_hdr *hdr = (struct pldm_pdr_hdr *)record->data;
 		if (record->record_handle ==
 		    updated_hdl) /*(record->is_remote == is_remote) &&*/
@@ -1457,6 +2118,7 @@ uint32_t pldm_entity_association_pdr_remove_contained_entity(
 			new_record->size =
 			    htole32(record->size - sizeof(pldm_entity)); // sm00
 			new_record->is_remote = record->is_remote;
+			new_record->terminus_handle = record->terminus_handle;
 			uint8_t *new_start = new_record->data; // sm00 new_data;
 			struct pldm_pdr_hdr *new_hdr =
 			    (struct pldm_pdr_hdr *)
@@ -1528,47 +2190,14 @@ uint32_t pldm_entity_association_pdr_remove_contained_entity(
 			{
 				removed = false;
 				*event_data_op = PLDM_RECORDS_DELETED;
-				if (repo->first == record) {
-					repo->first = record->next;
-					record->next = NULL;
-				} else if (repo->last == record) {
-					repo->last = prev;
-					prev->next = NULL;
-				} else {
-					prev->next = record->next;
-					record->next = NULL;
-				}
-				repo->size -= record->size;
-				repo->record_count--;
-				if (record->data) {
-					free(record->data);
-				}
-				free(record);
+				unlink_record(repo, record);
+				free_record(repo, record);
 				break;
 			} else if (removed) {
-				if (repo->first == record) {
-					repo->first = new_record;
-					new_record->next = record->next;
-				} else {
-					prev->next = new_record;
-					new_record->next = record->next;
-					record->next = NULL; // sm00
-				}
-				if (repo->last == record) {
-					repo->last = new_record;
-					new_record->next = NULL; // sm00
-				}
-				repo->size -= record->size;
-				repo->size += new_record->size;
-
-				if (record->data) {
-					free(record->data);
-				}
-				free(record);
+				replace_record(repo, record, new_record);
 				break;
 			}
 		}
-		prev = record;
 		record = next;
 	}
 	if (!removed) {
@@ -1602,16 +2231,17 @@ uint32_t pldm_entity_association_pdr_add_contained_entity(
 	uint32_t updated_hdl = 0;
 	bool added = false;
 	*event_data_op = PLDM_RECORDS_MODIFIED;
-	pldm_pdr_record *record = repo->first;
-	pldm_pdr_record *prev = repo->first;
+	pldm_pdr_record *record =
+	    type_bucket_first(repo, PLDM_PDR_ENTITY_ASSOCIATION);
 	pldm_pdr_record *new_record = malloc(sizeof(pldm_pdr_record));
+	new_record->chunk = NULL;
 	new_record->data = NULL; // sm00
 	// new_record->data = malloc(record->size + sizeof(pldm_entity)); //sm00
 	// new_record->next = NULL; //sm00
 	uint8_t *new_data = NULL; // new_record->data; //sm00
 	bool found = false;
 	while (record != NULL) {
-		pldm_pdr_record *next = record->next;
+		pldm_pdr_record *next = record->type_next;
 		struct pldm_pdr_hdr *hdr = (struct pldm_pdr_hdr *)record->data;
 		if ((record->is_remote == is_remote) &&
 		    hdr->type == PLDM_PDR_ENTITY_ASSOCIATION) {
@@ -1635,6 +2265,8 @@ uint32_t pldm_entity_association_pdr_add_contained_entity(
 				new_record->size =
 				    htole32(record->size + sizeof(pldm_entity));
 				new_record->is_remote = record->is_remote;
+				new_record->terminus_handle =
+				    record->terminus_handle;
 				uint8_t *new_start = new_data;
 				struct pldm_pdr_hdr *new_hdr =
 				    (struct pldm_pdr_hdr *)new_data;
@@ -1687,28 +2319,11 @@ uint32_t pldm_entity_association_pdr_add_contained_entity(
 				    entity.entity_container_id;
 
 				added = true;
-				if (repo->first == record) {
-					repo->first = new_record;
-					new_record->next = record->next;
-				} else {
-					prev->next = new_record;
-					new_record->next = record->next;
-				}
-				if (repo->last == record) {
-					repo->last = new_record;
-				}
-				repo->size -= record->size;
-				repo->size += new_record->size;
-
-				if (record->data) {
-					free(record->data);
-				}
-				free(record);
+				replace_record(repo, record, new_record);
 				break;
 			}
 		}
 
-		prev = record;
 		record = next;
 	}
 	if (!found && !is_remote) // need to create a new entity assoc pdr
@@ -1717,16 +2332,10 @@ uint32_t pldm_entity_association_pdr_add_contained_entity(
 		uint8_t num_children = 1;
 		added = false;
 		*event_data_op = PLDM_RECORDS_ADDED;
-		prev = repo->first;
-		pldm_pdr_record *curr = repo->first;
-		while (curr != NULL) {
-			if (curr->record_handle == bmc_record_handle) {
-				// printf("\nfound the place \n");
-				added = true;
-				break;
-			}
-			prev = curr;
-			curr = curr->next;
+		pldm_pdr_record *curr =
+		    find_record_by_handle(repo, bmc_record_handle);
+		if (curr != NULL) {
+			added = true;
 		}
 
 		if (added) {
@@ -1739,13 +2348,7 @@ uint32_t pldm_entity_association_pdr_add_contained_entity(
 			new_record->record_handle = bmc_record_handle + 1;
 			new_record->size = new_pdr_size;
 			new_record->is_remote = false;
-			new_record->next = curr->next;
-			curr->next = new_record;
-			if (repo->last == prev) {
-				repo->last = new_record;
-			}
-			repo->size += new_record->size;
-			++repo->record_count;
+			new_record->terminus_handle = curr->terminus_handle;
 
 			updated_hdl = new_record->record_handle;
 
@@ -1778,6 +2381,10 @@ uint32_t pldm_entity_association_pdr_add_contained_entity(
 			    entity.entity_instance_num;
 			new_child->entity_container_id =
 			    entity.entity_container_id;
+
+			/* Link only once the header is in place, the type
+			 * bucket is taken from it */
+			link_record_after(repo, curr, new_record);
 		}
 	}
 	if (!added) {
@@ -1794,32 +2401,28 @@ uint32_t pldm_entity_association_pdr_add_contained_entity(
 	return updated_hdl;
 }
 
-void find_entity_ref_in_tree(pldm_entity_node *tree_node, pldm_entity entity,
-			     pldm_entity_node **node)
+void pldm_find_entity_ref_in_tree(pldm_entity_association_tree *tree,
+				  pldm_entity entity, pldm_entity_node **node)
 {
-	if (tree_node == NULL) {
-		return;
-	}
-
-	if (tree_node->entity.entity_type == entity.entity_type &&
-	    tree_node->entity.entity_instance_num ==
-		entity.entity_instance_num &&
-	    tree_node->entity.entity_container_id ==
-		entity.entity_container_id) {
+	assert(tree != NULL);
 
-		*node = tree_node;
+	if (tree->entity_index == NULL) {
 		return;
 	}
 
-	find_entity_ref_in_tree(tree_node->first_child, entity, node);
-	find_entity_ref_in_tree(tree_node->next_sibling, entity, node);
-}
-
-void pldm_find_entity_ref_in_tree(pldm_entity_association_tree *tree,
-				  pldm_entity entity, pldm_entity_node **node)
-{
-	assert(tree != NULL);
-	find_entity_ref_in_tree(tree->root, entity, node);
+	pldm_entity_node *curr = tree->entity_index[entity_index_slot(
+	    tree, entity.entity_type, entity.entity_instance_num, 0)];
+	while (curr != NULL) {
+		if (curr->entity.entity_type == entity.entity_type &&
+		    curr->entity.entity_instance_num ==
+			entity.entity_instance_num &&
+		    curr->entity.entity_container_id ==
+			entity.entity_container_id) {
+			*node = curr;
+			return;
+		}
+		curr = curr->entity_next;
+	}
 }
 
 void pldm_pdr_remove_pdrs_by_terminus_handle(uint32_t terminus_handle,
@@ -1828,26 +2431,11 @@ void pldm_pdr_remove_pdrs_by_terminus_handle(uint32_t terminus_handle,
 	assert(repo != NULL);
 
 	pldm_pdr_record *record = repo->first;
-	pldm_pdr_record *prev = NULL;
 	while (record != NULL) {
 		pldm_pdr_record *next = record->next;
 		if (record->terminus_handle == terminus_handle) {
-			if (repo->first == record) {
-				repo->first = next;
-			} else {
-				prev->next = next;
-			}
-			if (repo->last == record) {
-				repo->last = prev;
-			}
-			if (record->data) {
-				free(record->data);
-			}
-			--repo->record_count;
-			repo->size -= record->size;
-			free(record);
-		} else {
-			prev = record;
+			unlink_record(repo, record);
+			free_record(repo, record);
 		}
 		record = next;
 	}
@@ -1859,27 +2447,12 @@ void pldm_pdr_remove_remote_pdrs(pldm_pdr *repo)
 	bool removed = false;
 
 	pldm_pdr_record *record = repo->first;
-	pldm_pdr_record *prev = NULL;
 	while (record != NULL) {
 		pldm_pdr_record *next = record->next;
 		if (record->is_remote == true) {
-			if (repo->first == record) {
-				repo->first = next;
-			} else {
-				prev->next = next;
-			}
-			if (repo->last == record) {
-				repo->last = prev;
-			}
-			if (record->data) {
-				free(record->data);
-			}
-			--repo->record_count;
-			repo->size -= record->size;
-			free(record);
+			unlink_record(repo, record);
+			free_record(repo, record);
 			removed = true;
-		} else {
-			prev = record;
 		}
 		record = next;
 	}
@@ -1897,41 +2470,10 @@ void pldm_pdr_remove_remote_pdrs(pldm_pdr *repo)
 			}
 			record = record->next;
 		}
-	}
-}
-
-void entity_association_tree_find(pldm_entity_node *node, pldm_entity *entity,
-				  pldm_entity_node **out, bool is_remote)
-{
-	if (node == NULL) {
-		return;
-	}
-	if (is_remote) {
-
-		if (node->entity.entity_type == entity->entity_type &&
-		    node->entity.entity_instance_num ==
-			entity->entity_instance_num &&
-		    node->host_container_id == entity->entity_container_id) {
-			entity->entity_container_id =
-			    node->entity.entity_container_id;
-
-			*out = node;
-			return;
-		}
-	} else {
-		if (node->entity.entity_type == entity->entity_type &&
-		    node->entity.entity_instance_num ==
-			entity->entity_instance_num) {
-			entity->entity_container_id =
-			    node->entity.entity_container_id;
-			*out = node;
-			return;
+		if (repo->handle_index != NULL) {
+			handle_index_rebuild(repo, repo->handle_index_size);
 		}
 	}
-
-	entity_association_tree_find(node->next_sibling, entity, out,
-				     is_remote);
-	entity_association_tree_find(node->first_child, entity, out, is_remote);
 }
 
 pldm_entity_node *
@@ -1939,29 +2481,97 @@ pldm_entity_association_tree_find(pldm_entity_association_tree *tree,
 				  pldm_entity *entity, bool is_remote)
 {
 	assert(tree != NULL);
+	assert(entity != NULL);
+
+	if (tree->entity_index == NULL) {
+		return NULL;
+	}
 
 	pldm_entity_node *node = NULL;
-	entity_association_tree_find(tree->root, entity, &node, is_remote);
+	if (is_remote) {
+		node = tree->host_index[entity_index_slot(
+		    tree, entity->entity_type, entity->entity_instance_num,
+		    entity->entity_container_id)];
+		while (node != NULL &&
+		       (node->entity.entity_type != entity->entity_type ||
+			node->entity.entity_instance_num !=
+			    entity->entity_instance_num ||
+			node->host_container_id !=
+			    entity->entity_container_id)) {
+			node = node->host_next;
+		}
+	} else {
+		node = tree->entity_index[entity_index_slot(
+		    tree, entity->entity_type, entity->entity_instance_num, 0)];
+		while (node != NULL &&
+		       (node->entity.entity_type != entity->entity_type ||
+			node->entity.entity_instance_num !=
+			    entity->entity_instance_num)) {
+			node = node->entity_next;
+		}
+	}
+
+	if (node != NULL) {
+		entity->entity_container_id = node->entity.entity_container_id;
+	}
 	return node;
 }
 
-static void entity_association_tree_copy(pldm_entity_node *org_node,
+/* Copies the nodes reachable from org_node into new_tree, threading each copy
+ * into the link its original hangs off
+ */
+static void entity_association_tree_copy(pldm_entity_association_tree *new_tree,
+					 pldm_entity_node *org_node,
 					 pldm_entity_node **new_node)
 {
-	if (org_node == NULL) {
-		return;
+	struct copy_entry {
+		pldm_entity_node *org;
+		pldm_entity_node **link;
+	};
+	struct copy_entry *stack = NULL;
+	size_t depth = 0;
+	size_t capacity = 0;
+
+	if (org_node != NULL) {
+		capacity = 32;
+		stack = malloc(capacity * sizeof(struct copy_entry));
+		assert(stack != NULL);
+		stack[depth].org = org_node;
+		stack[depth].link = new_node;
+		++depth;
+	}
+
+	while (depth != 0) {
+		struct copy_entry entry = stack[--depth];
+		pldm_entity_node *node = malloc(sizeof(pldm_entity_node));
+		assert(node != NULL);
+		node->parent = entry.org->parent;
+		node->entity = entry.org->entity;
+		node->association_type = entry.org->association_type;
+		node->host_container_id = entry.org->host_container_id;
+		node->first_child = NULL;
+		node->next_sibling = NULL;
+		*entry.link = node;
+		entity_index_insert(new_tree, node);
+
+		if (depth + 2 > capacity) {
+			capacity *= 2;
+			stack = realloc(stack,
+					capacity * sizeof(struct copy_entry));
+			assert(stack != NULL);
+		}
+		if (entry.org->next_sibling != NULL) {
+			stack[depth].org = entry.org->next_sibling;
+			stack[depth].link = &node->next_sibling;
+			++depth;
+		}
+		if (entry.org->first_child != NULL) {
+			stack[depth].org = entry.org->first_child;
+			stack[depth].link = &node->first_child;
+			++depth;
+		}
 	}
-	*new_node = malloc(sizeof(pldm_entity_node));
-	(*new_node)->parent = org_node->parent;
-	(*new_node)->entity = org_node->entity;
-	(*new_node)->association_type = org_node->association_type;
-	(*new_node)->host_container_id = org_node->host_container_id;
-	(*new_node)->first_child = NULL;
-	(*new_node)->next_sibling = NULL;
-	entity_association_tree_copy(org_node->first_child,
-				     &((*new_node)->first_child));
-	entity_association_tree_copy(org_node->next_sibling,
-				     &((*new_node)->next_sibling));
+	free(stack);
 }
 
 void pldm_entity_association_tree_copy_root(
@@ -1969,7 +2579,8 @@ void pldm_entity_association_tree_copy_root(
     pldm_entity_association_tree *new_tree)
 {
 	new_tree->last_used_container_id = org_tree->last_used_container_id;
-	entity_association_tree_copy(org_tree->root, &(new_tree->root));
+	entity_association_tree_copy(new_tree, org_tree->root,
+				     &(new_tree->root));
 }
 
 void pldm_entity_association_tree_destroy_root(
@@ -1977,6 +2588,7 @@ void pldm_entity_association_tree_destroy_root(
 {
 	assert(tree != NULL);
 	entity_association_tree_destroy(tree->root);
+	entity_index_clear(tree);
 	tree->last_used_container_id = 0;
 	tree->root = NULL;
 }
@@ -2043,6 +2655,8 @@ pldm_entity_node *init_pldm_entity_node(pldm_entity entity, pldm_entity parent,
 	node->first_child = first_child;
 	node->next_sibling = next_sibling;
 	node->association_type = association_type;
+	node->entity_next = NULL;
+	node->host_next = NULL;
 
 	return node;
 }
@@ -22,6 +22,24 @@ extern "C" {
  */
 pldm_pdr *pldm_pdr_init();
 
+/** @brief Make a new PDR repository whose records are carved out of arena
+ *  chunks instead of being allocated one by one
+ *
+ *  Records and their data sit back to back in chunks, and each chunk only
+ *  holds the records of one terminus and origin (local/remote). The space of
+ *  a removed record is reused by later records of the same terminus and
+ *  origin, and a chunk goes back to the heap as soon as its last record is
+ *  removed, so removing all remote PDRs or all PDRs of a terminus releases
+ *  whole chunks.
+ *
+ *  @param[in] chunk_size - size of an arena chunk in bytes, 0 for the default.
+ *  Records that do not fit in a chunk of this size get a chunk of their own.
+ *
+ *  @return opaque pointer that acts as a handle to the repository; NULL if no
+ *  repository could be created
+ */
+pldm_pdr *pldm_pdr_init_arena(size_t chunk_size);
+
 /** @brief Destroy a PDR repository (and free up associated resources)
  *
  *  @param[in/out] repo - pointer to opaque pointer acting as a PDR repo handle
@@ -161,6 +179,64 @@ pldm_pdr_find_record_by_type(const pldm_pdr *repo, uint8_t pdr_type,
 			     const pldm_pdr_record *curr_record, uint8_t **data,
 			     uint32_t *size);
 
+/** @brief Get the PDR record of the same PDR type next to input PDR record
+ *
+ *  @param[in] curr_record - opaque pointer acting as a PDR record handle
+ *  @param[in/out] data - will point to PDR record data (as per DSP0248) on
+ *                        return, if input is not NULL
+ *  @param[out] size - *size will be size of PDR record, if input is not NULL
+ *
+ *  @return opaque pointer acting as PDR record handle, will be NULL if there
+ *  are no more records of that type
+ */
+const pldm_pdr_record *
+pldm_pdr_get_next_record_by_type(const pldm_pdr_record *curr_record,
+				 uint8_t **data, uint32_t *size);
+
+/** @brief Get number of records of a PDR type in a PDR repository
+ *
+ *  @param[in] repo - opaque pointer acting as a PDR repo handle
+ *  @param[in] pdr_type - PDR type number as per DSP0248
+ *
+ *  @return uint32_t - number of records of that type
+ */
+uint32_t pldm_pdr_get_record_count_by_type(const pldm_pdr *repo,
+					   uint8_t pdr_type);
+
+/** @brief Find a state sensor PDR record by sensor ID
+ *
+ *  @param[in] repo - opaque pointer acting as a PDR repo handle
+ *  @param[in] sensor_id - sensor ID
+ *  @param[in] is_remote - indicates which PDR to search, local or remote
+ *  @param[in/out] data - will point to PDR record data (as per DSP0248) on
+ *                        return, if input is not NULL
+ *  @param[out] size - *size will be size of PDR record, if input is not NULL
+ *
+ *  @return opaque pointer acting as PDR record handle, will be NULL if record
+ *  was not found
+ */
+const pldm_pdr_record *
+pldm_pdr_find_record_by_sensor_id(const pldm_pdr *repo, uint16_t sensor_id,
+				  bool is_remote, uint8_t **data,
+				  uint32_t *size);
+
+/** @brief Find a state or numeric effecter PDR record by effecter ID
+ *
+ *  @param[in] repo - opaque pointer acting as a PDR repo handle
+ *  @param[in] effecter_id - effecter ID
+ *  @param[in] is_remote - indicates which PDR to search, local or remote
+ *  @param[in/out] data - will point to PDR record data (as per DSP0248) on
+ *                        return, if input is not NULL
+ *  @param[out] size - *size will be size of PDR record, if input is not NULL
+ *
+ *  @return opaque pointer acting as PDR record handle, will be NULL if record
+ *  was not found
+ */
+const pldm_pdr_record *
+pldm_pdr_find_record_by_effecter_id(const pldm_pdr *repo, uint16_t effecter_id,
+				    bool is_remote, uint8_t **data,
+				    uint32_t *size);
+
 bool pldm_pdr_record_is_remote(const pldm_pdr_record *record);
 
 /** @brief Remove all PDR records that belong to a remote terminus
@@ -9,20 +9,67 @@ extern "C" {
 #include <stddef.h>
 #include <stdint.h>
 
+typedef struct pldm_pdr_arena_chunk pldm_pdr_arena_chunk;
+typedef struct pldm_pdr_arena_slot pldm_pdr_arena_slot;
+
 typedef struct pldm_pdr_record {
 	uint32_t record_handle;
 	uint32_t size;
 	uint8_t *data;
 	struct pldm_pdr_record *next;
+	struct pldm_pdr_record *prev;
+	struct pldm_pdr_record *hash_next;
+	struct pldm_pdr_record *type_next;
+	struct pldm_pdr_record *type_prev;
+	struct pldm_pdr_record *id_next;
+	uint32_t id_key;
+	uint8_t pdr_type;
 	bool is_remote;
 	uint16_t terminus_handle;
+	pldm_pdr_arena_chunk *chunk; /* NULL if record and data were malloc()ed */
+	uint32_t slot_size; /* arena bytes held by the record and its data */
 } pldm_pdr_record;
 
+/* Arena chunks hold records and their data back to back, and each chunk only
+ * holds records of one (is_remote, terminus_handle) origin. The slot of a
+ * removed record goes on the free list of its chunk for the next record of
+ * that origin which fits, and a chunk is freed as a whole once its last
+ * record is removed.
+ */
+struct pldm_pdr_arena_slot {
+	struct pldm_pdr_arena_slot *next;
+	size_t size;
+};
+
+struct pldm_pdr_arena_chunk {
+	struct pldm_pdr_arena_chunk *next;
+	size_t capacity;
+	size_t used;
+	uint32_t live_records;
+	bool is_remote;
+	uint16_t terminus_handle;
+	pldm_pdr_arena_slot *free_slots;
+};
+
+typedef struct pldm_pdr_type_bucket {
+	pldm_pdr_record *first;
+	pldm_pdr_record *last;
+	uint32_t record_count;
+} pldm_pdr_type_bucket;
+
 typedef struct pldm_pdr {
 	uint32_t record_count;
 	uint32_t size;
 	pldm_pdr_record *first;
 	pldm_pdr_record *last;
+	pldm_pdr_record **handle_index;
+	uint32_t handle_index_size;
+	pldm_pdr_type_bucket *type_buckets;
+	pldm_pdr_record **id_index;
+	uint32_t id_index_size;
+	uint32_t id_index_count;
+	pldm_pdr_arena_chunk *arena;
+	size_t arena_chunk_size; /* 0 if records are malloc()ed one by one */
 } pldm_pdr;
 
 /** @struct pldm_pdr
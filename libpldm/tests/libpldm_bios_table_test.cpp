@@ -531,6 +531,30 @@ TEST(AttrTable, FindTest)
     entry = pldm_bios_table_attr_find_by_string_handle(table.data(),
                                                        table.size(), 4);
     EXPECT_EQ(entry, nullptr);
+
+    auto index = pldm_bios_table_index_create(table.data(), table.size(),
+                                              PLDM_BIOS_ATTR_TABLE);
+    ASSERT_NE(index, nullptr);
+
+    /* the first of the duplicated handles is found, as with a scan */
+    EXPECT_EQ(pldm_bios_table_index_attr_find_by_handle(index, 0),
+              pldm_bios_table_attr_find_by_handle(table.data(), table.size(),
+                                                  0));
+    EXPECT_EQ(pldm_bios_table_index_attr_find_by_handle(index, 1),
+              pldm_bios_table_attr_find_by_handle(table.data(), table.size(),
+                                                  1));
+    EXPECT_EQ(pldm_bios_table_index_attr_find_by_handle(index, 3), nullptr);
+    for (uint16_t handle = 0; handle < 5; handle++)
+    {
+        EXPECT_EQ(pldm_bios_table_index_attr_find_by_string_handle(index,
+                                                                   handle),
+                  pldm_bios_table_attr_find_by_string_handle(
+                      table.data(), table.size(), handle));
+    }
+    EXPECT_EQ(pldm_bios_table_index_string_find_by_handle(index, 1), nullptr);
+    EXPECT_EQ(pldm_bios_table_index_attr_value_find_by_handle(index, 1),
+              nullptr);
+    pldm_bios_table_index_free(index);
 }
 
 TEST(AttrValTable, HeaderDecodeTest)
@@ -839,6 +863,19 @@ TEST(AttrValTable, FindTest)
                                                       table.size(), 3);
     EXPECT_EQ(entry, nullptr);
 
+    auto index = pldm_bios_table_index_create(table.data(), table.size(),
+                                              PLDM_BIOS_ATTR_VAL_TABLE);
+    ASSERT_NE(index, nullptr);
+    for (uint16_t handle = 0; handle < 4; handle++)
+    {
+        EXPECT_EQ(pldm_bios_table_index_attr_value_find_by_handle(index,
+                                                                  handle),
+                  pldm_bios_table_attr_value_find_by_handle(
+                      table.data(), table.size(), handle));
+    }
+    EXPECT_EQ(pldm_bios_table_index_attr_find_by_handle(index, 1), nullptr);
+    pldm_bios_table_index_free(index);
+
     auto firstEntry =
         reinterpret_cast<struct pldm_bios_attr_val_table_entry*>(table.data());
     firstEntry->attr_type = PLDM_BIOS_PASSWORD;
@@ -942,6 +979,136 @@ TEST(AttrValTable, CopyAndUpdateTest)
     EXPECT_EQ(rc, PLDM_ERROR_INVALID_LENGTH);
 }
 
+TEST(AttrValTable, UpdateInPlaceTest)
+{
+    std::vector<uint8_t> enumEntry{
+        0, 0, /* attr handle */
+        0,    /* attr type */
+        1,    /* number of current value */
+        0,    /* current value string handle index */
+    };
+    std::vector<uint8_t> stringEntry{
+        1,   0,        /* attr handle */
+        1,             /* attr type */
+        3,   0,        /* current string length */
+        'a', 'b', 'c', /* current string */
+    };
+    std::vector<uint8_t> integerEntry{
+        2,  0,                   /* attr handle */
+        3,                       /* attr type */
+        10, 0, 0, 0, 0, 0, 0, 0, /* current value */
+    };
+
+    Table table;
+    buildTable(table, enumEntry, stringEntry, integerEntry);
+    auto findEntry = [&table](uint16_t handle) {
+        return pldm_bios_table_attr_value_find_by_handle(table.data(),
+                                                         table.size(), handle);
+    };
+
+    std::vector<uint8_t> enumEntry1{0, 0, 0, 1, 1};
+    std::vector<uint8_t> stringEntry1{1, 0, 1, 3, 0, 'd', 'e', 'f'};
+    std::vector<uint8_t> integerEntry1{
+        2, 0, 3, 0xef, 0xbe, 0xad, 0xde, 0, 0, 0, 0,
+    };
+
+    Table expectTable;
+    buildTable(expectTable, enumEntry1, stringEntry, integerEntry);
+    auto rc = pldm_bios_table_attr_value_entry_update_in_place(
+        table.data(), table.size(), findEntry(0), enumEntry1.data(),
+        enumEntry1.size());
+    EXPECT_EQ(rc, PLDM_SUCCESS);
+    EXPECT_THAT(table, ElementsAreArray(expectTable));
+    EXPECT_TRUE(pldm_bios_table_checksum(table.data(), table.size()));
+
+    expectTable.resize(0);
+    buildTable(expectTable, enumEntry1, stringEntry1, integerEntry1);
+    rc = pldm_bios_table_attr_value_entry_update_in_place(
+        table.data(), table.size(), findEntry(2), integerEntry1.data(),
+        integerEntry1.size());
+    EXPECT_EQ(rc, PLDM_SUCCESS);
+    rc = pldm_bios_table_attr_value_entry_update_in_place(
+        table.data(), table.size(), findEntry(1), stringEntry1.data(),
+        stringEntry1.size());
+    EXPECT_EQ(rc, PLDM_SUCCESS);
+    EXPECT_THAT(table, ElementsAreArray(expectTable));
+    EXPECT_TRUE(pldm_bios_table_checksum(table.data(), table.size()));
+
+    /* a string of another length doesn't fit the slot */
+    std::vector<uint8_t> stringEntry2{1, 0, 1, 4, 0, 'd', 'e', 'f', 'g'};
+    rc = pldm_bios_table_attr_value_entry_update_in_place(
+        table.data(), table.size(), findEntry(1), stringEntry2.data(),
+        stringEntry2.size());
+    EXPECT_EQ(rc, PLDM_ERROR_INVALID_LENGTH);
+
+    /* the handle and type must match the entry being replaced */
+    rc = pldm_bios_table_attr_value_entry_update_in_place(
+        table.data(), table.size(), findEntry(0), stringEntry.data(),
+        stringEntry.size());
+    EXPECT_EQ(rc, PLDM_ERROR_INVALID_DATA);
+    stringEntry[2] = PLDM_BIOS_INTEGER;
+    rc = pldm_bios_table_attr_value_entry_update_in_place(
+        table.data(), table.size(), findEntry(1), stringEntry.data(),
+        stringEntry.size());
+    EXPECT_EQ(rc, PLDM_ERROR_INVALID_DATA);
+
+    /* the entry must be within the table */
+    Table other(table);
+    rc = pldm_bios_table_attr_value_entry_update_in_place(
+        other.data(), other.size() - 20, findEntry(2), integerEntry.data(),
+        integerEntry.size());
+    EXPECT_EQ(rc, PLDM_ERROR_INVALID_DATA);
+
+    EXPECT_THAT(table, ElementsAreArray(expectTable));
+}
+
+TEST(AttrValTable, UpdateInPlaceLargeTableTest)
+{
+    Table table;
+    for (uint16_t handle = 0; handle < 1000; handle++)
+    {
+        std::vector<uint8_t> entry{
+            static_cast<uint8_t>(handle & 0xff),
+            static_cast<uint8_t>(handle >> 8),
+            3, /* attr type */
+            static_cast<uint8_t>(handle & 0xff),
+            0,
+            0,
+            0,
+            0,
+            0,
+            0,
+            0, /* current value */
+        };
+        table.insert(table.end(), entry.begin(), entry.end());
+    }
+    buildTable(table);
+
+    for (uint16_t handle : {0, 1, 500, 998, 999})
+    {
+        std::vector<uint8_t> entry{
+            static_cast<uint8_t>(handle & 0xff),
+            static_cast<uint8_t>(handle >> 8),
+            3,
+            0x5a,
+            0xa5,
+            0,
+            0,
+            0,
+            0,
+            0,
+            1,
+        };
+        auto dest = pldm_bios_table_attr_value_find_by_handle(
+            table.data(), table.size(), handle);
+        ASSERT_NE(dest, nullptr);
+        auto rc = pldm_bios_table_attr_value_entry_update_in_place(
+            table.data(), table.size(), dest, entry.data(), entry.size());
+        EXPECT_EQ(rc, PLDM_SUCCESS);
+        EXPECT_TRUE(pldm_bios_table_checksum(table.data(), table.size()));
+    }
+}
+
 TEST(StringTable, EntryEncodeTest)
 {
     std::vector<uint8_t> stringEntry{
@@ -1082,6 +1249,71 @@ TEST(StringTable, FindTest)
     entry =
         pldm_bios_table_string_find_by_handle(table.data(), table.size(), 4);
     EXPECT_EQ(entry, nullptr);
+
+    auto index = pldm_bios_table_index_create(table.data(), table.size(),
+                                              PLDM_BIOS_STRING_TABLE);
+    ASSERT_NE(index, nullptr);
+    for (auto str : {"Hello", "World!", "Hi", "Worl", "", "Hello!"})
+    {
+        EXPECT_EQ(pldm_bios_table_index_string_find_by_string(index, str),
+                  pldm_bios_table_string_find_by_string(table.data(),
+                                                        table.size(), str));
+    }
+    for (uint16_t handle = 0; handle < 5; handle++)
+    {
+        EXPECT_EQ(pldm_bios_table_index_string_find_by_handle(index, handle),
+                  pldm_bios_table_string_find_by_handle(
+                      table.data(), table.size(), handle));
+    }
+    EXPECT_EQ(pldm_bios_table_index_attr_find_by_string_handle(index, 2),
+              nullptr);
+    pldm_bios_table_index_free(index);
+}
+
+TEST(StringTable, IndexTest)
+{
+    constexpr uint16_t count = 1000;
+    Table table;
+    for (uint16_t handle = 0; handle < count; handle++)
+    {
+        auto str = "attribute_" + std::to_string(handle);
+        auto length = pldm_bios_table_string_entry_encode_length(str.size());
+        auto offset = table.size();
+        table.resize(offset + length);
+        pldm_bios_table_string_entry_encode(table.data() + offset, length,
+                                            str.c_str(), str.size());
+        // Set the handle explicitly, the encoder hands out global ones
+        table[offset] = handle & 0xff;
+        table[offset + 1] = handle >> 8;
+    }
+    auto size = table.size();
+    table.resize(size + pldm_bios_table_pad_checksum_size(size));
+    pldm_bios_table_append_pad_checksum(table.data(), table.size(), size);
+
+    auto index = pldm_bios_table_index_create(table.data(), table.size(),
+                                              PLDM_BIOS_STRING_TABLE);
+    ASSERT_NE(index, nullptr);
+    for (uint16_t handle = 0; handle < count; handle++)
+    {
+        auto str = "attribute_" + std::to_string(handle);
+        auto entry =
+            pldm_bios_table_index_string_find_by_string(index, str.c_str());
+        ASSERT_NE(entry, nullptr);
+        EXPECT_EQ(pldm_bios_table_string_entry_decode_handle(entry), handle);
+        EXPECT_EQ(pldm_bios_table_index_string_find_by_handle(index, handle),
+                  entry);
+    }
+    EXPECT_EQ(pldm_bios_table_index_string_find_by_handle(index, count),
+              nullptr);
+    EXPECT_EQ(pldm_bios_table_index_string_find_by_string(index, "attribute_"),
+              nullptr);
+    pldm_bios_table_index_free(index);
+
+    EXPECT_EQ(pldm_bios_table_index_create(
+                  table.data(), table.size(),
+                  static_cast<pldm_bios_table_types>(PLDM_BIOS_ATTR_VAL_TABLE +
+                                                     1)),
+              nullptr);
 }
 
 TEST(Itearator, DeathTest)
@@ -1,4 +1,9 @@
+#include <algorithm>
 #include <array>
+#include <chrono>
+#include <random>
+#include <string>
+#include <vector>
 
 #include "libpldm/pdr.h"
 #include "libpldm/platform.h"
@@ -433,6 +438,415 @@ TEST(PDRAccess, testFindByType)
     pldm_pdr_destroy(repo);
 }
 
+TEST(PDRAccess, testFindAfterInsertAndDelete)
+{
+    auto repo = pldm_pdr_init();
+
+    std::array<uint8_t, sizeof(pldm_pdr_hdr)> data{};
+    for (uint32_t handle = 1; handle <= 200; ++handle)
+    {
+        pldm_pdr_add(repo, data.data(), data.size(), handle, false, 1);
+    }
+    pldm_pdr_add_after_prev_record(repo, data.data(), data.size(), 0x01000000,
+                                   true, 100, 2);
+    EXPECT_EQ(pldm_pdr_get_record_count(repo), 201u);
+
+    uint8_t* outData = nullptr;
+    uint32_t size{};
+    uint32_t nextRecHdl{};
+    auto rec = pldm_pdr_find_record(repo, 100, &outData, &size, &nextRecHdl);
+    EXPECT_NE(rec, nullptr);
+    EXPECT_EQ(nextRecHdl, 0x01000000u);
+    rec = pldm_pdr_find_record(repo, 0x01000000, &outData, &size, &nextRecHdl);
+    EXPECT_NE(rec, nullptr);
+    EXPECT_EQ(pldm_pdr_record_is_remote(rec), true);
+    EXPECT_EQ(nextRecHdl, 101u);
+
+    uint32_t prevRecHdl{};
+    EXPECT_EQ(pldm_pdr_find_prev_record_handle(repo, 101, &prevRecHdl), true);
+    EXPECT_EQ(prevRecHdl, 0x01000000u);
+    EXPECT_EQ(pldm_pdr_find_prev_record_handle(repo, 1, &prevRecHdl), true);
+    EXPECT_EQ(prevRecHdl, 1u);
+    EXPECT_EQ(pldm_pdr_find_prev_record_handle(repo, 500, &prevRecHdl), false);
+
+    // The remote flag has to match for the record to be deleted
+    pldm_delete_by_record_handle(repo, 0x01000000, false);
+    EXPECT_EQ(pldm_pdr_get_record_count(repo), 201u);
+    pldm_delete_by_record_handle(repo, 0x01000000, true);
+    EXPECT_EQ(pldm_pdr_get_record_count(repo), 200u);
+    rec = pldm_pdr_find_record(repo, 0x01000000, &outData, &size, &nextRecHdl);
+    EXPECT_EQ(rec, nullptr);
+    rec = pldm_pdr_find_record(repo, 100, &outData, &size, &nextRecHdl);
+    EXPECT_EQ(nextRecHdl, 101u);
+
+    pldm_delete_by_record_handle(repo, 200, false);
+    rec = pldm_pdr_find_record(repo, 199, &outData, &size, &nextRecHdl);
+    EXPECT_NE(rec, nullptr);
+    EXPECT_EQ(nextRecHdl, 0u);
+    EXPECT_EQ(pldm_pdr_add(repo, data.data(), data.size(), 0, false, 1), 200u);
+
+    pldm_pdr_destroy(repo);
+}
+
+TEST(PDRAccess, testFindAfterRemoteRemoval)
+{
+    auto repo = pldm_pdr_init();
+
+    std::array<uint8_t, sizeof(pldm_pdr_hdr)> data{};
+    for (uint32_t i = 0; i < 100; ++i)
+    {
+        pldm_pdr_add(repo, data.data(), data.size(), 0, i % 2, 1);
+    }
+    pldm_pdr_remove_remote_pdrs(repo);
+    EXPECT_EQ(pldm_pdr_get_record_count(repo), 50u);
+
+    // The remaining records are renumbered from 1
+    uint8_t* outData = nullptr;
+    uint32_t size{};
+    uint32_t nextRecHdl{};
+    for (uint32_t handle = 1; handle <= 50; ++handle)
+    {
+        auto rec =
+            pldm_pdr_find_record(repo, handle, &outData, &size, &nextRecHdl);
+        ASSERT_NE(rec, nullptr);
+        EXPECT_EQ(pldm_pdr_record_is_remote(rec), false);
+        EXPECT_EQ(nextRecHdl, handle < 50 ? handle + 1 : 0u);
+        auto hdr = reinterpret_cast<pldm_pdr_hdr*>(outData);
+        EXPECT_EQ(le32toh(hdr->record_handle), handle);
+    }
+    auto rec = pldm_pdr_find_record(repo, 51, &outData, &size, &nextRecHdl);
+    EXPECT_EQ(rec, nullptr);
+
+    pldm_pdr_destroy(repo);
+}
+
+TEST(PDRAccess, benchmarkWalk10kRecords)
+{
+    constexpr uint32_t numRecords = 10000;
+    auto repo = pldm_pdr_init();
+
+    std::array<uint8_t, sizeof(pldm_pdr_hdr)> data{};
+    for (uint32_t i = 0; i < numRecords; ++i)
+    {
+        pldm_pdr_add(repo, data.data(), data.size(), 0, false, 1);
+    }
+
+    // Walk the repo the way GetPDR does, one record handle at a time
+    auto start = std::chrono::steady_clock::now();
+    uint8_t* outData = nullptr;
+    uint32_t size{};
+    uint32_t recordHandle = 0;
+    uint32_t nextRecHdl{};
+    uint32_t visited = 0;
+    do
+    {
+        auto rec = pldm_pdr_find_record(repo, recordHandle, &outData, &size,
+                                        &nextRecHdl);
+        ASSERT_NE(rec, nullptr);
+        ++visited;
+        recordHandle = nextRecHdl;
+    } while (recordHandle);
+    auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start);
+    RecordProperty("walk_us", std::to_string(elapsed.count()));
+
+    EXPECT_EQ(visited, numRecords);
+    pldm_pdr_destroy(repo);
+}
+
+TEST(PDRAccess, testTypeBuckets)
+{
+    auto repo = pldm_pdr_init();
+
+    std::array<uint8_t, sizeof(pldm_pdr_hdr)> data{};
+    pldm_pdr_hdr* hdr = reinterpret_cast<pldm_pdr_hdr*>(data.data());
+    for (uint32_t handle = 1; handle <= 10; ++handle)
+    {
+        hdr->type =
+            handle % 2 ? PLDM_STATE_SENSOR_PDR : PLDM_PDR_FRU_RECORD_SET;
+        pldm_pdr_add(repo, data.data(), data.size(), handle, false, 1);
+    }
+    // Insert a sensor PDR between the FRU record sets 4 and 6
+    hdr->type = PLDM_STATE_SENSOR_PDR;
+    pldm_pdr_add_after_prev_record(repo, data.data(), data.size(), 100, false,
+                                   4, 1);
+    EXPECT_EQ(pldm_pdr_get_record_count_by_type(repo, PLDM_STATE_SENSOR_PDR),
+              6u);
+    EXPECT_EQ(pldm_pdr_get_record_count_by_type(repo, PLDM_PDR_FRU_RECORD_SET),
+              5u);
+    EXPECT_EQ(pldm_pdr_get_record_count_by_type(repo, PLDM_OEM_PDR), 0u);
+
+    uint8_t* outData = nullptr;
+    uint32_t size{};
+    std::vector<uint32_t> handles;
+    for (auto rec = pldm_pdr_find_record_by_type(repo, PLDM_STATE_SENSOR_PDR,
+                                                 nullptr, &outData, &size);
+         rec; rec = pldm_pdr_get_next_record_by_type(rec, &outData, &size))
+    {
+        handles.push_back(pldm_pdr_get_record_handle(repo, rec));
+    }
+    EXPECT_EQ(handles, (std::vector<uint32_t>{1, 3, 100, 5, 7, 9}));
+
+    pldm_delete_by_record_handle(repo, 100, false);
+    pldm_delete_by_record_handle(repo, 9, false);
+    handles.clear();
+    for (auto rec = pldm_pdr_find_record_by_type(repo, PLDM_STATE_SENSOR_PDR,
+                                                 nullptr, &outData, &size);
+         rec; rec = pldm_pdr_get_next_record_by_type(rec, &outData, &size))
+    {
+        handles.push_back(pldm_pdr_get_record_handle(repo, rec));
+    }
+    EXPECT_EQ(handles, (std::vector<uint32_t>{1, 3, 5, 7}));
+
+    // Searching from a record of another type continues in repo order
+    uint32_t nextRecHdl{};
+    auto fru = pldm_pdr_find_record(repo, 4, &outData, &size, &nextRecHdl);
+    auto rec = pldm_pdr_find_record_by_type(repo, PLDM_STATE_SENSOR_PDR, fru,
+                                            &outData, &size);
+    EXPECT_EQ(pldm_pdr_get_record_handle(repo, rec), 5u);
+
+    pldm_pdr_destroy(repo);
+}
+
+TEST(PDRAccess, testFindBySensorAndEffecterId)
+{
+    auto repo = pldm_pdr_init();
+
+    std::array<uint8_t, sizeof(pldm_state_sensor_pdr)> sensor{};
+    auto sensorPdr = reinterpret_cast<pldm_state_sensor_pdr*>(sensor.data());
+    sensorPdr->hdr.type = PLDM_STATE_SENSOR_PDR;
+    std::array<uint8_t, sizeof(pldm_state_effecter_pdr)> effecter{};
+    auto effecterPdr =
+        reinterpret_cast<pldm_state_effecter_pdr*>(effecter.data());
+    effecterPdr->hdr.type = PLDM_STATE_EFFECTER_PDR;
+
+    for (uint16_t id = 1; id <= 100; ++id)
+    {
+        sensorPdr->sensor_id = htole16(id);
+        pldm_pdr_add(repo, sensor.data(), sensor.size(), 0, false, 1);
+        effecterPdr->effecter_id = htole16(id);
+        effecterPdr->container_id = 0;
+        pldm_pdr_add(repo, effecter.data(), effecter.size(), 0, false, 1);
+    }
+    // A remote sensor sharing an id with a local one
+    sensorPdr->sensor_id = htole16(5);
+    auto remoteHdl = pldm_pdr_add(repo, sensor.data(), sensor.size(),
+                                  0x01000000, true, 2);
+
+    uint8_t* outData = nullptr;
+    uint32_t size{};
+    auto rec =
+        pldm_pdr_find_record_by_sensor_id(repo, 5, false, &outData, &size);
+    ASSERT_NE(rec, nullptr);
+    EXPECT_EQ(pldm_pdr_get_record_handle(repo, rec), 9u);
+    EXPECT_EQ(size, sensor.size());
+    rec = pldm_pdr_find_record_by_sensor_id(repo, 5, true, &outData, &size);
+    ASSERT_NE(rec, nullptr);
+    EXPECT_EQ(pldm_pdr_get_record_handle(repo, rec), remoteHdl);
+    rec = pldm_pdr_find_record_by_sensor_id(repo, 101, false, &outData, &size);
+    EXPECT_EQ(rec, nullptr);
+    EXPECT_EQ(size, 0u);
+    rec = pldm_pdr_find_record_by_effecter_id(repo, 100, false, &outData,
+                                              &size);
+    ASSERT_NE(rec, nullptr);
+    EXPECT_EQ(pldm_pdr_get_record_handle(repo, rec), 200u);
+
+    pldm_change_container_id_of_effecter(repo, 42, 7);
+    rec = pldm_pdr_find_record_by_effecter_id(repo, 42, false, &outData, &size);
+    ASSERT_NE(rec, nullptr);
+    EXPECT_EQ(
+        reinterpret_cast<pldm_state_effecter_pdr*>(outData)->container_id, 7);
+
+    EXPECT_EQ(pldm_delete_by_sensor_id(repo, 5, true),
+              static_cast<uint16_t>(remoteHdl));
+    EXPECT_EQ(pldm_pdr_find_record_by_sensor_id(repo, 5, true, nullptr,
+                                                nullptr),
+              nullptr);
+    EXPECT_NE(pldm_pdr_find_record_by_sensor_id(repo, 5, false, nullptr,
+                                                nullptr),
+              nullptr);
+    EXPECT_EQ(pldm_delete_by_effecter_id(repo, 42, false), 84u);
+    EXPECT_EQ(pldm_pdr_find_record_by_effecter_id(repo, 42, false, nullptr,
+                                                  nullptr),
+              nullptr);
+    EXPECT_EQ(pldm_delete_by_effecter_id(repo, 42, false), 0u);
+    EXPECT_EQ(pldm_pdr_get_record_count(repo), 199u);
+    EXPECT_EQ(pldm_pdr_get_record_count_by_type(repo, PLDM_STATE_EFFECTER_PDR),
+              99u);
+
+    pldm_pdr_destroy(repo);
+}
+
+TEST(PDRUpdate, testChangeIdCollision)
+{
+    auto repo = pldm_pdr_init();
+
+    std::array<uint8_t, sizeof(pldm_state_sensor_pdr)> sensor{};
+    auto sensorPdr = reinterpret_cast<pldm_state_sensor_pdr*>(sensor.data());
+    sensorPdr->hdr.type = PLDM_STATE_SENSOR_PDR;
+    sensorPdr->sensor_id = htole16(3);
+    std::array<uint8_t, sizeof(pldm_state_effecter_pdr)> effecter{};
+    auto effecterPdr =
+        reinterpret_cast<pldm_state_effecter_pdr*>(effecter.data());
+    effecterPdr->hdr.type = PLDM_STATE_EFFECTER_PDR;
+    effecterPdr->effecter_id = htole16(4);
+
+    // A remote sensor ahead of a local one with the same id, and a local
+    // effecter ahead of a remote one with the same id
+    auto remoteSensor = pldm_pdr_add(repo, sensor.data(), sensor.size(),
+                                     0x01000000, true, 2);
+    auto localSensor =
+        pldm_pdr_add(repo, sensor.data(), sensor.size(), 0, false, 1);
+    auto localEffecter =
+        pldm_pdr_add(repo, effecter.data(), effecter.size(), 0, false, 1);
+    auto remoteEffecter = pldm_pdr_add(repo, effecter.data(), effecter.size(),
+                                       0x01000001, true, 2);
+
+    // Only the first matching record in repo order changes
+    pldm_change_container_id_of_sensor(repo, 3, 7);
+    pldm_change_instance_number_of_sensor(repo, 3, 8);
+    pldm_change_container_id_of_effecter(repo, 4, 9);
+    pldm_change_instance_number_of_effecter(repo, 4, 10);
+
+    uint8_t* outData = nullptr;
+    uint32_t size{};
+    uint32_t nextRecHdl{};
+    ASSERT_NE(pldm_pdr_find_record(repo, remoteSensor, &outData, &size,
+                                   &nextRecHdl),
+              nullptr);
+    auto sensorOut = reinterpret_cast<pldm_state_sensor_pdr*>(outData);
+    EXPECT_EQ(sensorOut->container_id, 7);
+    EXPECT_EQ(sensorOut->entity_instance, 8);
+    ASSERT_NE(pldm_pdr_find_record(repo, localSensor, &outData, &size,
+                                   &nextRecHdl),
+              nullptr);
+    sensorOut = reinterpret_cast<pldm_state_sensor_pdr*>(outData);
+    EXPECT_EQ(sensorOut->container_id, 0);
+    EXPECT_EQ(sensorOut->entity_instance, 0);
+
+    ASSERT_NE(pldm_pdr_find_record(repo, localEffecter, &outData, &size,
+                                   &nextRecHdl),
+              nullptr);
+    auto effecterOut = reinterpret_cast<pldm_state_effecter_pdr*>(outData);
+    EXPECT_EQ(effecterOut->container_id, 9);
+    EXPECT_EQ(effecterOut->entity_instance, 10);
+    ASSERT_NE(pldm_pdr_find_record(repo, remoteEffecter, &outData, &size,
+                                   &nextRecHdl),
+              nullptr);
+    effecterOut = reinterpret_cast<pldm_state_effecter_pdr*>(outData);
+    EXPECT_EQ(effecterOut->container_id, 0);
+    EXPECT_EQ(effecterOut->entity_instance, 0);
+
+    pldm_pdr_destroy(repo);
+}
+
+TEST(PDRUpdate, testArena)
+{
+    // Small chunks, so that records spread over several of them
+    auto repo = pldm_pdr_init_arena(64);
+
+    std::array<uint8_t, sizeof(pldm_pdr_hdr) + 4> data{};
+    for (uint8_t i = 0; i < 5; ++i)
+    {
+        data.back() = i;
+        pldm_pdr_add(repo, data.data(), data.size(), 0, false, 1);
+        data.back() = 0x80 | i;
+        pldm_pdr_add(repo, data.data(), data.size(), 0, true, 2);
+    }
+    std::vector<uint8_t> big(200, 0xaa);
+    auto bigHandle = pldm_pdr_add(repo, big.data(), big.size(), 0, false, 1);
+    EXPECT_EQ(pldm_pdr_get_record_count(repo), 11u);
+
+    // Chunks never mix origins
+    size_t chunks = 0;
+    for (auto chunk = repo->arena; chunk; chunk = chunk->next)
+    {
+        ++chunks;
+        EXPECT_EQ(chunk->terminus_handle, chunk->is_remote ? 2 : 1);
+        EXPECT_LE(chunk->used, chunk->capacity);
+    }
+    EXPECT_GT(chunks, 2u);
+
+    uint8_t* outData = nullptr;
+    uint32_t size{};
+    uint32_t nextRecHdl{};
+    auto rec = pldm_pdr_find_record(repo, bigHandle, &outData, &size,
+                                    &nextRecHdl);
+    ASSERT_NE(rec, nullptr);
+    EXPECT_EQ(size, big.size());
+    EXPECT_EQ(outData[big.size() - 1], 0xaa);
+
+    pldm_delete_by_record_handle(repo, 2, true);
+    EXPECT_EQ(pldm_pdr_get_record_count(repo), 10u);
+
+    pldm_pdr_remove_remote_pdrs(repo);
+    EXPECT_EQ(pldm_pdr_get_record_count(repo), 6u);
+    for (auto chunk = repo->arena; chunk; chunk = chunk->next)
+    {
+        EXPECT_FALSE(chunk->is_remote);
+    }
+    for (uint32_t handle = 1; handle <= 5; ++handle)
+    {
+        rec = pldm_pdr_find_record(repo, handle, &outData, &size,
+                                   &nextRecHdl);
+        ASSERT_NE(rec, nullptr);
+        EXPECT_EQ(outData[size - 1], handle - 1);
+    }
+
+    pldm_pdr_remove_pdrs_by_terminus_handle(1, repo);
+    EXPECT_EQ(pldm_pdr_get_record_count(repo), 0u);
+    EXPECT_EQ(repo->arena, nullptr);
+
+    // Emptied chunks are gone, new records start a fresh one
+    pldm_pdr_add(repo, data.data(), data.size(), 0, true, 2);
+    EXPECT_EQ(pldm_pdr_get_record_count(repo), 1u);
+    ASSERT_NE(repo->arena, nullptr);
+    EXPECT_EQ(repo->arena->live_records, 1u);
+
+    pldm_pdr_destroy(repo);
+}
+
+TEST(PDRUpdate, testArenaReuse)
+{
+    auto repo = pldm_pdr_init_arena(4096);
+
+    // Keep a set of live host records of varying sizes and replace them in
+    // a scattered order, so that every chunk keeps some live records
+    std::array<uint8_t, sizeof(pldm_pdr_hdr) + 24> data{};
+    auto addRecord = [&](uint32_t i) {
+        return pldm_pdr_add(repo, data.data(),
+                            sizeof(pldm_pdr_hdr) + 8 * (i % 3 + 1), 0, true,
+                            2);
+    };
+    constexpr uint32_t live = 64;
+    std::vector<uint32_t> handles;
+    for (uint32_t i = 0; i < live; ++i)
+    {
+        handles.push_back(addRecord(i));
+    }
+    size_t maxChunks = 0;
+    std::minstd_rand random;
+    for (uint32_t i = live; i < 2000; ++i)
+    {
+        auto victim = random() % live;
+        pldm_delete_by_record_handle(repo, handles[victim], true);
+        handles[victim] = addRecord(i);
+
+        size_t chunks = 0;
+        for (auto chunk = repo->arena; chunk; chunk = chunk->next)
+        {
+            ++chunks;
+        }
+        maxChunks = std::max(maxChunks, chunks);
+    }
+    // Freed slots are reused, so the arena stays within a few chunks of the
+    // live data rather than one chunk per surviving record
+    EXPECT_EQ(pldm_pdr_get_record_count(repo), live);
+    EXPECT_LE(maxChunks, 6u);
+
+    pldm_pdr_destroy(repo);
+}
+
 TEST(PDRAccess, getPLDMEntityfromPDR)
 {
     auto repo = pldm_pdr_init();
@@ -1741,3 +2155,97 @@ TEST(EntityAssociationPDR, findAndAddHostPDR)
 
     pldm_entity_association_tree_destroy(tree);
 }
+
+TEST(EntityAssociationPDR, testDeleteNode)
+{
+    pldm_entity entities[5]{};
+    entities[0].entity_type = 1;
+    entities[1].entity_type = 2;
+    entities[2].entity_type = 3;
+    entities[3].entity_type = 4;
+    entities[4].entity_type = 5;
+
+    auto tree = pldm_entity_association_tree_init();
+    auto l1 = pldm_entity_association_tree_add(tree, &entities[0], 0xFFFF,
+                                               nullptr,
+                                               PLDM_ENTITY_ASSOCIAION_PHYSICAL,
+                                               false, true, 0xFFFF);
+    ASSERT_NE(l1, nullptr);
+    auto l2a = pldm_entity_association_tree_add(tree, &entities[1], 0xFFFF, l1,
+                                                PLDM_ENTITY_ASSOCIAION_PHYSICAL,
+                                                false, true, 0xFFFF);
+    ASSERT_NE(l2a, nullptr);
+    auto l2b = pldm_entity_association_tree_add(tree, &entities[2], 0xFFFF, l1,
+                                                PLDM_ENTITY_ASSOCIAION_PHYSICAL,
+                                                false, true, 0xFFFF);
+    ASSERT_NE(l2b, nullptr);
+    auto l3 = pldm_entity_association_tree_add(tree, &entities[3], 0xFFFF, l2a,
+                                               PLDM_ENTITY_ASSOCIAION_PHYSICAL,
+                                               false, true, 0xFFFF);
+    ASSERT_NE(l3, nullptr);
+    auto l4 = pldm_entity_association_tree_add(tree, &entities[4], 0xFFFF, l3,
+                                               PLDM_ENTITY_ASSOCIAION_PHYSICAL,
+                                               false, true, 0xFFFF);
+    ASSERT_NE(l4, nullptr);
+
+    pldm_entity_association_tree_delete_node(tree, entities[1]);
+
+    pldm_entity_node* node = nullptr;
+    pldm_find_entity_ref_in_tree(tree, entities[1], &node);
+    EXPECT_EQ(node, nullptr);
+    pldm_find_entity_ref_in_tree(tree, entities[4], &node);
+    EXPECT_EQ(node, nullptr);
+    pldm_entity entity = entities[3];
+    EXPECT_EQ(pldm_entity_association_tree_find(tree, &entity, false),
+              nullptr);
+    pldm_find_entity_ref_in_tree(tree, entities[2], &node);
+    EXPECT_EQ(node, l2b);
+
+    size_t num{};
+    pldm_entity* out = nullptr;
+    pldm_entity_association_tree_visit(tree, &out, &num);
+    EXPECT_EQ(num, 2u);
+    free(out);
+
+    pldm_entity_association_tree_destroy(tree);
+}
+
+TEST(EntityAssociationPDR, testDeepTree)
+{
+    constexpr size_t depth = 20000;
+
+    auto tree = pldm_entity_association_tree_init();
+    pldm_entity_node* parent = nullptr;
+    pldm_entity last{};
+    for (size_t i = 0; i < depth; ++i)
+    {
+        pldm_entity entity{};
+        entity.entity_type = 1 + (i % 100);
+        parent = pldm_entity_association_tree_add(
+            tree, &entity, 0xFFFF, parent, PLDM_ENTITY_ASSOCIAION_PHYSICAL,
+            false, true, 0xFFFF);
+        ASSERT_NE(parent, nullptr);
+        last = entity;
+    }
+
+    pldm_entity_node* node = nullptr;
+    pldm_find_entity_ref_in_tree(tree, last, &node);
+    EXPECT_EQ(node, parent);
+
+    auto copy = pldm_entity_association_tree_init();
+    pldm_entity_association_tree_copy_root(tree, copy);
+    size_t num{};
+    pldm_entity* out = nullptr;
+    pldm_entity_association_tree_visit(copy, &out, &num);
+    EXPECT_EQ(num, depth);
+    EXPECT_EQ(out[depth - 1].entity_container_id, last.entity_container_id);
+    free(out);
+
+    node = nullptr;
+    pldm_find_entity_ref_in_tree(copy, last, &node);
+    EXPECT_NE(node, nullptr);
+    EXPECT_NE(node, parent);
+
+    pldm_entity_association_tree_destroy(copy);
+    pldm_entity_association_tree_destroy(tree);
+}
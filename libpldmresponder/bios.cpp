@@ -286,8 +286,9 @@ Response Handler::getBIOSAttributeCurrentValueByHandle(const pldm_msg* request,
         return ccOnlyResponse(request, PLDM_BIOS_TABLE_UNAVAILABLE);
     }
 
-    auto entry = pldm_bios_table_attr_value_find_by_handle(
-        table->data(), table->size(), attributeHandle);
+    auto entry = pldm_bios_table_index_attr_value_find_by_handle(
+        biosConfig.getBIOSTableIndex(PLDM_BIOS_ATTR_VAL_TABLE),
+        attributeHandle);
     if (entry == nullptr)
     {
         return ccOnlyResponse(request, PLDM_INVALID_BIOS_ATTR_HANDLE);
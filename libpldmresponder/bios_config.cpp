@@ -38,6 +38,23 @@ constexpr auto stringTableFile = "stringTable";
 constexpr auto attrTableFile = "attributeTable";
 constexpr auto attrValueTableFile = "attributeValueTable";
 
+/** @brief How long table updates are gathered before they are persisted */
+constexpr auto persistDelay = std::chrono::seconds(1);
+
+const char* tableFile(pldm_bios_table_types tableType)
+{
+    switch (tableType)
+    {
+        case PLDM_BIOS_STRING_TABLE:
+            return stringTableFile;
+        case PLDM_BIOS_ATTR_TABLE:
+            return attrTableFile;
+        case PLDM_BIOS_ATTR_VAL_TABLE:
+            return attrValueTableFile;
+    }
+    return nullptr;
+}
+
 } // namespace
 
 BIOSConfig::BIOSConfig(
@@ -46,7 +63,9 @@ BIOSConfig::BIOSConfig(
     pldm::requester::Handler<pldm::requester::Request>* handler) :
     jsonDir(jsonDir),
     tableDir(tableDir), dbusHandler(dbusHandler), fd(fd), eid(eid),
-    requester(requester), handler(handler)
+    requester(requester), handler(handler),
+    persistTimer(sdeventplus::Event::get_default(),
+                 [this](auto&) { persistTables(); })
 
 {
     fs::create_directories(tableDir);
@@ -54,6 +73,11 @@ BIOSConfig::BIOSConfig(
     listenPendingAttributes();
 }
 
+BIOSConfig::~BIOSConfig()
+{
+    persistTables();
+}
+
 void BIOSConfig::buildTables()
 {
     auto stringTable = buildAndStoreStringTable();
@@ -63,31 +87,44 @@ void BIOSConfig::buildTables()
     }
 }
 
-std::optional<Table> BIOSConfig::getBIOSTable(pldm_bios_table_types tableType)
+const Table* BIOSConfig::getBIOSTable(pldm_bios_table_types tableType)
 {
-    fs::path tablePath;
-    switch (tableType)
+    auto file = tableFile(tableType);
+    if (!file)
     {
-        case PLDM_BIOS_STRING_TABLE:
-            tablePath = tableDir / stringTableFile;
-            break;
-        case PLDM_BIOS_ATTR_TABLE:
-            tablePath = tableDir / attrTableFile;
-            break;
-        case PLDM_BIOS_ATTR_VAL_TABLE:
-            tablePath = tableDir / attrValueTableFile;
-            break;
+        return nullptr;
+    }
+
+    auto& resident = tables[tableType];
+    if (!resident.loaded)
+    {
+        resident.table = loadTable(tableDir / file);
+        resident.loaded = true;
+    }
+    return resident.table ? &*resident.table : nullptr;
+}
+
+const pldm_bios_table_index*
+    BIOSConfig::getBIOSTableIndex(pldm_bios_table_types tableType)
+{
+    auto table = getBIOSTable(tableType);
+    if (!table)
+    {
+        return nullptr;
+    }
+
+    auto& resident = tables[tableType];
+    if (!resident.index)
+    {
+        resident.index.reset(pldm_bios_table_index_create(
+            table->data(), table->size(), tableType));
     }
-    return loadTable(tablePath);
+    return resident.index.get();
 }
 
 int BIOSConfig::setBIOSTable(uint8_t tableType, const Table& table,
                              bool updateBaseBIOSTable)
 {
-    fs::path stringTablePath(tableDir / stringTableFile);
-    fs::path attrTablePath(tableDir / attrTableFile);
-    fs::path attrValueTablePath(tableDir / attrValueTableFile);
-
     if (!pldm_bios_table_checksum(table.data(), table.size()))
     {
         return PLDM_INVALID_BIOS_TABLE_DATA_INTEGRITY_CHECK;
@@ -95,12 +132,11 @@ int BIOSConfig::setBIOSTable(uint8_t tableType, const Table& table,
 
     if (tableType == PLDM_BIOS_STRING_TABLE)
     {
-        storeTable(stringTablePath, table);
+        storeTable(PLDM_BIOS_STRING_TABLE, table);
     }
     else if (tableType == PLDM_BIOS_ATTR_TABLE)
     {
-        BIOSTable biosStringTable(stringTablePath.c_str());
-        if (biosStringTable.isEmpty())
+        if (!getBIOSTable(PLDM_BIOS_STRING_TABLE))
         {
             return PLDM_INVALID_BIOS_TABLE_TYPE;
         }
@@ -111,13 +147,12 @@ int BIOSConfig::setBIOSTable(uint8_t tableType, const Table& table,
             return rc;
         }
 
-        storeTable(attrTablePath, table);
+        storeTable(PLDM_BIOS_ATTR_TABLE, table);
     }
     else if (tableType == PLDM_BIOS_ATTR_VAL_TABLE)
     {
-        BIOSTable biosStringTable(stringTablePath.c_str());
-        BIOSTable biosStringValueTable(attrTablePath.c_str());
-        if (biosStringTable.isEmpty() || biosStringValueTable.isEmpty())
+        if (!getBIOSTable(PLDM_BIOS_STRING_TABLE) ||
+            !getBIOSTable(PLDM_BIOS_ATTR_TABLE))
         {
             return PLDM_INVALID_BIOS_TABLE_TYPE;
         }
@@ -128,7 +163,7 @@ int BIOSConfig::setBIOSTable(uint8_t tableType, const Table& table,
             return rc;
         }
 
-        storeTable(attrValueTablePath, table);
+        storeTable(PLDM_BIOS_ATTR_VAL_TABLE, table);
     }
     else
     {
@@ -219,8 +254,8 @@ int BIOSConfig::checkAttributeTable(const Table& table)
 int BIOSConfig::checkAttributeValueTable(const Table& table)
 {
     using namespace pldm::bios::utils;
-    auto stringTable = getBIOSTable(PLDM_BIOS_STRING_TABLE);
-    auto attrTable = getBIOSTable(PLDM_BIOS_ATTR_TABLE);
+    auto stringIndex = getBIOSTableIndex(PLDM_BIOS_STRING_TABLE);
+    auto attrIndex = getBIOSTableIndex(PLDM_BIOS_ATTR_TABLE);
 
     baseBIOSTableMaps.clear();
 
@@ -243,8 +278,8 @@ int BIOSConfig::checkAttributeValueTable(const Table& table)
         auto attrType = static_cast<pldm_bios_attribute_type>(
             pldm_bios_table_attr_value_entry_decode_attribute_type(tableEntry));
 
-        auto attrEntry = pldm_bios_table_attr_find_by_handle(
-            attrTable->data(), attrTable->size(), attrValueHandle);
+        auto attrEntry = pldm_bios_table_index_attr_find_by_handle(
+            attrIndex, attrValueHandle);
         if (attrEntry == nullptr)
         {
             return PLDM_INVALID_BIOS_ATTR_HANDLE;
@@ -254,8 +289,8 @@ int BIOSConfig::checkAttributeValueTable(const Table& table)
         auto attrNameHandle =
             pldm_bios_table_attr_entry_decode_string_handle(attrEntry);
 
-        auto stringEntry = pldm_bios_table_string_find_by_handle(
-            stringTable->data(), stringTable->size(), attrNameHandle);
+        auto stringEntry = pldm_bios_table_index_string_find_by_handle(
+            stringIndex, attrNameHandle);
         if (stringEntry == nullptr)
         {
             return PLDM_INVALID_BIOS_ATTR_HANDLE;
@@ -282,10 +317,12 @@ int BIOSConfig::checkAttributeValueTable(const Table& table)
             case PLDM_BIOS_ENUMERATION:
             case PLDM_BIOS_ENUMERATION_READ_ONLY:
             {
-                auto getValue = [](uint16_t handle,
-                                   const Table& table) -> std::string {
-                    auto stringEntry = pldm_bios_table_string_find_by_handle(
-                        table.data(), table.size(), handle);
+                auto getValue =
+                    [](uint16_t handle,
+                       const pldm_bios_table_index* index) -> std::string {
+                    auto stringEntry =
+                        pldm_bios_table_index_string_find_by_handle(index,
+                                                                    handle);
 
                     auto strLength =
                         pldm_bios_table_string_entry_decode_string_length(
@@ -313,7 +350,7 @@ int BIOSConfig::checkAttributeValueTable(const Table& table)
                     options.push_back(
                         std::make_tuple("xyz.openbmc_project.BIOSConfig."
                                         "Manager.BoundType.OneOf",
-                                        getValue(pvHandls[i], *stringTable)));
+                                        getValue(pvHandls[i], stringIndex)));
                 }
 
                 auto count =
@@ -326,7 +363,7 @@ int BIOSConfig::checkAttributeValueTable(const Table& table)
                 // get current_value
                 for (size_t i = 0; i < handles.size(); i++)
                 {
-                    currentValue = getValue(pvHandls[handles[i]], *stringTable);
+                    currentValue = getValue(pvHandls[handles[i]], stringIndex);
                 }
 
                 auto defNum =
@@ -339,7 +376,7 @@ int BIOSConfig::checkAttributeValueTable(const Table& table)
                 for (size_t i = 0; i < defIndices.size(); i++)
                 {
                     defaultValue =
-                        getValue(pvHandls[defIndices[i]], *stringTable);
+                        getValue(pvHandls[defIndices[i]], stringIndex);
                 }
 
                 break;
@@ -597,10 +634,26 @@ std::optional<Table> BIOSConfig::buildAndStoreStringTable()
     return table;
 }
 
-void BIOSConfig::storeTable(const fs::path& path, const Table& table)
+void BIOSConfig::storeTable(pldm_bios_table_types tableType,
+                            const Table& table)
 {
-    BIOSTable biosTable(path.c_str());
-    biosTable.store(table);
+    auto& resident = tables[tableType];
+    resident.table = table;
+    resident.loaded = true;
+    resident.index.reset();
+    tableChanged(tableType);
+}
+
+void BIOSConfig::tableChanged(pldm_bios_table_types tableType)
+{
+    tables[tableType].dirty = true;
+
+    // The first update arms the timer, the ones following it before it
+    // expires are written along with it
+    if (!persistTimer.isEnabled())
+    {
+        persistTimer.restartOnce(persistDelay);
+    }
 }
 
 std::optional<Table> BIOSConfig::loadTable(const fs::path& path)
@@ -616,6 +669,34 @@ std::optional<Table> BIOSConfig::loadTable(const fs::path& path)
     return table;
 }
 
+void BIOSConfig::persistTables()
+{
+    persistTimer.setEnabled(false);
+    for (size_t type = 0; type < numTables; ++type)
+    {
+        auto& resident = tables[type];
+        if (!resident.dirty)
+        {
+            continue;
+        }
+
+        auto path =
+            tableDir / tableFile(static_cast<pldm_bios_table_types>(type));
+        try
+        {
+            BIOSTable biosTable(path.c_str());
+            biosTable.store(*resident.table);
+            resident.dirty = false;
+        }
+        catch (const std::exception& e)
+        {
+            // Stays dirty, the next update of any table retries it
+            std::cerr << "Failed to persist BIOS table, PATH=" << path
+                      << " ERROR=" << e.what() << "\n";
+        }
+    }
+}
+
 void BIOSConfig::load(const fs::path& filePath, ParseHandler handler)
 {
     std::ifstream file;
@@ -651,7 +732,7 @@ void BIOSConfig::load(const fs::path& filePath, ParseHandler handler)
 
 int BIOSConfig::checkAttrValueToUpdate(
     const pldm_bios_attr_val_table_entry* attrValueEntry,
-    const pldm_bios_attr_table_entry* attrEntry, Table&)
+    const pldm_bios_attr_table_entry* attrEntry, const Table&)
 
 {
     auto [attrHandle, attrType] =
@@ -733,8 +814,8 @@ int BIOSConfig::setAttrValue(const void* entry, size_t size, bool updateDBus,
 
     auto attrValHeader = table::attribute_value::decodeHeader(attrValueEntry);
 
-    auto attrEntry =
-        table::attribute::findByHandle(*attrTable, attrValHeader.attrHandle);
+    auto attrEntry = pldm_bios_table_index_attr_find_by_handle(
+        getBIOSTableIndex(PLDM_BIOS_ATTR_TABLE), attrValHeader.attrHandle);
     if (!attrEntry)
     {
         return PLDM_ERROR;
@@ -746,20 +827,41 @@ int BIOSConfig::setAttrValue(const void* entry, size_t size, bool updateDBus,
         return rc;
     }
 
-    auto destTable =
-        table::attribute_value::updateTable(*attrValueTable, entry, size);
-
-    if (!destTable)
+    // A value which keeps the length of the entry it replaces, as enum and
+    // integer values always do, is patched into the resident table
+    auto attrValueIndex = getBIOSTableIndex(PLDM_BIOS_ATTR_VAL_TABLE);
+    auto currentEntry = pldm_bios_table_index_attr_value_find_by_handle(
+        attrValueIndex, attrValHeader.attrHandle);
+    if (currentEntry && currentEntry->attr_type != attrValHeader.attrType)
     {
         return PLDM_ERROR;
     }
+    bool inPlace =
+        currentEntry &&
+        pldm_bios_table_attr_value_entry_length(currentEntry) == size;
+
+    std::optional<Table> destTable;
+    if (!inPlace)
+    {
+        destTable =
+            table::attribute_value::updateTable(*attrValueTable, entry, size);
+        if (!destTable)
+        {
+            return PLDM_ERROR;
+        }
+    }
 
     try
     {
         auto attrHeader = table::attribute::decodeHeader(attrEntry);
 
-        BIOSStringTable biosStringTable(*stringTable);
-        auto attrName = biosStringTable.findString(attrHeader.stringHandle);
+        auto stringEntry = pldm_bios_table_index_string_find_by_handle(
+            getBIOSTableIndex(PLDM_BIOS_STRING_TABLE), attrHeader.stringHandle);
+        if (!stringEntry)
+        {
+            throw std::invalid_argument("Invalid String Handle");
+        }
+        auto attrName = table::string::decodeString(stringEntry);
 
         auto iter = std::find_if(
             biosAttributes.begin(), biosAttributes.end(),
@@ -771,6 +873,7 @@ int BIOSConfig::setAttrValue(const void* entry, size_t size, bool updateDBus,
         }
         if (updateDBus)
         {
+            BIOSStringTable biosStringTable(*stringTable);
             (*iter)->setAttrValueOnDbus(attrValueEntry, attrEntry,
                                         biosStringTable);
         }
@@ -781,13 +884,172 @@ int BIOSConfig::setAttrValue(const void* entry, size_t size, bool updateDBus,
         return PLDM_ERROR;
     }
 
-    setBIOSTable(PLDM_BIOS_ATTR_VAL_TABLE, *destTable, updateBaseBIOSTable);
+    if (!inPlace)
+    {
+        setBIOSTable(PLDM_BIOS_ATTR_VAL_TABLE, *destTable, updateBaseBIOSTable);
+        return PLDM_SUCCESS;
+    }
+
+    // The entry keeps its offset and handle, the index stays valid
+    auto& resident = *tables[PLDM_BIOS_ATTR_VAL_TABLE].table;
+    currentEntry = pldm_bios_table_index_attr_value_find_by_handle(
+        attrValueIndex, attrValHeader.attrHandle);
+    if (!table::attribute_value::updateTableInPlace(resident, currentEntry,
+                                                    entry, size))
+    {
+        return PLDM_ERROR;
+    }
+    tableChanged(PLDM_BIOS_ATTR_VAL_TABLE);
+
+    checkAttributeValueTable(resident);
+    if (updateBaseBIOSTable)
+    {
+        updateBaseBIOSTableProperty();
+    }
+
+    return PLDM_SUCCESS;
+}
+
+int BIOSConfig::setAttrValues(const std::vector<Table>& entries)
+{
+    auto attrValueTable = getBIOSTable(PLDM_BIOS_ATTR_VAL_TABLE);
+    auto stringTable = getBIOSTable(PLDM_BIOS_STRING_TABLE);
+    auto attrIndex = getBIOSTableIndex(PLDM_BIOS_ATTR_TABLE);
+    auto attrValueIndex = getBIOSTableIndex(PLDM_BIOS_ATTR_VAL_TABLE);
+    auto stringIndex = getBIOSTableIndex(PLDM_BIOS_STRING_TABLE);
+    if (!attrValueTable || !stringTable || !attrIndex || !attrValueIndex ||
+        !stringIndex)
+    {
+        return PLDM_BIOS_TABLE_UNAVAILABLE;
+    }
+
+    struct Update
+    {
+        const pldm_bios_attr_val_table_entry* attrValueEntry;
+        const pldm_bios_attr_table_entry* attrEntry;
+        BIOSAttribute* attribute;
+    };
+    std::map<uint16_t, Update> updates;
+
+    for (const auto& entry : entries)
+    {
+        if (entry.size() < sizeof(pldm_bios_attr_val_table_entry))
+        {
+            return PLDM_ERROR_INVALID_LENGTH;
+        }
+        auto attrValueEntry =
+            reinterpret_cast<const pldm_bios_attr_val_table_entry*>(
+                entry.data());
+        auto [attrHandle, attrType] =
+            table::attribute_value::decodeHeader(attrValueEntry);
+
+        auto attrEntry =
+            pldm_bios_table_index_attr_find_by_handle(attrIndex, attrHandle);
+        auto currentEntry = pldm_bios_table_index_attr_value_find_by_handle(
+            attrValueIndex, attrHandle);
+        if (!attrEntry || !currentEntry)
+        {
+            return PLDM_ERROR;
+        }
+        if (currentEntry->attr_type != attrType)
+        {
+            return PLDM_ERROR_INVALID_DATA;
+        }
+        if (pldm_bios_table_attr_value_entry_length(attrValueEntry) >
+            entry.size())
+        {
+            return PLDM_ERROR_INVALID_LENGTH;
+        }
+
+        auto rc = checkAttrValueToUpdate(attrValueEntry, attrEntry,
+                                         *stringTable);
+        if (rc != PLDM_SUCCESS)
+        {
+            return rc;
+        }
+
+        auto attrHeader = table::attribute::decodeHeader(attrEntry);
+        auto stringEntry = pldm_bios_table_index_string_find_by_handle(
+            stringIndex, attrHeader.stringHandle);
+        if (!stringEntry)
+        {
+            return PLDM_ERROR;
+        }
+        auto attrName = table::string::decodeString(stringEntry);
+        auto iter = std::find_if(
+            biosAttributes.begin(), biosAttributes.end(),
+            [&attrName](const auto& attr) { return attr->name == attrName; });
+        if (iter == biosAttributes.end())
+        {
+            return PLDM_ERROR;
+        }
+
+        updates.insert_or_assign(
+            attrHandle, Update{attrValueEntry, attrEntry, iter->get()});
+    }
+
+    if (updates.empty())
+    {
+        return PLDM_SUCCESS;
+    }
+
+    // Rebuild the attribute value table in a single pass over it
+    using namespace pldm::bios::utils;
+    Table destTable;
+    destTable.reserve(attrValueTable->size());
+    for (auto entry : BIOSTableIter<PLDM_BIOS_ATTR_VAL_TABLE>(
+             attrValueTable->data(), attrValueTable->size()))
+    {
+        auto it = updates.find(
+            table::attribute_value::decodeHeader(entry).attrHandle);
+        if (it != updates.end())
+        {
+            entry = it->second.attrValueEntry;
+        }
+        auto p = reinterpret_cast<const uint8_t*>(entry);
+        destTable.insert(destTable.end(), p,
+                         p + pldm_bios_table_attr_value_entry_length(entry));
+    }
+    table::appendPadAndChecksum(destTable);
+
+    // The table is validated and committed before any value is published,
+    // D-Bus never shows a value the table turned down
+    auto rc = setBIOSTable(PLDM_BIOS_ATTR_VAL_TABLE, destTable, false);
+    if (rc != PLDM_SUCCESS)
+    {
+        return rc;
+    }
+
+    // The table holds the values from now on, a value D-Bus fails to take
+    // does not hold back the others
+    BIOSStringTable biosStringTable(*stringTable);
+    for (const auto& [attrHandle, update] : updates)
+    {
+        try
+        {
+            update.attribute->setAttrValueOnDbus(
+                update.attrValueEntry, update.attrEntry, biosStringTable);
+        }
+        catch (const std::exception& e)
+        {
+            std::cerr << "Set attribute values error, handle = " << attrHandle
+                      << ", " << e.what() << std::endl;
+        }
+    }
+    updateBaseBIOSTableProperty();
 
     return PLDM_SUCCESS;
 }
 
 void BIOSConfig::removeTables()
 {
+    persistTimer.setEnabled(false);
+    for (auto& resident : tables)
+    {
+        resident = ResidentTable{};
+        resident.loaded = true;
+    }
+
     try
     {
         fs::remove(tableDir / stringTableFile);
@@ -814,33 +1076,31 @@ void BIOSConfig::processBiosAttrChangeNotification(
     }
 
     PropertyValue newPropVal = it->second;
-    auto stringTable = getBIOSTable(PLDM_BIOS_STRING_TABLE);
-    if (!stringTable.has_value())
+    auto stringIndex = getBIOSTableIndex(PLDM_BIOS_STRING_TABLE);
+    if (!stringIndex)
     {
         std::cerr << "BIOS string table unavailable\n";
         return;
     }
-    BIOSStringTable biosStringTable(*stringTable);
-    uint16_t attrNameHdl{};
-    try
-    {
-        attrNameHdl = biosStringTable.findHandle(attrName);
-    }
-    catch (const std::invalid_argument& e)
+    auto stringEntry = pldm_bios_table_index_string_find_by_string(
+        stringIndex, attrName.c_str());
+    if (stringEntry == nullptr)
     {
         std::cerr << "Could not find handle for BIOS string, ATTRIBUTE="
                   << attrName.c_str() << "\n";
         return;
     }
+    uint16_t attrNameHdl = table::string::decodeHandle(stringEntry);
 
-    auto attrTable = getBIOSTable(PLDM_BIOS_ATTR_TABLE);
-    if (!attrTable.has_value())
+    auto attrIndex = getBIOSTableIndex(PLDM_BIOS_ATTR_TABLE);
+    if (!attrIndex)
     {
         std::cerr << "Attribute table not present\n";
         return;
     }
     const struct pldm_bios_attr_table_entry* tableEntry =
-        table::attribute::findByStringHandle(*attrTable, attrNameHdl);
+        pldm_bios_table_index_attr_find_by_string_handle(attrIndex,
+                                                         attrNameHdl);
     if (tableEntry == nullptr)
     {
         std::cerr << "Attribute not found in attribute table, name= "
@@ -853,7 +1113,7 @@ void BIOSConfig::processBiosAttrChangeNotification(
 
     auto attrValueSrcTable = getBIOSTable(PLDM_BIOS_ATTR_VAL_TABLE);
 
-    if (!attrValueSrcTable.has_value())
+    if (!attrValueSrcTable)
     {
         std::cerr << "Attribute value table not present\n";
         return;
@@ -873,7 +1133,7 @@ void BIOSConfig::processBiosAttrChangeNotification(
         *attrValueSrcTable, newValue.data(), newValue.size());
     if (destTable.has_value())
     {
-        storeTable(tableDir / attrValueTableFile, *destTable);
+        storeTable(PLDM_BIOS_ATTR_VAL_TABLE, *destTable);
     }
 
     rc = setAttrValue(newValue.data(), newValue.size(), false);
@@ -886,32 +1146,33 @@ void BIOSConfig::processBiosAttrChangeNotification(
 
 uint16_t BIOSConfig::findAttrHandle(const std::string& attrName)
 {
-    auto stringTable = getBIOSTable(PLDM_BIOS_STRING_TABLE);
-    auto attrTable = getBIOSTable(PLDM_BIOS_ATTR_TABLE);
-
-    BIOSStringTable biosStringTable(*stringTable);
-    pldm::bios::utils::BIOSTableIter<PLDM_BIOS_ATTR_TABLE> attrTableIter(
-        attrTable->data(), attrTable->size());
-    auto stringHandle = biosStringTable.findHandle(attrName);
+    auto stringEntry = pldm_bios_table_index_string_find_by_string(
+        getBIOSTableIndex(PLDM_BIOS_STRING_TABLE), attrName.c_str());
+    if (stringEntry == nullptr)
+    {
+        throw std::invalid_argument("Invalid String Name");
+    }
 
-    for (auto entry : pldm::bios::utils::BIOSTableIter<PLDM_BIOS_ATTR_TABLE>(
-             attrTable->data(), attrTable->size()))
+    auto attrEntry = pldm_bios_table_index_attr_find_by_string_handle(
+        getBIOSTableIndex(PLDM_BIOS_ATTR_TABLE),
+        table::string::decodeHandle(stringEntry));
+    if (attrEntry == nullptr)
     {
-        auto header = table::attribute::decodeHeader(entry);
-        if (header.stringHandle == stringHandle)
-        {
-            return header.attrHandle;
-        }
+        throw std::invalid_argument("Unknow attribute Name");
     }
 
-    throw std::invalid_argument("Unknow attribute Name");
+    return table::attribute::decodeHeader(attrEntry).attrHandle;
 }
 
 void BIOSConfig::constructPendingAttribute(
     const PendingAttributes& pendingAttributes)
 {
     std::vector<uint16_t> listOfHandles{};
+    std::vector<Table> attrValueEntries{};
+    attrValueEntries.reserve(pendingAttributes.size());
 
+    // The pending attributes are applied as one transaction, a single bad
+    // attribute rejects all of them
     for (auto& attribute : pendingAttributes)
     {
         std::string attributeName = attribute.first;
@@ -926,14 +1187,26 @@ void BIOSConfig::constructPendingAttribute(
         {
             std::cerr << "Wrong attribute name, attributeName = "
                       << attributeName << std::endl;
-            continue;
+            return;
         }
 
         Table attrValueEntry(sizeof(pldm_bios_attr_val_table_entry), 0);
         auto entry = reinterpret_cast<pldm_bios_attr_val_table_entry*>(
             attrValueEntry.data());
 
-        auto handler = findAttrHandle(attributeName);
+        uint16_t handler{};
+        try
+        {
+            handler = findAttrHandle(attributeName);
+        }
+        catch (const std::invalid_argument& e)
+        {
+            std::cerr << "Could not find handle for BIOS attribute, "
+                         "attributeName = "
+                      << attributeName << std::endl;
+            return;
+        }
+
         auto type =
             BIOSConfigManager::convertAttributeTypeFromString(attributeType);
 
@@ -943,7 +1216,7 @@ void BIOSConfig::constructPendingAttribute(
         {
             std::cerr << "Attribute type not supported, attributeType = "
                       << attributeType << std::endl;
-            continue;
+            return;
         }
 
         const auto [attrType, readonlyStatus, displayName, description,
@@ -960,13 +1233,21 @@ void BIOSConfig::constructPendingAttribute(
 
         (*iter)->generateAttributeEntry(attributevalue, attrValueEntry);
 
-        setAttrValue(attrValueEntry.data(), attrValueEntry.size());
+        attrValueEntries.emplace_back(std::move(attrValueEntry));
+    }
+
+    auto rc = setAttrValues(attrValueEntries);
+    if (rc != PLDM_SUCCESS)
+    {
+        std::cerr << "Failed to apply the pending attributes, rc = " << rc
+                  << std::endl;
+        return;
     }
 
     if (listOfHandles.size())
     {
 #ifdef OEM_IBM
-        auto rc = pldm::responder::platform::sendBiosAttributeUpdateEvent(
+        rc = pldm::responder::platform::sendBiosAttributeUpdateEvent(
             eid, requester, listOfHandles, handler);
         if (rc != PLDM_SUCCESS)
         {
@@ -8,7 +8,9 @@
 #include "requester/handler.hpp"
 
 #include <nlohmann/json.hpp>
+#include <sdeventplus/utility/timer.hpp>
 
+#include <array>
 #include <functional>
 #include <iostream>
 #include <memory>
@@ -64,7 +66,9 @@ class BIOSConfig
     BIOSConfig(BIOSConfig&&) = delete;
     BIOSConfig& operator=(const BIOSConfig&) = delete;
     BIOSConfig& operator=(BIOSConfig&&) = delete;
-    ~BIOSConfig() = default;
+
+    /** @brief Persist the tables changed since the last write-behind */
+    ~BIOSConfig();
 
     /** @brief Construct BIOSConfig
      *  @param[in] jsonDir - The directory where json file exists
@@ -93,17 +97,48 @@ class BIOSConfig
     int setAttrValue(const void* entry, size_t size, bool updateDBus = true,
                      bool updateBaseBIOSTable = true);
 
-    /** @brief Remove the persistent tables */
+    /** @brief Set a batch of attribute values on dbus and attribute value
+     *         table
+     *
+     *  Every entry is validated before any of them is applied, then the
+     *  attribute value table is rebuilt, persisted and published once for
+     *  the whole batch. The values go to dbus only once the table holds
+     *  them, a value dbus fails to take is logged.
+     *
+     *  @param[in] entries - attribute value entries, a later entry for an
+     *                       attribute replaces an earlier one
+     *  @return pldm_completion_codes, nothing is applied unless it is
+     *          PLDM_SUCCESS
+     */
+    int setAttrValues(const std::vector<Table>& entries);
+
+    /** @brief Remove the persistent tables and drop the resident ones */
     void removeTables();
 
     /** @brief Build bios tables(string,attribute,attribute value table)*/
     void buildTables();
 
     /** @brief Get BIOS table of specified type
+     *
+     *  The table is served from memory, the persisted table is only read
+     *  the first time it is needed.
+     *
+     *  @param[in] tableType - The table type
+     *  @return Pointer to the bios table, nullptr if the table is unavailable.
+     *          The pointer is invalidated by any update of the table.
+     */
+    const Table* getBIOSTable(pldm_bios_table_types tableType);
+
+    /** @brief Get the lookup index of the BIOS table of specified type
+     *
+     *  The index is built on first use after the table changes.
+     *
      *  @param[in] tableType - The table type
-     *  @return The bios table, std::nullopt if the table is unaviliable
+     *  @return Pointer to the index, nullptr if the table is unavailable.
+     *          The pointer is invalidated by any update of the table.
      */
-    std::optional<Table> getBIOSTable(pldm_bios_table_types tableType);
+    const pldm_bios_table_index*
+        getBIOSTableIndex(pldm_bios_table_types tableType);
 
     /** @brief set BIOS table
      *  @param[in] tableType - Indicates what table is being transferred
@@ -233,11 +268,16 @@ class BIOSConfig
      */
     void buildAndStoreAttrTables(const Table& stringTable);
 
-    /** @brief Persist the table
-     *  @param[in] path - Path to persist the table
+    /** @brief Update the resident table and schedule persisting it
+     *  @param[in] tableType - The table type
      *  @param[in] table - The table
      */
-    void storeTable(const fs::path& path, const Table& table);
+    void storeTable(pldm_bios_table_types tableType, const Table& table);
+
+    /** @brief Schedule persisting a resident table changed in place
+     *  @param[in] tableType - The table type
+     */
+    void tableChanged(pldm_bios_table_types tableType);
 
     /** @brief Load bios table to ram
      *  @param[in] path - Path of the table
@@ -245,6 +285,35 @@ class BIOSConfig
      */
     std::optional<Table> loadTable(const fs::path& path);
 
+    /** @brief Write the tables changed in memory to their files */
+    void persistTables();
+
+    /** @brief Number of BIOS table types, string/attribute/attribute value */
+    static constexpr size_t numTables = PLDM_BIOS_ATTR_VAL_TABLE + 1;
+
+    /** @brief A BIOS table kept in memory */
+    struct ResidentTable
+    {
+        /** @brief The table, std::nullopt if there is none */
+        std::optional<Table> table;
+        /** @brief The persisted table has been read into table */
+        bool loaded = false;
+        /** @brief table changed since it was last persisted */
+        bool dirty = false;
+        /** @brief Lookup index over table, nullptr until first needed */
+        std::unique_ptr<pldm_bios_table_index,
+                        decltype(&pldm_bios_table_index_free)>
+            index{nullptr, pldm_bios_table_index_free};
+    };
+
+    /** @brief The tables, indexed by pldm_bios_table_types */
+    std::array<ResidentTable, numTables> tables;
+
+    /** @brief Coalesces the table updates made in a short window into a
+     *         single write of each changed table
+     */
+    sdeventplus::utility::Timer<sdeventplus::ClockId::Monotonic> persistTimer;
+
     /** @brief Check the attribute value to update
      *  @param[in] attrValueEntry - The attribute value entry to update
      *  @param[in] attrEntry - The attribute table entry
@@ -253,7 +322,7 @@ class BIOSConfig
      */
     int checkAttrValueToUpdate(
         const pldm_bios_attr_val_table_entry* attrValueEntry,
-        const pldm_bios_attr_table_entry* attrEntry, Table& stringTable);
+        const pldm_bios_attr_table_entry* attrEntry, const Table& stringTable);
 
     /** @brief Check the attribute table
      *  @param[in] table - The table
@@ -2,7 +2,12 @@
 
 #include "bios_table.h"
 
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <cerrno>
 #include <fstream>
+#include <system_error>
 
 namespace pldm
 {
@@ -32,8 +37,61 @@ bool BIOSTable::isEmpty() const noexcept
 
 void BIOSTable::store(const Table& table)
 {
-    std::ofstream stream(filePath.string(), std::ios::out | std::ios::binary);
-    stream.write(reinterpret_cast<const char*>(table.data()), table.size());
+    // Write a sibling file and rename it over the table, so that a crash or
+    // power loss leaves either the old or the new table behind, never a torn
+    // one
+    auto tmpPath = filePath;
+    tmpPath += ".tmp";
+
+    int fd = open(tmpPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC,
+                  S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH);
+    if (fd < 0)
+    {
+        throw std::system_error(errno, std::generic_category(),
+                                "open " + tmpPath.string());
+    }
+
+    auto data = table.data();
+    size_t left = table.size();
+    while (left)
+    {
+        auto n = write(fd, data, left);
+        if (n < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (n < 0)
+        {
+            auto err = errno;
+            close(fd);
+            fs::remove(tmpPath);
+            throw std::system_error(err, std::generic_category(),
+                                    "write " + tmpPath.string());
+        }
+        data += n;
+        left -= n;
+    }
+
+    if (fsync(fd) < 0)
+    {
+        auto err = errno;
+        close(fd);
+        fs::remove(tmpPath);
+        throw std::system_error(err, std::generic_category(),
+                                "fsync " + tmpPath.string());
+    }
+    close(fd);
+
+    fs::rename(tmpPath, filePath);
+
+    // Make the rename itself durable
+    int dirFd = open(filePath.parent_path().c_str(),
+                     O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (dirFd >= 0)
+    {
+        fsync(dirFd);
+        close(dirFd);
+    }
 }
 
 void BIOSTable::load(Response& response) const
@@ -333,6 +391,15 @@ std::optional<Table> updateTable(const Table& table, const void* entry,
     return destTable;
 }
 
+bool updateTableInPlace(Table& table,
+                        const pldm_bios_attr_val_table_entry* tableEntry,
+                        const void* entry, size_t size)
+{
+    return pldm_bios_table_attr_value_entry_update_in_place(
+               table.data(), table.size(), tableEntry, entry, size) ==
+           PLDM_SUCCESS;
+}
+
 } // namespace attribute_value
 
 } // namespace table
@@ -57,8 +57,13 @@ class BIOSTable
     bool isEmpty() const noexcept;
 
     /** @brief Persist a BIOS table(string/attribute/attribute value)
+     *
+     *  The table is written to a temporary file, synced and renamed over
+     *  the persisted table.
      *
      *  @param[in] table - BIOS table
+     *  @throw std::system_error or fs::filesystem_error if the table can't
+     *         be written, the persisted table is left untouched
      */
     void store(const Table& table);
 
@@ -370,6 +375,18 @@ const pldm_bios_attr_val_table_entry*
 std::optional<Table> updateTable(const Table& table, const void* entry,
                                  size_t size);
 
+/** @brief replace an entry of a table in place
+ *  @param[in,out] table - the table need to be updated
+ *  @param[in] tableEntry - the entry of the table to be replaced
+ *  @param[in] entry - the new attribute value entry
+ *  @param[in] size - size of the new entry
+ *  @return true if the entry is replaced, false if the new entry doesn't fit
+ *          in place of the old one, the table is left unchanged then
+ */
+bool updateTableInPlace(Table& table,
+                        const pldm_bios_attr_val_table_entry* tableEntry,
+                        const void* entry, size_t size);
+
 } // namespace attribute_value
 
 } // namespace table
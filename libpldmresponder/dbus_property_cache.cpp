@@ -0,0 +1,118 @@
+#include "dbus_property_cache.hpp"
+
+#include <vector>
+
+namespace pldm::responder
+{
+
+namespace rules = sdbusplus::bus::match::rules;
+using namespace pldm::utils;
+
+DbusPropertyCache::DbusPropertyCache()
+{
+    nameOwnerChanged = std::make_unique<sdbusplus::bus::match::match>(
+        DBusHandler::getBus(), rules::nameOwnerChanged(),
+        [this](sdbusplus::message::message& msg) {
+            std::string name;
+            std::string oldOwner;
+            std::string newOwner;
+            msg.read(name, oldOwner, newOwner);
+            // Unique names come and go with every client connection, only a
+            // service owning a well known name can own sensor properties
+            if (name.empty() || name[0] == ':' || oldOwner.empty())
+            {
+                return;
+            }
+            for (auto& [key, interface] : interfaces)
+            {
+                interface.values.clear();
+            }
+        });
+    interfacesRemoved = std::make_unique<sdbusplus::bus::match::match>(
+        DBusHandler::getBus(), rules::interfacesRemoved(),
+        [this](sdbusplus::message::message& msg) {
+            sdbusplus::message::object_path path;
+            std::vector<std::string> removed;
+            msg.read(path, removed);
+            // The watch goes with the values, a sensor read watches the
+            // interface again if it comes back
+            for (const auto& interface : removed)
+            {
+                interfaces.erase(ObjectInterface{path.str, interface});
+            }
+        });
+}
+
+void DbusPropertyCache::watch(const DBusMapping& dbusMapping)
+{
+    ObjectInterface key{dbusMapping.objectPath, dbusMapping.interface};
+    auto [it, inserted] = interfaces.try_emplace(std::move(key));
+    auto& interface = it->second;
+    interface.properties.emplace(dbusMapping.propertyName);
+    if (!inserted)
+    {
+        return;
+    }
+
+    interface.propertiesChanged =
+        std::make_unique<sdbusplus::bus::match::match>(
+            DBusHandler::getBus(),
+            rules::propertiesChanged(dbusMapping.objectPath,
+                                     dbusMapping.interface),
+            [&interface](sdbusplus::message::message& msg) {
+                std::string intf;
+                DbusChangedProps props{};
+                std::vector<std::string> invalidated{};
+                try
+                {
+                    msg.read(intf, props, invalidated);
+                }
+                catch (const std::exception& e)
+                {
+                    // A property of a type PropertyValue can't hold changed,
+                    // start over from D-Bus for this interface
+                    interface.values.clear();
+                    return;
+                }
+                for (const auto& [name, value] : props)
+                {
+                    if (interface.properties.contains(name))
+                    {
+                        interface.values.insert_or_assign(name, value);
+                    }
+                }
+                for (const auto& name : invalidated)
+                {
+                    interface.values.erase(name);
+                }
+            });
+}
+
+const PropertyValue* DbusPropertyCache::find(const DBusMapping& dbusMapping)
+{
+    auto interface = interfaces.find(
+        ObjectInterface{dbusMapping.objectPath, dbusMapping.interface});
+    if (interface != interfaces.end())
+    {
+        auto value = interface->second.values.find(dbusMapping.propertyName);
+        if (value != interface->second.values.end())
+        {
+            ++hits;
+            return &value->second;
+        }
+    }
+
+    ++misses;
+    return nullptr;
+}
+
+void DbusPropertyCache::update(const DBusMapping& dbusMapping,
+                               const PropertyValue& value)
+{
+    watch(dbusMapping);
+    auto& interface = interfaces.at(
+        ObjectInterface{dbusMapping.objectPath, dbusMapping.interface});
+    interface.values.insert_or_assign(dbusMapping.propertyName, value);
+}
+
+} // namespace pldm::responder
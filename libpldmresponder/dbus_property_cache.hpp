@@ -0,0 +1,100 @@
+#pragma once
+
+#include "common/utils.hpp"
+
+#include <sdbusplus/bus/match.hpp>
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <utility>
+
+namespace pldm::responder
+{
+
+/** @class DbusPropertyCache
+ *
+ *  Keeps the values of the D-Bus properties backing the BMC's sensors, so
+ *  that GetStateSensorReadings is answered without a round trip to the
+ *  service owning the property.
+ *
+ *  Every watched interface of an object gets a PropertiesChanged match which
+ *  keeps its cached properties current. A value only enters the cache once
+ *  the match is in place, so the cache never holds a value older than the
+ *  last signal. All the values are dropped when a service that owns a well
+ *  known name goes away or restarts, as it will not announce the values it
+ *  comes back with. An interface removed from its object is dropped with its
+ *  values and its match.
+ */
+class DbusPropertyCache
+{
+  public:
+    DbusPropertyCache();
+    DbusPropertyCache(const DbusPropertyCache&) = delete;
+    DbusPropertyCache& operator=(const DbusPropertyCache&) = delete;
+    DbusPropertyCache(DbusPropertyCache&&) = delete;
+    DbusPropertyCache& operator=(DbusPropertyCache&&) = delete;
+    ~DbusPropertyCache() = default;
+
+    /** @brief Start tracking the property of a D-Bus mapping
+     *
+     *  @param[in] dbusMapping - the D-Bus object, interface and property
+     */
+    void watch(const pldm::utils::DBusMapping& dbusMapping);
+
+    /** @brief Look up the cached value of the property of a D-Bus mapping
+     *
+     *  @param[in] dbusMapping - the D-Bus object, interface and property
+     *
+     *  @return pointer to the value, nullptr on a miss
+     */
+    const pldm::utils::PropertyValue*
+        find(const pldm::utils::DBusMapping& dbusMapping);
+
+    /** @brief Store a value read from D-Bus after a miss
+     *
+     *  The mapping should be watched before the value is read, so that a
+     *  change racing with the read is not lost.
+     *
+     *  @param[in] dbusMapping - the D-Bus object, interface and property
+     *  @param[in] value - value of the property
+     */
+    void update(const pldm::utils::DBusMapping& dbusMapping,
+                const pldm::utils::PropertyValue& value);
+
+    uint64_t getHits() const
+    {
+        return hits;
+    }
+
+    uint64_t getMisses() const
+    {
+        return misses;
+    }
+
+  private:
+    using ObjectInterface = std::pair<std::string, std::string>;
+
+    struct WatchedInterface
+    {
+        std::unique_ptr<sdbusplus::bus::match::match> propertiesChanged;
+        std::set<std::string> properties;
+        std::map<std::string, pldm::utils::PropertyValue> values;
+    };
+
+    /** @brief Interfaces being watched, by object path and interface name */
+    std::map<ObjectInterface, WatchedInterface> interfaces;
+
+    /** @brief Drops every value when a service changes owner */
+    std::unique_ptr<sdbusplus::bus::match::match> nameOwnerChanged;
+
+    /** @brief Drops the interfaces removed from their object */
+    std::unique_ptr<sdbusplus::bus::match::match> interfacesRemoved;
+
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+};
+
+} // namespace pldm::responder
@@ -2,6 +2,7 @@
 
 #include "libpldm/entity.h"
 #include "libpldm/state_set.h"
+#include "libpldm/utils.h"
 
 #include "common/types.hpp"
 #include "common/utils.hpp"
@@ -19,6 +20,8 @@
 
 #include <config.h>
 
+#include <algorithm>
+
 using namespace pldm::utils;
 using namespace pldm::responder::pdr;
 using namespace pldm::responder::pdr_utils;
@@ -42,6 +45,10 @@ void Handler::addDbusObjMaps(
 {
     if (typeId == TypeId::PLDM_SENSOR_ID)
     {
+        for (const auto& dbusMapping : std::get<0>(dbusObj))
+        {
+            sensorStateCache.watch(dbusMapping);
+        }
         sensorDbusObjMaps.emplace(id, dbusObj);
     }
     else
@@ -63,6 +70,57 @@ const std::tuple<pdr_utils::DbusMappings, pdr_utils::DbusValMaps>&
     }
 }
 
+/** @brief Find a PDR of the given type by sensor/effecter id, looking at the
+ *         BMC's own PDRs before the ones merged in from the host
+ *
+ *  @param[in] repo - PDR repo
+ *  @param[in] find - libpldm lookup by sensor or effecter id
+ *  @param[in] id - sensor/effecter id
+ *  @param[in] pdrType - expected PDR type
+ *
+ *  @return pointer to the PDR data, nullptr if there is none
+ */
+template <typename FindFunc>
+static uint8_t* findPDRById(const pldm_pdr* repo, FindFunc find, uint16_t id,
+                            uint8_t pdrType)
+{
+    for (bool isRemote : {false, true})
+    {
+        uint8_t* data = nullptr;
+        uint32_t size = 0;
+        if (find(repo, id, isRemote, &data, &size) &&
+            size >= sizeof(pldm_pdr_hdr) &&
+            reinterpret_cast<const pldm_pdr_hdr*>(data)->type == pdrType)
+        {
+            return data;
+        }
+    }
+    return nullptr;
+}
+
+pldm_state_sensor_pdr* Handler::getStateSensorPDR(uint16_t sensorId) const
+{
+    return reinterpret_cast<pldm_state_sensor_pdr*>(
+        findPDRById(pdrRepo.getPdr(), pldm_pdr_find_record_by_sensor_id,
+                    sensorId, PLDM_STATE_SENSOR_PDR));
+}
+
+pldm_state_effecter_pdr*
+    Handler::getStateEffecterPDR(uint16_t effecterId) const
+{
+    return reinterpret_cast<pldm_state_effecter_pdr*>(
+        findPDRById(pdrRepo.getPdr(), pldm_pdr_find_record_by_effecter_id,
+                    effecterId, PLDM_STATE_EFFECTER_PDR));
+}
+
+pldm_numeric_effecter_value_pdr*
+    Handler::getNumericEffecterPDR(uint16_t effecterId) const
+{
+    return reinterpret_cast<pldm_numeric_effecter_value_pdr*>(
+        findPDRById(pdrRepo.getPdr(), pldm_pdr_find_record_by_effecter_id,
+                    effecterId, PLDM_NUMERIC_EFFECTER_PDR));
+}
+
 void Handler::generate(const pldm::utils::DBusHandler& dBusIntf,
                        const std::vector<fs::path>& dir, Repo& repo,
                        pldm_entity_association_tree* bmcEntityTree)
@@ -289,22 +347,56 @@ Response Handler::getPDR(const pldm_msg* request, size_t payloadLength)
                 request, PLDM_PLATFORM_INVALID_RECORD_HANDLE);
         }
 
-        if (reqSizeBytes)
+        if (transferOpFlag != PLDM_GET_FIRSTPART &&
+            transferOpFlag != PLDM_GET_NEXTPART)
         {
-            respSizeBytes = e.size;
-            if (respSizeBytes > reqSizeBytes)
-            {
-                respSizeBytes = reqSizeBytes;
-            }
-            recordData = e.data;
+            return CmdHandler::ccOnlyResponse(
+                request, PLDM_PLATFORM_INVALID_TRANSFER_OPERATION_FLAG);
+        }
+
+        // The data transfer handle is the offset into the record the next
+        // part starts at, so a transfer needs no state on our side
+        if (transferOpFlag == PLDM_GET_FIRSTPART)
+        {
+            dataTransferHandle = 0;
+        }
+        if (dataTransferHandle && dataTransferHandle >= e.size)
+        {
+            return CmdHandler::ccOnlyResponse(
+                request, PLDM_PLATFORM_INVALID_DATA_TRANSFER_HANDLE);
+        }
+
+        uint32_t remaining = e.size - dataTransferHandle;
+        respSizeBytes = std::min<uint32_t>(
+            {remaining, reqSizeBytes, PDR_TRANSFER_CHUNK_SIZE});
+        if (respSizeBytes)
+        {
+            recordData = e.data + dataTransferHandle;
+        }
+
+        uint32_t nextDataTransferHandle = 0;
+        uint8_t transferFlag = PLDM_START_AND_END;
+        uint8_t transferCRC = 0;
+        if (reqSizeBytes && respSizeBytes < remaining)
+        {
+            nextDataTransferHandle = dataTransferHandle + respSizeBytes;
+            transferFlag = dataTransferHandle ? PLDM_MIDDLE : PLDM_START;
+        }
+        else if (reqSizeBytes && dataTransferHandle)
+        {
+            transferFlag = PLDM_END;
+            transferCRC = crc8(e.data, e.size);
         }
+
         response.resize(sizeof(pldm_msg_hdr) + PLDM_GET_PDR_MIN_RESP_BYTES +
-                            respSizeBytes,
+                            respSizeBytes + (transferFlag == PLDM_END),
                         0);
         auto responsePtr = reinterpret_cast<pldm_msg*>(response.data());
-        rc = encode_get_pdr_resp(
-            request->hdr.instance_id, PLDM_SUCCESS, e.handle.nextRecordHandle,
-            0, PLDM_START_AND_END, respSizeBytes, recordData, 0, responsePtr);
+        rc = encode_get_pdr_resp(request->hdr.instance_id, PLDM_SUCCESS,
+                                 e.handle.nextRecordHandle,
+                                 nextDataTransferHandle, transferFlag,
+                                 respSizeBytes, recordData, transferCRC,
+                                 responsePtr);
         if (rc != PLDM_SUCCESS)
         {
             return ccOnlyResponse(request, rc);
@@ -856,59 +948,32 @@ bool isOemNumericEffecter(Handler& handler, uint16_t effecterId,
                           real32_t& effecterOffset,
                           real32_t& effecterResolution)
 {
-    pldm_numeric_effecter_value_pdr* pdr = nullptr;
-
-    std::unique_ptr<pldm_pdr, decltype(&pldm_pdr_destroy)>
-        numericEffecterPdrRepo(pldm_pdr_init(), pldm_pdr_destroy);
-    pldm::responder::pdr_utils::Repo numericEffecterPDRs(
-        numericEffecterPdrRepo.get());
-    pldm::responder::pdr::getRepoByType(handler.getRepo(), numericEffecterPDRs,
-                                        PLDM_NUMERIC_EFFECTER_PDR);
-
-    if (numericEffecterPDRs.empty())
+    auto pdr = handler.getNumericEffecterPDR(effecterId);
+    if (!pdr)
     {
-        std::cerr << "Failed to get record by PDR type\n";
         return false;
     }
 
-    PdrEntry pdrEntry{};
-    auto pdrRecord = numericEffecterPDRs.getFirstRecord(pdrEntry);
-    while (pdrRecord)
+    auto tmpEntityType = pdr->entity_type;
+    auto tmpEntityInstance = pdr->entity_instance;
+    auto tmpEffecterDataSize = pdr->effecter_data_size;
+    auto tmpEffecterSemanticId = pdr->effecter_semantic_id;
+    auto tmpEffecterOffset = pdr->offset;
+    auto tmpEffecterResolution = pdr->resolution;
+
+    if ((tmpEntityType >= PLDM_OEM_ENTITY_TYPE_START &&
+         tmpEntityType <= PLDM_OEM_ENTITY_TYPE_END) ||
+        (tmpEffecterSemanticId >= PLDM_OEM_STATE_SET_ID_START &&
+         tmpEffecterSemanticId < PLDM_OEM_STATE_SET_ID_END))
     {
-        pdr = reinterpret_cast<pldm_numeric_effecter_value_pdr*>(pdrEntry.data);
-        assert(pdr != NULL);
-        if (pdr->effecter_id != effecterId)
-        {
-            pdr = nullptr;
-            pdrRecord = numericEffecterPDRs.getNextRecord(pdrRecord, pdrEntry);
-            continue;
-        }
 
-        auto tmpEntityType = pdr->entity_type;
-        auto tmpEntityInstance = pdr->entity_instance;
-        auto tmpEffecterDataSize = pdr->effecter_data_size;
-        auto tmpEffecterSemanticId = pdr->effecter_semantic_id;
-        auto tmpEffecterOffset = pdr->offset;
-        auto tmpEffecterResolution = pdr->resolution;
-
-        if ((tmpEntityType >= PLDM_OEM_ENTITY_TYPE_START &&
-             tmpEntityType <= PLDM_OEM_ENTITY_TYPE_END) ||
-            (tmpEffecterSemanticId >= PLDM_OEM_STATE_SET_ID_START &&
-             tmpEffecterSemanticId < PLDM_OEM_STATE_SET_ID_END))
-        {
-
-            entityType = tmpEntityType;
-            entityInstance = tmpEntityInstance;
-            effecterDataSize = tmpEffecterDataSize;
-            effecterSemanticId = tmpEffecterSemanticId;
-            effecterOffset = tmpEffecterOffset;
-            effecterResolution = tmpEffecterResolution;
-            return true;
-        }
-        else
-        {
-            return false;
-        }
+        entityType = tmpEntityType;
+        entityInstance = tmpEntityInstance;
+        effecterDataSize = tmpEffecterDataSize;
+        effecterSemanticId = tmpEffecterSemanticId;
+        effecterOffset = tmpEffecterOffset;
+        effecterResolution = tmpEffecterResolution;
+        return true;
     }
     return false;
 }
@@ -918,64 +983,40 @@ bool isOemStateSensor(Handler& handler, uint16_t sensorId,
                       uint16_t& entityType, uint16_t& entityInstance,
                       uint16_t& stateSetId, uint16_t& containerId)
 {
-    pldm_state_sensor_pdr* pdr = nullptr;
-
-    std::unique_ptr<pldm_pdr, decltype(&pldm_pdr_destroy)> stateSensorPdrRepo(
-        pldm_pdr_init(), pldm_pdr_destroy);
-    Repo stateSensorPDRs(stateSensorPdrRepo.get());
-    getRepoByType(handler.getRepo(), stateSensorPDRs, PLDM_STATE_SENSOR_PDR);
-    if (stateSensorPDRs.empty())
+    auto pdr = handler.getStateSensorPDR(sensorId);
+    if (!pdr)
     {
-        std::cerr << "Failed to get record by PDR type\n";
         return false;
     }
 
-    PdrEntry pdrEntry{};
-    auto pdrRecord = stateSensorPDRs.getFirstRecord(pdrEntry);
-    while (pdrRecord)
+    auto tmpEntityType = pdr->entity_type;
+    auto tmpEntityInstance = pdr->entity_instance;
+    auto tmpEntityContainerId = pdr->container_id;
+    auto tmpCompSensorCnt = pdr->composite_sensor_count;
+    auto tmpPossibleStates =
+        reinterpret_cast<state_sensor_possible_states*>(pdr->possible_states);
+    auto tmpStateSetId = tmpPossibleStates->state_set_id;
+
+    if (sensorRearmCount > tmpCompSensorCnt)
     {
-        pdr = reinterpret_cast<pldm_state_sensor_pdr*>(pdrEntry.data);
-        assert(pdr != NULL);
-        if (pdr->sensor_id != sensorId)
-        {
-            pdr = nullptr;
-            pdrRecord = stateSensorPDRs.getNextRecord(pdrRecord, pdrEntry);
-            continue;
-        }
-        auto tmpEntityType = pdr->entity_type;
-        auto tmpEntityInstance = pdr->entity_instance;
-        auto tmpEntityContainerId = pdr->container_id;
-        auto tmpCompSensorCnt = pdr->composite_sensor_count;
-        auto tmpPossibleStates =
-            reinterpret_cast<state_sensor_possible_states*>(
-                pdr->possible_states);
-        auto tmpStateSetId = tmpPossibleStates->state_set_id;
-
-        if (sensorRearmCount > tmpCompSensorCnt)
-        {
-            std::cerr << "The requester sent wrong sensorRearm"
-                      << " count for the sensor, SENSOR_ID=" << sensorId
-                      << "SENSOR_REARM_COUNT=" << (uint16_t)sensorRearmCount
-                      << "\n";
-            break;
-        }
+        std::cerr << "The requester sent wrong sensorRearm"
+                  << " count for the sensor, SENSOR_ID=" << sensorId
+                  << "SENSOR_REARM_COUNT=" << (uint16_t)sensorRearmCount
+                  << "\n";
+        return false;
+    }
 
-        if ((tmpEntityType >= PLDM_OEM_ENTITY_TYPE_START &&
-             tmpEntityType <= PLDM_OEM_ENTITY_TYPE_END) ||
-            (tmpStateSetId >= PLDM_OEM_STATE_SET_ID_START &&
-             tmpStateSetId < PLDM_OEM_STATE_SET_ID_END))
-        {
-            entityType = tmpEntityType;
-            entityInstance = tmpEntityInstance;
-            stateSetId = tmpStateSetId;
-            compSensorCnt = tmpCompSensorCnt;
-            containerId = tmpEntityContainerId;
-            return true;
-        }
-        else
-        {
-            return false;
-        }
+    if ((tmpEntityType >= PLDM_OEM_ENTITY_TYPE_START &&
+         tmpEntityType <= PLDM_OEM_ENTITY_TYPE_END) ||
+        (tmpStateSetId >= PLDM_OEM_STATE_SET_ID_START &&
+         tmpStateSetId < PLDM_OEM_STATE_SET_ID_END))
+    {
+        entityType = tmpEntityType;
+        entityInstance = tmpEntityInstance;
+        stateSetId = tmpStateSetId;
+        compSensorCnt = tmpCompSensorCnt;
+        containerId = tmpEntityContainerId;
+        return true;
     }
     return false;
 }
@@ -984,61 +1025,35 @@ bool isOemStateEffecter(Handler& handler, uint16_t effecterId,
                         uint8_t compEffecterCnt, uint16_t& entityType,
                         uint16_t& entityInstance, uint16_t& stateSetId)
 {
-    pldm_state_effecter_pdr* pdr = nullptr;
-
-    std::unique_ptr<pldm_pdr, decltype(&pldm_pdr_destroy)> stateEffecterPdrRepo(
-        pldm_pdr_init(), pldm_pdr_destroy);
-    Repo stateEffecterPDRs(stateEffecterPdrRepo.get());
-    getRepoByType(handler.getRepo(), stateEffecterPDRs,
-                  PLDM_STATE_EFFECTER_PDR);
-    if (stateEffecterPDRs.empty())
+    auto pdr = handler.getStateEffecterPDR(effecterId);
+    if (!pdr)
     {
-        std::cerr << "Failed to get record by PDR type\n";
         return false;
     }
 
-    PdrEntry pdrEntry{};
-    auto pdrRecord = stateEffecterPDRs.getFirstRecord(pdrEntry);
-    while (pdrRecord)
-    {
-        pdr = reinterpret_cast<pldm_state_effecter_pdr*>(pdrEntry.data);
-        assert(pdr != NULL);
-        if (pdr->effecter_id != effecterId)
-        {
-            pdr = nullptr;
-            pdrRecord = stateEffecterPDRs.getNextRecord(pdrRecord, pdrEntry);
-            continue;
-        }
-
-        auto tmpEntityType = pdr->entity_type;
-        auto tmpEntityInstance = pdr->entity_instance;
-        auto tmpPossibleStates =
-            reinterpret_cast<state_effecter_possible_states*>(
-                pdr->possible_states);
-        auto tmpStateSetId = tmpPossibleStates->state_set_id;
+    auto tmpEntityType = pdr->entity_type;
+    auto tmpEntityInstance = pdr->entity_instance;
+    auto tmpPossibleStates =
+        reinterpret_cast<state_effecter_possible_states*>(pdr->possible_states);
+    auto tmpStateSetId = tmpPossibleStates->state_set_id;
 
-        if (compEffecterCnt > pdr->composite_effecter_count)
-        {
-            std::cerr << "The requester sent wrong composite effecter"
-                      << " count for the effecter, EFFECTER_ID=" << effecterId
-                      << "COMP_EFF_CNT=" << (uint16_t)compEffecterCnt << "\n";
-            return false;
-        }
+    if (compEffecterCnt > pdr->composite_effecter_count)
+    {
+        std::cerr << "The requester sent wrong composite effecter"
+                  << " count for the effecter, EFFECTER_ID=" << effecterId
+                  << "COMP_EFF_CNT=" << (uint16_t)compEffecterCnt << "\n";
+        return false;
+    }
 
-        if ((tmpEntityType >= PLDM_OEM_ENTITY_TYPE_START &&
-             tmpEntityType <= PLDM_OEM_ENTITY_TYPE_END) ||
-            (tmpStateSetId >= PLDM_OEM_STATE_SET_ID_START &&
-             tmpStateSetId < PLDM_OEM_STATE_SET_ID_END))
-        {
-            entityType = tmpEntityType;
-            entityInstance = tmpEntityInstance;
-            stateSetId = tmpStateSetId;
-            return true;
-        }
-        else
-        {
-            return false;
-        }
+    if ((tmpEntityType >= PLDM_OEM_ENTITY_TYPE_START &&
+         tmpEntityType <= PLDM_OEM_ENTITY_TYPE_END) ||
+        (tmpStateSetId >= PLDM_OEM_STATE_SET_ID_START &&
+         tmpStateSetId < PLDM_OEM_STATE_SET_ID_END))
+    {
+        entityType = tmpEntityType;
+        entityInstance = tmpEntityInstance;
+        stateSetId = tmpStateSetId;
+        return true;
     }
     return false;
 }
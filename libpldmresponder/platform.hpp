@@ -7,6 +7,7 @@
 #include "pdr.h"
 
 #include "common/utils.hpp"
+#include "dbus_property_cache.hpp"
 #include "event_parser.hpp"
 #include "fru.hpp"
 #include "host-bmc/dbus_to_event_handler.hpp"
@@ -161,6 +162,35 @@ class Handler : public CmdHandler
         return this->pdrRepo;
     }
 
+    /** @brief Find the state sensor PDR for a sensor id
+     *
+     *  The lookup goes through the sensor id index of the PDR repo, which
+     *  stays in sync with pdrRepo as records are added and removed. BMC PDRs
+     *  are preferred over the ones merged in from the host.
+     *
+     *  @param[in] sensorId - sensor id
+     *
+     *  @return pointer to the PDR in pdrRepo, nullptr if there is none
+     */
+    pldm_state_sensor_pdr* getStateSensorPDR(uint16_t sensorId) const;
+
+    /** @brief Find the state effecter PDR for an effecter id
+     *
+     *  @param[in] effecterId - effecter id
+     *
+     *  @return pointer to the PDR in pdrRepo, nullptr if there is none
+     */
+    pldm_state_effecter_pdr* getStateEffecterPDR(uint16_t effecterId) const;
+
+    /** @brief Find the numeric effecter PDR for an effecter id
+     *
+     *  @param[in] effecterId - effecter id
+     *
+     *  @return pointer to the PDR in pdrRepo, nullptr if there is none
+     */
+    pldm_numeric_effecter_value_pdr*
+        getNumericEffecterPDR(uint16_t effecterId) const;
+
     /** @brief Add D-Bus mapping and value mapping(stateId to D-Bus) for the
      *         Id. If the same id is added, the previous dbusObjs will
      *         be "over-written".
@@ -191,6 +221,12 @@ class Handler : public CmdHandler
             pldm::responder::pdr_utils::TypeId typeId =
                 pldm::responder::pdr_utils::TypeId::PLDM_EFFECTER_ID) const;
 
+    /** @brief Get the cache of the D-Bus properties backing the sensors */
+    DbusPropertyCache& getSensorStateCache()
+    {
+        return sensorStateCache;
+    }
+
     uint16_t getNextEffecterId()
     {
         return ++nextEffecterId;
@@ -329,51 +365,23 @@ class Handler : public CmdHandler
         using namespace pldm::utils;
         using StateSetNum = uint8_t;
 
-        state_effecter_possible_states* states = nullptr;
-        pldm_state_effecter_pdr* pdr = nullptr;
         uint8_t compEffecterCnt = stateField.size();
 
-        std::unique_ptr<pldm_pdr, decltype(&pldm_pdr_destroy)>
-            stateEffecterPdrRepo(pldm_pdr_init(), pldm_pdr_destroy);
-        pldm::responder::pdr_utils::Repo stateEffecterPDRs(
-            stateEffecterPdrRepo.get());
-        getRepoByType(pdrRepo, stateEffecterPDRs, PLDM_STATE_EFFECTER_PDR);
-        if (stateEffecterPDRs.empty())
+        pldm_state_effecter_pdr* pdr = getStateEffecterPDR(effecterId);
+        if (!pdr)
         {
-            std::cerr << "Failed to get record by PDR type\n";
             return PLDM_PLATFORM_INVALID_EFFECTER_ID;
         }
 
-        pldm::responder::pdr_utils::PdrEntry pdrEntry{};
-        auto pdrRecord = stateEffecterPDRs.getFirstRecord(pdrEntry);
-        while (pdrRecord)
+        auto states = reinterpret_cast<state_effecter_possible_states*>(
+            pdr->possible_states);
+        if (compEffecterCnt > pdr->composite_effecter_count)
         {
-            pdr = reinterpret_cast<pldm_state_effecter_pdr*>(pdrEntry.data);
-            if (pdr->effecter_id != effecterId)
-            {
-                pdr = nullptr;
-                pdrRecord =
-                    stateEffecterPDRs.getNextRecord(pdrRecord, pdrEntry);
-                continue;
-            }
-
-            states = reinterpret_cast<state_effecter_possible_states*>(
-                pdr->possible_states);
-            if (compEffecterCnt > pdr->composite_effecter_count)
-            {
-                std::cerr << "The requester sent wrong composite effecter"
-                          << " count for the effecter, EFFECTER_ID="
-                          << (unsigned)effecterId
-                          << "COMP_EFF_CNT=" << (unsigned)compEffecterCnt
-                          << "\n";
-                return PLDM_ERROR_INVALID_DATA;
-            }
-            break;
-        }
-
-        if (!pdr)
-        {
-            return PLDM_PLATFORM_INVALID_EFFECTER_ID;
+            std::cerr << "The requester sent wrong composite effecter"
+                      << " count for the effecter, EFFECTER_ID="
+                      << (unsigned)effecterId
+                      << "COMP_EFF_CNT=" << (unsigned)compEffecterCnt << "\n";
+            return PLDM_ERROR_INVALID_DATA;
         }
 
         int rc = PLDM_SUCCESS;
@@ -478,6 +486,7 @@ class Handler : public CmdHandler
     uint16_t nextSensorId{};
     pdr_utils::DbusObjMaps effecterDbusObjMaps{};
     pdr_utils::DbusObjMaps sensorDbusObjMaps{};
+    DbusPropertyCache sensorStateCache;
     HostPDRHandler* hostPDRHandler;
     pldm::state_sensor::DbusToPLDMEvent* dbusToPLDMEventHandler;
     fru::Handler* fruHandler;
@@ -252,37 +252,8 @@ int setNumericEffecterValueHandler(const DBusInterface& dBusIntf,
                                    size_t effecterValueLength)
 {
     constexpr auto effecterValueArrayLength = 4;
-    pldm_numeric_effecter_value_pdr* pdr = nullptr;
-
-    std::unique_ptr<pldm_pdr, decltype(&pldm_pdr_destroy)>
-        numericEffecterPdrRepo(pldm_pdr_init(), pldm_pdr_destroy);
-    pldm::responder::pdr_utils::Repo numericEffecterPDRs(
-        numericEffecterPdrRepo.get());
-    pldm::responder::pdr::getRepoByType(handler.getRepo(), numericEffecterPDRs,
-                                        PLDM_NUMERIC_EFFECTER_PDR);
-    if (numericEffecterPDRs.empty())
-    {
-        std::cerr << "The Numeric Effecter PDR repo is empty." << std::endl;
-        return PLDM_ERROR;
-    }
-
-    // Get the pdr structure of pldm_numeric_effecter_value_pdr according
-    // to the effecterId
-    pldm::responder::pdr_utils::PdrEntry pdrEntry{};
-    auto pdrRecord = numericEffecterPDRs.getFirstRecord(pdrEntry);
-    while (pdrRecord)
-    {
-        pdr = reinterpret_cast<pldm_numeric_effecter_value_pdr*>(pdrEntry.data);
-        if (pdr->effecter_id != effecterId)
-        {
-            pdr = nullptr;
-            pdrRecord = numericEffecterPDRs.getNextRecord(pdrRecord, pdrEntry);
-            continue;
-        }
-
-        break;
-    }
-
+    pldm_numeric_effecter_value_pdr* pdr =
+        handler.getNumericEffecterPDR(effecterId);
     if (!pdr)
     {
         return PLDM_PLATFORM_INVALID_EFFECTER_ID;
@@ -41,49 +41,22 @@ int setStateEffecterStatesHandler(
     using namespace pldm::utils;
     using StateSetNum = uint8_t;
 
-    state_effecter_possible_states* states = nullptr;
-    pldm_state_effecter_pdr* pdr = nullptr;
     uint8_t compEffecterCnt = stateField.size();
 
-    std::unique_ptr<pldm_pdr, decltype(&pldm_pdr_destroy)> stateEffecterPdrRepo(
-        pldm_pdr_init(), pldm_pdr_destroy);
-    pldm::responder::pdr_utils::Repo stateEffecterPDRs(
-        stateEffecterPdrRepo.get());
-    getRepoByType(handler.getRepo(), stateEffecterPDRs,
-                  PLDM_STATE_EFFECTER_PDR);
-    if (stateEffecterPDRs.empty())
+    pldm_state_effecter_pdr* pdr = handler.getStateEffecterPDR(effecterId);
+    if (!pdr)
     {
-        std::cerr << "Failed to get record by PDR type\n";
         return PLDM_PLATFORM_INVALID_EFFECTER_ID;
     }
 
-    pldm::responder::pdr_utils::PdrEntry pdrEntry{};
-    auto pdrRecord = stateEffecterPDRs.getFirstRecord(pdrEntry);
-    while (pdrRecord)
+    auto states =
+        reinterpret_cast<state_effecter_possible_states*>(pdr->possible_states);
+    if (compEffecterCnt > pdr->composite_effecter_count)
     {
-        pdr = reinterpret_cast<pldm_state_effecter_pdr*>(pdrEntry.data);
-        if (pdr->effecter_id != effecterId)
-        {
-            pdr = nullptr;
-            pdrRecord = stateEffecterPDRs.getNextRecord(pdrRecord, pdrEntry);
-            continue;
-        }
-
-        states = reinterpret_cast<state_effecter_possible_states*>(
-            pdr->possible_states);
-        if (compEffecterCnt > pdr->composite_effecter_count)
-        {
-            std::cerr << "The requester sent wrong composite effecter"
-                      << " count for the effecter, EFFECTER_ID=" << effecterId
-                      << "COMP_EFF_CNT=" << compEffecterCnt << "\n";
-            return PLDM_ERROR_INVALID_DATA;
-        }
-        break;
-    }
-
-    if (!pdr)
-    {
-        return PLDM_PLATFORM_INVALID_EFFECTER_ID;
+        std::cerr << "The requester sent wrong composite effecter"
+                  << " count for the effecter, EFFECTER_ID=" << effecterId
+                  << "COMP_EFF_CNT=" << compEffecterCnt << "\n";
+        return PLDM_ERROR_INVALID_DATA;
     }
 
     int rc = PLDM_SUCCESS;
@@ -12,6 +12,10 @@
 
 #include <cstdint>
 #include <map>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
 
 namespace pldm
 {
@@ -20,50 +24,66 @@ namespace responder
 namespace platform_state_sensor
 {
 
-/** @brief Function to get the sensor state
+/** @brief Function to map the value of a D-Bus property to a sensor state
  *
- *  @tparam[in] DBusInterface - DBus interface type
- *  @param[in] dBusIntf - The interface object of DBusInterface
  *  @param[in] stateToDbusValue - Map of DBus property State to attribute value
  *  @param[in] dbusMapping - The d-bus object
+ *  @param[in] propertyValue - The value of the d-bus property
  *
  *  @return - Enumeration of SensorState
+ *
+ *  @throw std::bad_variant_access when a string property holds another type
  */
-template <class DBusInterface>
-uint8_t getStateSensorEventState(
-    const DBusInterface& dBusIntf,
+inline uint8_t getStateFromDbusValue(
     const std::map<pldm::responder::pdr_utils::State,
                    pldm::utils::PropertyValue>& stateToDbusValue,
-    const pldm::utils::DBusMapping& dbusMapping)
+    const pldm::utils::DBusMapping& dbusMapping,
+    const pldm::utils::PropertyValue& propertyValue)
 {
-    try
+    for (const auto& stateValue : stateToDbusValue)
     {
-        auto propertyValue = dBusIntf.getDbusPropertyVariant(
-            dbusMapping.objectPath.c_str(), dbusMapping.propertyName.c_str(),
-            dbusMapping.interface.c_str());
-
-        for (const auto& stateValue : stateToDbusValue)
+        // This special condition added to handle the "||" keyword
+        // present in the property value string
+        if (dbusMapping.propertyType == "string")
         {
-            // This special condition added to handle the "||" keyword
-            // present in the property value string
-            if (dbusMapping.propertyType == "string")
-            {
-                std::string statValSecStr =
-                    std::get<std::string>(stateValue.second);
-                std::string proValStr = std::get<std::string>(propertyValue);
-
-                if ((std::strstr(statValSecStr.c_str(), "||")) &&
-                    (std::strstr(statValSecStr.c_str(), proValStr.c_str())))
-                {
-                    return stateValue.first;
-                }
-            }
+            std::string statValSecStr =
+                std::get<std::string>(stateValue.second);
+            std::string proValStr = std::get<std::string>(propertyValue);
 
-            if (stateValue.second == propertyValue)
+            if ((std::strstr(statValSecStr.c_str(), "||")) &&
+                (std::strstr(statValSecStr.c_str(), proValStr.c_str())))
             {
                 return stateValue.first;
             }
         }
+
+        if (stateValue.second == propertyValue)
+        {
+            return stateValue.first;
+        }
+    }
+
+    return PLDM_SENSOR_UNKNOWN;
+}
+
+/** @brief Function to get the sensor state from the value of its property
+ *
+ *  @param[in] propertyValue - The value of the d-bus property
+ *  @param[in] stateToDbusValue - Map of DBus property State to attribute value
+ *  @param[in] dbusMapping - The d-bus object
+ *
+ *  @return - Enumeration of SensorState
+ */
+inline uint8_t getStateSensorEventState(
+    const pldm::utils::PropertyValue& propertyValue,
+    const std::map<pldm::responder::pdr_utils::State,
+                   pldm::utils::PropertyValue>& stateToDbusValue,
+    const pldm::utils::DBusMapping& dbusMapping)
+{
+    try
+    {
+        return getStateFromDbusValue(stateToDbusValue, dbusMapping,
+                                     propertyValue);
     }
     catch (const std::exception& e)
     {
@@ -100,52 +120,25 @@ int getStateSensorReadingsHandler(
     using namespace pldm::responder::pdr;
     using namespace pldm::utils;
 
-    pldm_state_sensor_pdr* pdr = nullptr;
-
-    std::unique_ptr<pldm_pdr, decltype(&pldm_pdr_destroy)> stateSensorPdrRepo(
-        pldm_pdr_init(), pldm_pdr_destroy);
-    pldm::responder::pdr_utils::Repo stateSensorPDRs(stateSensorPdrRepo.get());
-    getRepoByType(handler.getRepo(), stateSensorPDRs, PLDM_STATE_SENSOR_PDR);
-    if (stateSensorPDRs.empty())
+    pldm_state_sensor_pdr* pdr = handler.getStateSensorPDR(sensorId);
+    if (!pdr)
     {
-        std::cerr << "Failed to get record by PDR type\n";
         return PLDM_PLATFORM_INVALID_SENSOR_ID;
     }
 
-    pldm::responder::pdr_utils::PdrEntry pdrEntry{};
-    auto pdrRecord = stateSensorPDRs.getFirstRecord(pdrEntry);
-    while (pdrRecord)
+    compSensorCnt = pdr->composite_sensor_count;
+    if (sensorRearmCnt > compSensorCnt)
     {
-        pdr = reinterpret_cast<pldm_state_sensor_pdr*>(pdrEntry.data);
-        assert(pdr != NULL);
-        if (pdr->sensor_id != sensorId)
-        {
-            pdr = nullptr;
-            pdrRecord = stateSensorPDRs.getNextRecord(pdrRecord, pdrEntry);
-            continue;
-        }
-
-        compSensorCnt = pdr->composite_sensor_count;
-        if (sensorRearmCnt > compSensorCnt)
-        {
-            std::cerr << "The requester sent wrong sensorRearm"
-                      << " count for the sensor, SENSOR_ID=" << sensorId
-                      << "SENSOR_REARM_COUNT=" << sensorRearmCnt << "\n";
-            return PLDM_PLATFORM_REARM_UNAVAILABLE_IN_PRESENT_STATE;
-        }
-
-        if (sensorRearmCnt == 0)
-        {
-            sensorRearmCnt = compSensorCnt;
-            stateField.resize(sensorRearmCnt);
-        }
-
-        break;
+        std::cerr << "The requester sent wrong sensorRearm"
+                  << " count for the sensor, SENSOR_ID=" << sensorId
+                  << "SENSOR_REARM_COUNT=" << sensorRearmCnt << "\n";
+        return PLDM_PLATFORM_REARM_UNAVAILABLE_IN_PRESENT_STATE;
     }
 
-    if (!pdr)
+    if (sensorRearmCnt == 0)
     {
-        return PLDM_PLATFORM_INVALID_SENSOR_ID;
+        sensorRearmCnt = compSensorCnt;
+        stateField.resize(sensorRearmCnt);
     }
 
     int rc = PLDM_SUCCESS;
@@ -154,13 +147,91 @@ int getStateSensorReadingsHandler(
         const auto& [dbusMappings, dbusValMaps] = handler.getDbusObjMaps(
             sensorId, pldm::responder::pdr_utils::TypeId::PLDM_SENSOR_ID);
 
-        stateField.clear();
+        // Serve the states from the property cache, which the
+        // PropertiesChanged signals keep current, and only go to D-Bus for
+        // the properties it does not hold yet
+        auto& cache = handler.getSensorStateCache();
+        std::vector<std::optional<PropertyValue>> values(sensorRearmCnt);
+        using ObjectInterface = std::pair<std::string, std::string>;
+        std::map<ObjectInterface, size_t> interfaceMisses;
         for (size_t i = 0; i < sensorRearmCnt; i++)
         {
             auto& dbusMapping = dbusMappings[i];
+            if (auto cached = cache.find(dbusMapping))
+            {
+                values[i] = *cached;
+                continue;
+            }
+            cache.watch(dbusMapping);
+            ++interfaceMisses[{dbusMapping.objectPath, dbusMapping.interface}];
+        }
+
+        // The states of a composite sensor often live on one interface of
+        // one object, such interfaces are read with a single GetAll
+        std::map<ObjectInterface, PropertyMap> interfaceProperties;
+        for (size_t i = 0; i < sensorRearmCnt; i++)
+        {
+            auto& dbusMapping = dbusMappings[i];
+            if (values[i])
+            {
+                continue;
+            }
 
-            uint8_t sensorEvent = getStateSensorEventState<DBusInterface>(
-                dBusIntf, dbusValMaps[i], dbusMapping);
+            ObjectInterface key{dbusMapping.objectPath, dbusMapping.interface};
+            try
+            {
+                if (interfaceMisses[key] > 1)
+                {
+                    auto properties = interfaceProperties.find(key);
+                    if (properties == interfaceProperties.end())
+                    {
+                        // Left empty if GetAll fails, so that it is not
+                        // retried for each of the states
+                        properties =
+                            interfaceProperties.emplace(key, PropertyMap{})
+                                .first;
+                        properties->second = dBusIntf.getDbusProperties(
+                            dbusMapping.objectPath.c_str(),
+                            dbusMapping.interface.c_str());
+                    }
+                    auto property =
+                        properties->second.find(dbusMapping.propertyName);
+                    if (property != properties->second.end())
+                    {
+                        values[i] = property->second;
+                    }
+                }
+                else
+                {
+                    values[i] = dBusIntf.getDbusPropertyVariant(
+                        dbusMapping.objectPath.c_str(),
+                        dbusMapping.propertyName.c_str(),
+                        dbusMapping.interface.c_str());
+                }
+            }
+            catch (const std::exception& e)
+            {
+                std::cerr << "Get StateSensor EventState from dbus Error, "
+                             "interface : "
+                          << dbusMapping.objectPath.c_str()
+                          << " ,exception : " << e.what() << '\n';
+            }
+
+            if (values[i])
+            {
+                cache.update(dbusMapping, *values[i]);
+            }
+        }
+
+        stateField.clear();
+        for (size_t i = 0; i < sensorRearmCnt; i++)
+        {
+            uint8_t sensorEvent = PLDM_SENSOR_UNKNOWN;
+            if (values[i])
+            {
+                sensorEvent = getStateSensorEventState(
+                    *values[i], dbusValMaps[i], dbusMappings[i]);
+            }
 
             uint8_t opState = PLDM_SENSOR_ENABLED;
             if (sensorEvent == PLDM_SENSOR_UNKNOWN)
@@ -246,6 +246,41 @@ TEST_F(TestBIOSConfig, buildTablesTest)
     }
 }
 
+TEST_F(TestBIOSConfig, persistTables)
+{
+    MockdBusHandler dbusHandler;
+
+    ON_CALL(dbusHandler, getDbusPropertyVariant(_, _, _))
+        .WillByDefault(Throw(std::exception()));
+
+    Table stringTable;
+    {
+        BIOSConfig biosConfig("./bios_jsons", tableDir.c_str(), &dbusHandler,
+                              0, 0, nullptr, nullptr);
+        biosConfig.removeTables();
+        biosConfig.buildTables();
+
+        auto table = biosConfig.getBIOSTable(PLDM_BIOS_STRING_TABLE);
+        ASSERT_TRUE(table);
+        stringTable = *table;
+
+        // Served from memory until the write-behind runs
+        EXPECT_FALSE(fs::exists(tableDir / "stringTable"));
+        EXPECT_EQ(biosConfig.getBIOSTable(PLDM_BIOS_STRING_TABLE), table);
+    }
+
+    EXPECT_TRUE(fs::exists(tableDir / "stringTable"));
+    EXPECT_FALSE(fs::exists(tableDir / "stringTable.tmp"));
+
+    BIOSConfig biosConfig("./bios_jsons", tableDir.c_str(), &dbusHandler, 0, 0,
+                          nullptr, nullptr);
+    auto table = biosConfig.getBIOSTable(PLDM_BIOS_STRING_TABLE);
+    ASSERT_TRUE(table);
+    EXPECT_EQ(*table, stringTable);
+    EXPECT_TRUE(biosConfig.getBIOSTable(PLDM_BIOS_ATTR_TABLE));
+    EXPECT_TRUE(biosConfig.getBIOSTable(PLDM_BIOS_ATTR_VAL_TABLE));
+}
+
 TEST_F(TestBIOSConfig, setAttrValue)
 {
     MockdBusHandler dbusHandler;
@@ -317,4 +352,114 @@ TEST_F(TestBIOSConfig, setAttrValue)
     auto p = reinterpret_cast<const uint8_t*>(entry);
     EXPECT_THAT(std::vector<uint8_t>(p, p + attrValueEntry.size()),
                 ElementsAreArray(attrValueEntry));
+
+    // A string of the same length replaces the entry in place
+    attrValueEntry[5] = 'w';
+    attrValueEntry[8] = 'z';
+    value = std::string("wbcz");
+    EXPECT_CALL(dbusHandler, setDbusProperty(dbusMapping, value)).Times(1);
+    auto tableSize = attrValueTable->size();
+    rc = biosConfig.setAttrValue(attrValueEntry.data(), attrValueEntry.size());
+    EXPECT_EQ(rc, PLDM_SUCCESS);
+
+    attrValueTable = biosConfig.getBIOSTable(PLDM_BIOS_ATTR_VAL_TABLE);
+    EXPECT_EQ(attrValueTable->size(), tableSize);
+    EXPECT_TRUE(pldm_bios_table_checksum(attrValueTable->data(),
+                                         attrValueTable->size()));
+    entry = findEntry(attrHandle);
+    ASSERT_NE(entry, nullptr);
+    p = reinterpret_cast<const uint8_t*>(entry);
+    EXPECT_THAT(std::vector<uint8_t>(p, p + attrValueEntry.size()),
+                ElementsAreArray(attrValueEntry));
+}
+
+TEST_F(TestBIOSConfig, setAttrValues)
+{
+    MockdBusHandler dbusHandler;
+
+    BIOSConfig biosConfig("./bios_jsons", tableDir.c_str(), &dbusHandler, 0, 0,
+                          nullptr, nullptr);
+    biosConfig.removeTables();
+    biosConfig.buildTables();
+
+    auto stringTable = biosConfig.getBIOSTable(PLDM_BIOS_STRING_TABLE);
+    auto attrTable = biosConfig.getBIOSTable(PLDM_BIOS_ATTR_TABLE);
+    BIOSStringTable biosStringTable(*stringTable);
+    auto findAttrHandle = [&](const std::string& name) -> uint16_t {
+        auto stringHandle = biosStringTable.findHandle(name);
+        auto entry =
+            table::attribute::findByStringHandle(*attrTable, stringHandle);
+        EXPECT_NE(entry, nullptr);
+        return table::attribute::decodeHeader(entry).attrHandle;
+    };
+    auto strHandle = findAttrHandle("str_example1");
+    auto intHandle = findAttrHandle("VDD_AVSBUS_RAIL");
+
+    std::vector<uint8_t> strEntry{
+        0,   0,             /* attr handle */
+        1,                  /* attr type string read-write */
+        4,   0,             /* current string length */
+        'a', 'b', 'c', 'd', /* current string */
+    };
+    strEntry[0] = strHandle & 0xff;
+    strEntry[1] = (strHandle >> 8) & 0xff;
+
+    std::vector<uint8_t> intEntry{
+        0,  0,                   /* attr handle */
+        3,                       /* attr type integer read-write */
+        20, 0, 0, 0, 0, 0, 0, 0, /* current value, out of bound */
+    };
+    intEntry[0] = intHandle & 0xff;
+    intEntry[1] = (intHandle >> 8) & 0xff;
+
+    auto attrValueTable = *biosConfig.getBIOSTable(PLDM_BIOS_ATTR_VAL_TABLE);
+
+    // One bad entry rejects the whole batch
+    EXPECT_CALL(dbusHandler, setDbusProperty(_, _)).Times(0);
+    auto rc = biosConfig.setAttrValues({strEntry, intEntry});
+    EXPECT_EQ(rc, PLDM_ERROR_INVALID_DATA);
+    EXPECT_EQ(*biosConfig.getBIOSTable(PLDM_BIOS_ATTR_VAL_TABLE),
+              attrValueTable);
+    ::testing::Mock::VerifyAndClearExpectations(&dbusHandler);
+
+    intEntry[3] = 5;
+    EXPECT_CALL(dbusHandler, setDbusProperty(_, _)).Times(2);
+    rc = biosConfig.setAttrValues({strEntry, intEntry});
+    EXPECT_EQ(rc, PLDM_SUCCESS);
+
+    auto newTable = biosConfig.getBIOSTable(PLDM_BIOS_ATTR_VAL_TABLE);
+    for (const auto& expected : {strEntry, intEntry})
+    {
+        uint16_t handle = expected[0] | (expected[1] << 8);
+        auto entry = pldm_bios_table_attr_value_find_by_handle(
+            newTable->data(), newTable->size(), handle);
+        ASSERT_NE(entry, nullptr);
+        auto p = reinterpret_cast<const uint8_t*>(entry);
+        EXPECT_THAT(std::vector<uint8_t>(p, p + expected.size()),
+                    ElementsAreArray(expected));
+    }
+    ::testing::Mock::VerifyAndClearExpectations(&dbusHandler);
+
+    // The table holds the values before dbus is told, a value dbus fails to
+    // take does not hold back the others
+    strEntry[5] = 'w';
+    intEntry[3] = 6;
+    EXPECT_CALL(dbusHandler, setDbusProperty(_, _))
+        .Times(2)
+        .WillOnce(Throw(std::runtime_error("setDbusProperty failed")))
+        .WillOnce(::testing::Return());
+    rc = biosConfig.setAttrValues({strEntry, intEntry});
+    EXPECT_EQ(rc, PLDM_SUCCESS);
+
+    newTable = biosConfig.getBIOSTable(PLDM_BIOS_ATTR_VAL_TABLE);
+    for (const auto& expected : {strEntry, intEntry})
+    {
+        uint16_t handle = expected[0] | (expected[1] << 8);
+        auto entry = pldm_bios_table_attr_value_find_by_handle(
+            newTable->data(), newTable->size(), handle);
+        ASSERT_NE(entry, nullptr);
+        auto p = reinterpret_cast<const uint8_t*>(entry);
+        EXPECT_THAT(std::vector<uint8_t>(p, p + expected.size()),
+                    ElementsAreArray(expected));
+    }
 }
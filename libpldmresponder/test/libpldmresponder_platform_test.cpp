@@ -1,5 +1,6 @@
 #include "common/test/mocked_utils.hpp"
 #include "common/utils.hpp"
+#include "libpldm/utils.h"
 #include "libpldmresponder/event_parser.hpp"
 #include "libpldmresponder/pdr.hpp"
 #include "libpldmresponder/pdr_utils.hpp"
@@ -156,6 +157,73 @@ TEST(getPDR, testNoNextRecord)
     pldm_pdr_destroy(pdrRepo);
 }
 
+TEST(getPDR, testMultipart)
+{
+    std::array<uint8_t, sizeof(pldm_msg_hdr) + PLDM_GET_PDR_REQ_BYTES>
+        requestPayload{};
+    auto req = reinterpret_cast<pldm_msg*>(requestPayload.data());
+    size_t requestPayloadLength = requestPayload.size() - sizeof(pldm_msg_hdr);
+
+    struct pldm_get_pdr_req* request =
+        reinterpret_cast<struct pldm_get_pdr_req*>(req->payload);
+    request->record_handle = 1;
+    request->transfer_op_flag = PLDM_GET_FIRSTPART;
+    request->request_count = 4;
+
+    MockdBusHandler mockedUtils;
+    EXPECT_CALL(mockedUtils, getService(StrEq("/foo/bar"), _))
+        .Times(5)
+        .WillRepeatedly(Return("foo.bar"));
+
+    auto pdrRepo = pldm_pdr_init();
+    auto event = sdeventplus::Event::get_default();
+    Handler handler(&mockedUtils, "./pdr_jsons/state_effecter/good", pdrRepo,
+                    nullptr, nullptr, nullptr, nullptr, nullptr, event);
+    Repo repo(pdrRepo);
+    ASSERT_EQ(repo.empty(), false);
+
+    std::vector<uint8_t> pdrData;
+    uint8_t transferFlag = 0;
+    uint8_t transferCRC = 0;
+    do
+    {
+        auto response = handler.getPDR(req, requestPayloadLength);
+        auto responsePtr = reinterpret_cast<pldm_msg*>(response.data());
+        struct pldm_get_pdr_resp* resp =
+            reinterpret_cast<struct pldm_get_pdr_resp*>(responsePtr->payload);
+        ASSERT_EQ(PLDM_SUCCESS, resp->completion_code);
+        ASSERT_EQ(2, resp->next_record_handle);
+        ASSERT_LE(resp->response_count, 4);
+        ASSERT_EQ(pdrData.empty(), resp->transfer_flag == PLDM_START);
+        pdrData.insert(pdrData.end(), resp->record_data,
+                   resp->record_data + resp->response_count);
+        transferFlag = resp->transfer_flag;
+        if (transferFlag == PLDM_END)
+        {
+            transferCRC = resp->record_data[resp->response_count];
+        }
+        request->data_transfer_handle = resp->next_data_transfer_handle;
+        request->transfer_op_flag = PLDM_GET_NEXTPART;
+    } while (transferFlag == PLDM_START || transferFlag == PLDM_MIDDLE);
+
+    ASSERT_EQ(PLDM_END, transferFlag);
+    ASSERT_EQ(crc8(pdrData.data(), pdrData.size()), transferCRC);
+
+    PdrEntry e;
+    auto record = pdr::getRecordByHandle(repo, 1, e);
+    ASSERT_NE(record, nullptr);
+    ASSERT_EQ(pdrData, std::vector<uint8_t>(e.data, e.data + e.size));
+
+    // A transfer handle past the end of the record
+    request->data_transfer_handle = e.size;
+    auto response = handler.getPDR(req, requestPayloadLength);
+    auto responsePtr = reinterpret_cast<pldm_msg*>(response.data());
+    ASSERT_EQ(responsePtr->payload[0],
+              PLDM_PLATFORM_INVALID_DATA_TRANSFER_HANDLE);
+
+    pldm_pdr_destroy(pdrRepo);
+}
+
 TEST(getPDR, testFindPDR)
 {
     std::array<uint8_t, sizeof(pldm_msg_hdr) + PLDM_GET_PDR_REQ_BYTES>
@@ -628,6 +696,44 @@ TEST(getStateSensorReadingsHandler, testGoodRequest)
     pldm_pdr_destroy(outPDRRepo);
 }
 
+TEST(getStateSensorReadingsHandler, testCachedRead)
+{
+    MockdBusHandler mockedUtils;
+    EXPECT_CALL(mockedUtils, getService(StrEq("/foo/bar"), _))
+        .Times(1)
+        .WillRepeatedly(Return("foo.bar"));
+
+    auto inPDRRepo = pldm_pdr_init();
+    auto event = sdeventplus::Event::get_default();
+    Handler handler(&mockedUtils, "./pdr_jsons/state_sensor/good", inPDRRepo,
+                    nullptr, nullptr, nullptr, nullptr, nullptr, event);
+
+    std::vector<get_sensor_state_field> stateField;
+    uint8_t compSensorCnt{};
+    uint8_t sensorRearmCnt = 1;
+
+    // The second reading is served from the property cache
+    MockdBusHandler handlerObj;
+    EXPECT_CALL(handlerObj,
+                getDbusPropertyVariant(StrEq("/foo/bar"), StrEq("propertyName"),
+                                       StrEq("xyz.openbmc_project.Foo.Bar")))
+        .WillOnce(Return(
+            PropertyValue(std::string("xyz.openbmc_project.Foo.Bar.V0"))));
+
+    for (int i = 0; i < 2; ++i)
+    {
+        auto rc = platform_state_sensor::getStateSensorReadingsHandler<
+            MockdBusHandler, Handler>(handlerObj, handler, 0x1, sensorRearmCnt,
+                                      compSensorCnt, stateField);
+        ASSERT_EQ(rc, 0);
+        ASSERT_EQ(compSensorCnt, 1);
+    }
+    EXPECT_EQ(handler.getSensorStateCache().getHits(), 1u);
+    EXPECT_EQ(handler.getSensorStateCache().getMisses(), 1u);
+
+    pldm_pdr_destroy(inPDRRepo);
+}
+
 TEST(getStateSensorReadingsHandler, testBadRequest)
 {
     MockdBusHandler mockedUtils;
@@ -663,3 +769,36 @@ TEST(getStateSensorReadingsHandler, testBadRequest)
     pldm_pdr_destroy(inPDRRepo);
     pldm_pdr_destroy(outPDRRepo);
 }
+
+TEST(getStateSensorPDR, tracksRepo)
+{
+    MockdBusHandler mockedUtils;
+    EXPECT_CALL(mockedUtils, getService(StrEq("/foo/bar"), _))
+        .Times(1)
+        .WillRepeatedly(Return("foo.bar"));
+
+    auto inPDRRepo = pldm_pdr_init();
+    auto event = sdeventplus::Event::get_default();
+    Handler handler(&mockedUtils, "./pdr_jsons/state_sensor/good", inPDRRepo,
+                    nullptr, nullptr, nullptr, nullptr, nullptr, event);
+
+    auto pdr = handler.getStateSensorPDR(0x1);
+    ASSERT_NE(pdr, nullptr);
+    EXPECT_EQ(pdr->hdr.type, PLDM_STATE_SENSOR_PDR);
+    EXPECT_EQ(pdr->sensor_id, 0x1);
+    EXPECT_EQ(handler.getStateEffecterPDR(0x1), nullptr);
+    EXPECT_EQ(handler.getNumericEffecterPDR(0x1), nullptr);
+
+    pldm_delete_by_sensor_id(inPDRRepo, 0x1, false);
+    EXPECT_EQ(handler.getStateSensorPDR(0x1), nullptr);
+
+    std::vector<get_sensor_state_field> stateField;
+    uint8_t compSensorCnt{};
+    MockdBusHandler handlerObj;
+    auto rc = platform_state_sensor::getStateSensorReadingsHandler<
+        MockdBusHandler, Handler>(handlerObj, handler, 0x1, 1, compSensorCnt,
+                                  stateField);
+    ASSERT_EQ(rc, PLDM_PLATFORM_INVALID_SENSOR_ID);
+
+    pldm_pdr_destroy(inPDRRepo);
+}
@@ -10,15 +10,19 @@
 #include "xyz/openbmc_project/Common/error.hpp"
 
 #include <fcntl.h>
+#include <poll.h>
 #include <sys/mman.h>
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <unistd.h>
 
+#include <algorithm>
+#include <atomic>
 #include <cstring>
 #include <fstream>
 #include <iostream>
 #include <memory>
+#include <semaphore>
 #include <thread>
 
 namespace pldm
@@ -33,185 +37,257 @@ namespace fs = std::filesystem;
 namespace dma
 {
 
-/** @struct AspeedXdmaOp
- *
- * Structure representing XDMA operation
- */
-struct AspeedXdmaOp
+constexpr auto xdmaDev = "/dev/aspeed-xdma";
+
+XdmaSession::~XdmaSession()
 {
-    uint64_t hostAddr; //!< the DMA address on the host side, configured by
-                       //!< PCI subsystem.
-    uint32_t len;      //!< the size of the transfer in bytes, it should be a
-                       //!< multiple of 16 bytes
-    uint32_t upstream; //!< boolean indicating the direction of the DMA
-                       //!< operation, true means a transfer from BMC to host.
-};
+    if (vgaMem)
+    {
+        munmap(vgaMem, windowSize(maxTransfer));
+    }
+    if (xdmaFd >= 0)
+    {
+        close(xdmaFd);
+    }
+}
 
-constexpr auto xdmaDev = "/dev/aspeed-xdma";
+XdmaSession& XdmaSession::get()
+{
+    static XdmaSession session;
+    return session;
+}
 
-int DMA::transferHostDataToSocket(int fd, uint32_t length, uint64_t address)
+size_t XdmaSession::windowSize(size_t maxTransfer)
 {
-    socketWriteStatus = NotReady;
     static const size_t pageSize = getpagesize();
-    uint32_t numPages = length / pageSize;
-    uint32_t pageAlignedLength = numPages * pageSize;
+    return (maxTransfer + pageSize - 1) / pageSize * pageSize;
+}
 
-    if (length > pageAlignedLength)
+int XdmaSession::map()
+{
+    if (busy && waitIdle() < 0)
     {
-        pageAlignedLength += pageSize;
+        return -EBUSY;
     }
-    int dmaFd = -1;
-    int rc = 0;
-    dmaFd = open(xdmaDev, O_RDWR);
-    if (dmaFd < 0)
+    if (vgaMem)
     {
-        rc = -errno;
-        std::cerr
-            << "transferHostDataToSocket : Failed to open the XDMA device, RC="
-            << rc << "\n";
-        return rc;
+        return 0;
     }
 
-    pldm::utils::CustomFD xdmaFd(dmaFd);
-    void* vgaMemDump = NULL;
-    vgaMemDump =
-        mmap(nullptr, pageAlignedLength, PROT_READ, MAP_SHARED, xdmaFd(), 0);
-    if (MAP_FAILED == vgaMemDump)
+    if (xdmaFd < 0)
     {
-        rc = -errno;
-        std::cerr
-            << "transferHostDataToSocket : Failed to mmap the XDMA device, RC="
-            << rc << "\n";
+        xdmaFd = open(xdmaDev, O_RDWR | O_CLOEXEC);
+        if (xdmaFd < 0)
+        {
+            auto rc = -errno;
+            std::cerr << "Failed to open the XDMA device, RC=" << rc << "\n";
+            return rc;
+        }
+    }
+
+    auto mem = mmap(nullptr, windowSize(maxTransfer), PROT_READ | PROT_WRITE,
+                    MAP_SHARED, xdmaFd, 0);
+    if (MAP_FAILED == mem)
+    {
+        auto rc = -errno;
+        std::cerr << "Failed to mmap the XDMA device, RC=" << rc << "\n";
         return rc;
     }
+    vgaMem = mem;
+
+    return 0;
+}
 
+int XdmaSession::transfer(uint64_t address, uint32_t length, bool upstream)
+{
     AspeedXdmaOp xdmaOp;
-    xdmaOp.upstream = 0;
+    xdmaOp.upstream = upstream ? 1 : 0;
     xdmaOp.hostAddr = address;
     xdmaOp.len = length;
 
-    rc = write(xdmaFd(), &xdmaOp, sizeof(xdmaOp));
-    if (rc < 0)
+    if (write(xdmaFd, &xdmaOp, sizeof(xdmaOp)) < 0)
     {
-        rc = -errno;
-        std::cerr
-            << "transferHostDataToSocket : Failed to execute the DMA operation, RC="
-            << rc << " ADDRESS=" << address << " LENGTH=" << length << "\n";
-        if (rc != -EINTR)
-        {
-            munmap(vgaMemDump, pageAlignedLength);
-        }
-        else
+        auto rc = -errno;
+        if (rc == -EINTR)
         {
-            std::cerr
-                << "transferHostDataToSocket : Received interrupt during dump DMA transfer. Skipping Unmap"
-                << std::endl;
+            // The engine may still be carrying the operation out
+            busy = true;
+            waitIdle();
         }
         return rc;
     }
 
-    std::thread dumpOffloadThread(writeToUnixSocket, fd,
-                                  static_cast<const char*>(vgaMemDump), length);
-    dumpOffloadThread.detach();
+    return 0;
+}
 
+int XdmaSession::waitIdle()
+{
+    constexpr int idleTimeoutMs = 5000;
+    struct pollfd pfd = {xdmaFd, POLLIN, 0};
+    auto rc = poll(&pfd, 1, idleTimeoutMs);
+    while (rc < 0 && errno == EINTR)
+    {
+        rc = poll(&pfd, 1, idleTimeoutMs);
+    }
+    if (rc <= 0)
+    {
+        std::cerr << "XDMA engine still busy after an interrupted operation, "
+                  << "RC=" << (rc ? -errno : 0) << "\n";
+        return -EBUSY;
+    }
+
+    busy = false;
     return 0;
 }
 
-int DMA::transferDataHost(int fd, uint32_t offset, uint32_t length,
-                          uint64_t address, bool upstream)
+int DMA::transferHostDataToSocket(int fd, uint32_t length, uint64_t address)
 {
-    static const size_t pageSize = getpagesize();
-    uint32_t numPages = length / pageSize;
-    uint32_t pageAlignedLength = numPages * pageSize;
+    socketWriteStatus = NotReady;
+    if (length > session.maxTransferSize())
+    {
+        std::cerr << "transferHostDataToSocket : length exceeds the DMA "
+                     "window, LENGTH="
+                  << length << "\n";
+        return -EINVAL;
+    }
 
-    if (length > pageAlignedLength)
+    // The data leaves the window before the socket is written, the socket
+    // writer thread unmaps this buffer when it is done
+    void* buffer = mmap(nullptr, length, PROT_READ | PROT_WRITE,
+                        MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (MAP_FAILED == buffer)
     {
-        pageAlignedLength += pageSize;
+        int rc = -errno;
+        std::cerr << "transferHostDataToSocket : Failed to allocate the "
+                     "socket buffer, RC="
+                  << rc << " LENGTH=" << length << "\n";
+        return rc;
     }
-    int rc = 0;
-    auto mmapCleanup = [pageAlignedLength, &rc](void* vgaMem) {
-        if (rc != -EINTR)
+
+    {
+        auto lock = session.lock();
+        int rc = session.map();
+        if (rc == 0)
         {
-            munmap(vgaMem, pageAlignedLength);
+            rc = session.transfer(address, length, false);
         }
-        else
+        if (rc < 0)
         {
-            std::cerr
-                << "Received interrupt during DMA transfer. Skipping Unmap"
-                << std::endl;
+            std::cerr << "transferHostDataToSocket : Failed to execute the "
+                         "DMA operation, RC="
+                      << rc << " ADDRESS=" << address << " LENGTH=" << length
+                      << "\n";
+            munmap(buffer, length);
+            return rc;
         }
-    };
-
-    int dmaFd = -1;
-    dmaFd = open(xdmaDev, O_RDWR);
-    if (dmaFd < 0)
-    {
-        rc = -errno;
-        std::cerr << "transferDataHost : Failed to open the XDMA device, RC="
-                  << rc << "\n";
-        return rc;
+        memcpy(buffer, session.window(), length);
     }
 
-    pldm::utils::CustomFD xdmaFd(dmaFd);
+    std::thread dumpOffloadThread(writeToUnixSocket, fd,
+                                  static_cast<const char*>(buffer), length);
+    dumpOffloadThread.detach();
 
-    void* vgaMem;
-    vgaMem = mmap(nullptr, pageAlignedLength, upstream ? PROT_WRITE : PROT_READ,
-                  MAP_SHARED, xdmaFd(), 0);
-    if (MAP_FAILED == vgaMem)
-    {
-        rc = -errno;
-        std::cerr << "transferDataHost : Failed to mmap the XDMA device, RC="
-                  << rc << "\n";
-        return rc;
-    }
+    return 0;
+}
 
-    std::unique_ptr<void, decltype(mmapCleanup)> vgaMemPtr(vgaMem, mmapCleanup);
+namespace
+{
 
-    if (upstream)
+/** @brief Read a chunk of a file into a DMA window
+ *
+ * @return returns 0 on success, -1 on failure
+ */
+int readChunk(int fd, char* window, uint32_t offset, uint32_t length)
+{
+    uint32_t count = 0;
+    while (count < length)
     {
-        rc = lseek(fd, offset, SEEK_SET);
-        if (rc == -1)
+        auto n = pread(fd, window + count, length - count, offset + count);
+        if (n < 0 && errno == EINTR)
         {
-            std::cerr << "transferDataHost upstream : lseek failed, ERROR="
-                      << errno << ", UPSTREAM=" << upstream
-                      << ", OFFSET=" << offset << "\n";
-            return rc;
+            continue;
         }
+        if (n < 0)
+        {
+            std::cerr << "DMA upstream : file read failed, ERROR=" << errno
+                      << ", LENGTH=" << length << ", OFFSET=" << offset
+                      << "\n";
+            return -1;
+        }
+        if (n == 0)
+        {
+            break;
+        }
+        count += n;
+    }
+    if (count != length)
+    {
+        std::cerr << "DMA upstream : mismatch between number of characters to "
+                  << "read and the length read, LENGTH=" << length
+                  << " COUNT=" << count << "\n";
+        return -1;
+    }
+
+    return 0;
+}
 
-        // Writing to the VGA memory should be aligned at page boundary,
-        // otherwise write data into a buffer aligned at page boundary and
-        // then write to the VGA memory.
-        std::vector<char> buffer{};
-        buffer.resize(pageAlignedLength);
-        rc = read(fd, buffer.data(), length);
-        if (rc == -1)
+/** @brief Write a chunk of a file from a DMA window
+ *
+ * @return returns 0 on success, -1 on failure
+ */
+int writeChunk(int fd, const char* window, uint32_t offset, uint32_t length)
+{
+    uint32_t count = 0;
+    while (count < length)
+    {
+        auto n = pwrite(fd, window + count, length - count, offset + count);
+        if (n < 0 && errno == EINTR)
         {
-            std::cerr << "transferDataHost upstream : file read failed, ERROR="
-                      << errno << ", UPSTREAM=" << upstream
-                      << ", LENGTH=" << length << ", OFFSET=" << offset << "\n";
-            return rc;
+            continue;
         }
-        if (rc != static_cast<int>(length))
+        if (n < 0)
         {
-            std::cerr
-                << "transferDataHost upstream : mismatch between number of characters to read and "
-                << "the length read, LENGTH=" << length << " COUNT=" << rc
-                << "\n";
+            std::cerr << "DMA downstream : file write failed, ERROR=" << errno
+                      << ", LENGTH=" << length << ", OFFSET=" << offset
+                      << "\n";
             return -1;
         }
-        memcpy(static_cast<char*>(vgaMemPtr.get()), buffer.data(),
-               pageAlignedLength);
+        count += n;
     }
 
-    AspeedXdmaOp xdmaOp;
-    xdmaOp.upstream = upstream ? 1 : 0;
-    xdmaOp.hostAddr = address;
-    xdmaOp.len = length;
+    return 0;
+}
+
+} // namespace
+
+int DMA::transferDataHost(int fd, uint32_t offset, uint32_t length,
+                          uint64_t address, bool upstream)
+{
+    if (length > session.maxTransferSize())
+    {
+        std::cerr << "transferDataHost : length exceeds the DMA window, LENGTH="
+                  << length << "\n";
+        return -EINVAL;
+    }
+
+    auto lock = session.lock();
+    int rc = session.map();
+    if (rc < 0)
+    {
+        std::cerr << "transferDataHost : Failed to map the XDMA device, RC="
+                  << rc << "\n";
+        return rc;
+    }
+
+    // Read the file straight into the window
+    if (upstream && readChunk(fd, session.window(), offset, length) < 0)
+    {
+        return -1;
+    }
 
-    rc = write(xdmaFd(), &xdmaOp, sizeof(xdmaOp));
+    rc = session.transfer(address, length, upstream);
     if (rc < 0)
     {
-        rc = -errno;
         std::cerr
             << "transferDataHost : Failed to execute the DMA operation, RC="
             << rc << " UPSTREAM=" << upstream << " ADDRESS=" << address
@@ -219,26 +295,140 @@ int DMA::transferDataHost(int fd, uint32_t offset, uint32_t length,
         return rc;
     }
 
-    if (!upstream)
+    if (!upstream && writeChunk(fd, session.window(), offset, length) < 0)
+    {
+        return -1;
+    }
+
+    return 0;
+}
+
+Pipeline& Pipeline::get()
+{
+    static Pipeline pipeline(XdmaSession::get());
+    return pipeline;
+}
+
+int Pipeline::transfer(int fd, uint32_t offset, uint32_t length,
+                       uint64_t address, bool upstream)
+{
+    std::lock_guard lock(mutex);
+
+    uint32_t chunkSize = session.maxTransferSize();
+    size_t chunks = (static_cast<size_t>(length) + chunkSize - 1) / chunkSize;
+    auto chunkLength = [=](size_t i) {
+        return std::min<uint32_t>(chunkSize, length - i * chunkSize);
+    };
+
+    if (chunks == 0)
     {
-        rc = lseek(fd, offset, SEEK_SET);
-        if (rc == -1)
+        return 0;
+    }
+    if (chunks == 1)
+    {
+        return DMA(session).transferDataHost(fd, offset, length, address,
+                                             upstream);
+    }
+
+    // The buffer holds one chunk at a time. Upstream it is filled by the
+    // file I/O and drained into the window, downstream it is filled from
+    // the window and drained by the file I/O. A failing stage wakes up the
+    // other one to stop it.
+    auto buffer = std::make_unique_for_overwrite<char[]>(chunkSize);
+    std::counting_semaphore<2> empty(1);
+    std::counting_semaphore<2> full(0);
+    std::binary_semaphore ioDone(0);
+    std::atomic<bool> failed = false;
+    int ioRc = 0;
+    io.post([&] {
+        for (size_t i = 0; i < chunks && !failed; ++i)
         {
-            std::cerr << "transferDataHost downstream : lseek failed, ERROR="
-                      << errno << ", UPSTREAM=" << upstream
-                      << ", OFFSET=" << offset << "\n";
-            return rc;
+            auto chunkOffset = offset + i * chunkSize;
+            if (upstream)
+            {
+                empty.acquire();
+                if (failed)
+                {
+                    break;
+                }
+                ioRc = readChunk(fd, buffer.get(), chunkOffset,
+                                 chunkLength(i));
+                if (ioRc < 0)
+                {
+                    failed = true;
+                }
+                full.release();
+            }
+            else
+            {
+                full.acquire();
+                if (failed)
+                {
+                    break;
+                }
+                ioRc = writeChunk(fd, buffer.get(), chunkOffset,
+                                  chunkLength(i));
+                if (ioRc < 0)
+                {
+                    failed = true;
+                }
+                empty.release();
+            }
         }
-        rc = write(fd, static_cast<const char*>(vgaMemPtr.get()), length);
-        if (rc == -1)
+        ioDone.release();
+    });
+
+    // The DMA of each chunk runs here
+    int dmaRc = 0;
+    for (size_t i = 0; i < chunks && !failed; ++i)
+    {
+        auto chunkAddress = address + i * chunkSize;
+        if (upstream)
         {
-            std::cerr
-                << "transferDataHost downstream : file write failed, ERROR="
-                << errno << ", UPSTREAM=" << upstream << ", LENGTH=" << length
-                << ", OFFSET=" << offset << "\n";
-            return rc;
+            full.acquire();
+            if (failed)
+            {
+                break;
+            }
+        }
+
+        auto windowLock = session.lock();
+        dmaRc = session.map();
+        if (dmaRc == 0 && upstream)
+        {
+            memcpy(session.window(), buffer.get(), chunkLength(i));
+            empty.release();
+            dmaRc = session.transfer(chunkAddress, chunkLength(i), true);
+        }
+        else if (dmaRc == 0)
+        {
+            dmaRc = session.transfer(chunkAddress, chunkLength(i), false);
+            if (dmaRc == 0)
+            {
+                empty.acquire();
+                if (failed)
+                {
+                    break;
+                }
+                memcpy(buffer.get(), session.window(), chunkLength(i));
+                full.release();
+            }
+        }
+        if (dmaRc < 0)
+        {
+            failed = true;
+            (upstream ? empty : full).release();
         }
     }
+    ioDone.acquire();
+
+    if (ioRc < 0 || dmaRc < 0)
+    {
+        std::cerr << "Pipelined DMA transfer failed, RC="
+                  << (ioRc < 0 ? ioRc : dmaRc) << " UPSTREAM=" << upstream
+                  << " ADDRESS=" << address << " LENGTH=" << length << "\n";
+        return ioRc < 0 ? ioRc : dmaRc;
+    }
 
     return 0;
 }
@@ -323,11 +513,8 @@ Response Handler::readFileIntoMemory(const pldm_msg* request,
         return response;
     }
 
-    using namespace dma;
-    DMA intf;
-    return transferAll<DMA>(&intf, PLDM_READ_FILE_INTO_MEMORY, value.fsPath,
-                            offset, length, address, true,
-                            request->hdr.instance_id);
+    return transferFileMemory(PLDM_READ_FILE_INTO_MEMORY, value.fsPath, offset,
+                              length, address, true, request->hdr.instance_id);
 }
 
 Response Handler::writeFileFromMemory(const pldm_msg* request,
@@ -400,11 +587,60 @@ Response Handler::writeFileFromMemory(const pldm_msg* request,
         return response;
     }
 
-    using namespace dma;
-    DMA intf;
-    return transferAll<DMA>(&intf, PLDM_WRITE_FILE_FROM_MEMORY, value.fsPath,
-                            offset, length, address, false,
-                            request->hdr.instance_id);
+    return transferFileMemory(PLDM_WRITE_FILE_FROM_MEMORY, value.fsPath,
+                              offset, length, address, false,
+                              request->hdr.instance_id);
+}
+
+Response Handler::transferFileMemory(uint8_t command, const fs::path& path,
+                                     uint32_t offset, uint32_t length,
+                                     uint64_t address, bool upstream,
+                                     uint8_t instanceId)
+{
+    return respondFromWorker([command, path, offset, length, address,
+                              upstream, instanceId]() {
+        if (!Worker::onWorkerThread())
+        {
+            // Answered right away, one DMA operation at a time
+            dma::DMA xdmaInterface;
+            return dma::transferAll<dma::DMA>(&xdmaInterface, command, path,
+                                              offset, length, address,
+                                              upstream, instanceId);
+        }
+
+        Response response(sizeof(pldm_msg_hdr) + PLDM_RW_FILE_MEM_RESP_BYTES,
+                          0);
+        auto responsePtr = reinterpret_cast<pldm_msg*>(response.data());
+        int flags{};
+        if (upstream)
+        {
+            flags = O_RDONLY;
+        }
+        else if (fs::exists(path))
+        {
+            flags = O_RDWR;
+        }
+        else
+        {
+            flags = O_WRONLY;
+        }
+        pldm::utils::CustomFD file(open(path.string().c_str(), flags));
+        if (file() == -1)
+        {
+            std::cerr << "File does not exist, path = " << path.string()
+                      << "\n";
+            encode_rw_file_memory_resp(instanceId, command, PLDM_ERROR, 0,
+                                       responsePtr);
+            return response;
+        }
+
+        auto rc = dma::Pipeline::get().transfer(file(), offset, length,
+                                                address, upstream);
+        encode_rw_file_memory_resp(instanceId, command,
+                                   rc < 0 ? PLDM_ERROR : PLDM_SUCCESS,
+                                   rc < 0 ? 0 : length, responsePtr);
+        return response;
+    });
 }
 
 Response Handler::getFileTable(const pldm_msg* request, size_t payloadLength)
@@ -443,8 +679,8 @@ Response Handler::getFileTable(const pldm_msg* request, size_t payloadLength)
     }
 
     using namespace pldm::filetable;
-    auto table = buildFileTable(FILE_TABLE_JSON);
-    auto attrTable = table();
+    auto& table = buildFileTable(FILE_TABLE_JSON);
+    const auto& attrTable = table();
     response.resize(response.size() + attrTable.size());
     responsePtr = reinterpret_cast<pldm_msg*>(response.data());
 
@@ -617,9 +853,8 @@ Response Handler::writeFile(const pldm_msg* request, size_t payloadLength)
     return response;
 }
 
-Response rwFileByTypeIntoMemory(uint8_t cmd, const pldm_msg* request,
-                                size_t payloadLength,
-                                oem_platform::Handler* oemPlatformHandler)
+Response Handler::rwFileByTypeIntoMemory(uint8_t cmd, const pldm_msg* request,
+                                         size_t payloadLength)
 {
     Response response(
         sizeof(pldm_msg_hdr) + PLDM_RW_FILE_BY_TYPE_MEM_RESP_BYTES, 0);
@@ -671,6 +906,41 @@ Response rwFileByTypeIntoMemory(uint8_t cmd, const pldm_msg* request,
         return response;
     }
 
+    std::function<int(uint32_t&)> work;
+    if (cmd == PLDM_READ_FILE_BY_TYPE_INTO_MEMORY)
+    {
+        if (auto path = handler->memoryReadPath(oemPlatformHandler))
+        {
+            work = [handler = handler.get(), path = std::move(*path), offset,
+                    address](uint32_t& length) {
+                return handler->transferFileData(path, true, offset, length,
+                                                 address);
+            };
+        }
+    }
+    else if (auto job = handler->memoryWriteJob(offset, length, address,
+                                                oemPlatformHandler))
+    {
+        work = [job = std::move(job)](uint32_t&) { return job(); };
+    }
+    if (work)
+    {
+        // Nothing but file I/O and DMA, it runs on the worker
+        return respondFromWorker(
+            [handler = std::shared_ptr<FileHandler>(std::move(handler)),
+             work = std::move(work), length,
+             instanceId = request->hdr.instance_id, cmd]() mutable {
+                Response response(
+                    sizeof(pldm_msg_hdr) + PLDM_RW_FILE_BY_TYPE_MEM_RESP_BYTES,
+                    0);
+                auto rc = work(length);
+                encode_rw_file_by_type_memory_resp(
+                    instanceId, cmd, rc, length,
+                    reinterpret_cast<pldm_msg*>(response.data()));
+                return response;
+            });
+    }
+
     rc = cmd == PLDM_WRITE_FILE_BY_TYPE_FROM_MEMORY
              ? handler->writeFromMemory(offset, length, address,
                                         oemPlatformHandler)
@@ -685,14 +955,14 @@ Response Handler::writeFileByTypeFromMemory(const pldm_msg* request,
                                             size_t payloadLength)
 {
     return rwFileByTypeIntoMemory(PLDM_WRITE_FILE_BY_TYPE_FROM_MEMORY, request,
-                                  payloadLength, oemPlatformHandler);
+                                  payloadLength);
 }
 
 Response Handler::readFileByTypeIntoMemory(const pldm_msg* request,
                                            size_t payloadLength)
 {
     return rwFileByTypeIntoMemory(PLDM_READ_FILE_BY_TYPE_INTO_MEMORY, request,
-                                  payloadLength, oemPlatformHandler);
+                                  payloadLength);
 }
 
 Response Handler::writeFileByType(const pldm_msg* request, size_t payloadLength)
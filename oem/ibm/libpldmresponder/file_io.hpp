@@ -10,6 +10,7 @@
 #include "oem/ibm/requester/dbus_to_file_handler.hpp"
 #include "oem_ibm_handler.hpp"
 #include "pldmd/handler.hpp"
+#include "pldmd/worker.hpp"
 #include "requester/handler.hpp"
 
 #include <fcntl.h>
@@ -20,6 +21,8 @@
 
 #include <filesystem>
 #include <iostream>
+#include <memory>
+#include <mutex>
 #include <vector>
 
 namespace pldm
@@ -36,6 +39,182 @@ constexpr size_t maxSize = DMA_MAXSIZE;
 
 namespace fs = std::filesystem;
 
+/** @struct AspeedXdmaOp
+ *
+ * Structure representing XDMA operation
+ */
+struct AspeedXdmaOp
+{
+    uint64_t hostAddr; //!< the DMA address on the host side, configured by
+                       //!< PCI subsystem.
+    uint32_t len;      //!< the size of the transfer in bytes, it should be a
+                       //!< multiple of 16 bytes
+    uint32_t upstream; //!< boolean indicating the direction of the DMA
+                       //!< operation, true means a transfer from BMC to host.
+};
+
+/**
+ * @class XdmaSession
+ *
+ * Keeps the XDMA device open and its VGA memory window mapped across DMA
+ * operations, rather than opening and mapping the device for every chunk.
+ *
+ * The driver always DMAs from the start of the window, and the window comes
+ * out of memory reserved for the VGA device, so the daemon has a single
+ * session that every DMA goes through. An operation locks the window from
+ * filling it to draining it.
+ *
+ * The window stays mapped for the lifetime of the session, so an operation
+ * interrupted by a signal (EINTR), which the engine may still be carrying
+ * out, never targets unmapped memory. The driver only serializes the next
+ * operation behind it, not CPU access to the window, so the session then
+ * polls the device until the engine is idle. While it is not, map() fails
+ * and the window must not be used.
+ */
+class XdmaSession
+{
+  public:
+    /** @brief Open the XDMA device on first use */
+    XdmaSession() = default;
+
+    /** @brief Use an already open device
+     *
+     * A regular file of at least windowSize() bytes, opened with
+     * O_RDWR | O_APPEND, stands in for the device in tests: the window maps
+     * the start of the file and every operation is appended after it.
+     *
+     * @param[in] deviceFd - descriptor of the device, owned by the session,
+     *                       -1 to open the XDMA device on first use
+     * @param[in] maxTransfer - largest DMA operation of the session
+     */
+    explicit XdmaSession(int deviceFd, size_t maxTransfer = maxSize) :
+        xdmaFd(deviceFd), maxTransfer(maxTransfer)
+    {}
+
+    XdmaSession(const XdmaSession&) = delete;
+    XdmaSession& operator=(const XdmaSession&) = delete;
+    XdmaSession(XdmaSession&&) = delete;
+    XdmaSession& operator=(XdmaSession&&) = delete;
+    ~XdmaSession();
+
+    /** @brief The session every DMA of the daemon goes through */
+    static XdmaSession& get();
+
+    /** @brief Size of the window for DMA operations of up to maxTransfer
+     *         bytes, rounded up to a page
+     */
+    static size_t windowSize(size_t maxTransfer = maxSize);
+
+    /** @brief Largest DMA operation of the session */
+    size_t maxTransferSize() const
+    {
+        return maxTransfer;
+    }
+
+    /** @brief Lock the window for one DMA operation, held from filling the
+     *         window to draining it
+     */
+    std::unique_lock<std::mutex> lock()
+    {
+        return std::unique_lock(windowMutex);
+    }
+
+    /** @brief Open the device and map the window, unless already done,
+     *         and check that no interrupted operation still uses it
+     *
+     * @return returns 0 on success, negative errno on failure
+     */
+    int map();
+
+    /** @brief The window, nullptr until map() succeeds */
+    char* window() const
+    {
+        return static_cast<char*>(vgaMem);
+    }
+
+    /** @brief Descriptor of the device, -1 until map() opens it */
+    int fd() const
+    {
+        return xdmaFd;
+    }
+
+    /** @brief Run a DMA operation between the window and the host
+     *
+     * @param[in] address  - DMA address on the host
+     * @param[in] length   - length of the data to transfer
+     * @param[in] upstream - indicates direction of the transfer; true
+     *                       indicates transfer to the host
+     *
+     * @return returns 0 on success, negative errno on failure; -EINTR for
+     *         an interrupted operation once the engine is done with it or
+     *         the wait for it timed out
+     */
+    int transfer(uint64_t address, uint32_t length, bool upstream);
+
+  private:
+    /** @brief Wait for the engine to be done with an interrupted operation
+     *
+     * @return returns 0 once idle, -EBUSY on timeout
+     */
+    int waitIdle();
+
+    int xdmaFd = -1;
+    size_t maxTransfer = maxSize;
+    void* vgaMem = nullptr;
+    /** @brief An interrupted operation may still be using the window */
+    bool busy = false;
+    std::mutex windowMutex;
+};
+
+/**
+ * @class Pipeline
+ *
+ * Transfers data between a file and the host in chunks of the DMA size,
+ * overlapping the file I/O of a chunk with the DMA of the one before.
+ *
+ * The driver DMAs from the start of the window, so the chunks are staged in
+ * a buffer. Upstream, the next chunk is read from the file into the buffer
+ * while the window is DMAed to the host. Downstream, a chunk is written to
+ * the file from the buffer while the next one is DMAed into the window. The
+ * file I/O runs on a thread of the pipeline, and the window is locked for
+ * one chunk at a time, so other DMAs get it in between.
+ */
+class Pipeline
+{
+  public:
+    /** @brief Transfer through a session
+     *
+     * @param[in] session - XDMA session, e.g. one over a mock device
+     */
+    explicit Pipeline(XdmaSession& session) : session(session)
+    {}
+
+    /** @brief The pipeline on the session of the daemon */
+    static Pipeline& get();
+
+    /** @brief Transfer data between a file and the host
+     *
+     * Thread safe, transfers go through the pipeline one at a time.
+     *
+     * @param[in] fd       - file descriptor of the file
+     * @param[in] offset   - offset in the file
+     * @param[in] length   - length of the data to transfer
+     * @param[in] address  - DMA address on the host
+     * @param[in] upstream - indicates direction of the transfer; true
+     *                       indicates transfer to the host
+     *
+     * @return returns 0 on success, negative errno on failure
+     */
+    int transfer(int fd, uint32_t offset, uint32_t length, uint64_t address,
+                 bool upstream);
+
+  private:
+    XdmaSession& session;
+    std::mutex mutex;
+    /** @brief Runs the file I/O of the chunks */
+    Worker io;
+};
+
 /**
  * @class DMA
  *
@@ -48,6 +227,17 @@ namespace fs = std::filesystem;
 class DMA
 {
   public:
+    /** @brief Transfer through the session of the daemon */
+    DMA() : session(XdmaSession::get())
+    {}
+
+    /** @brief Transfer through the given session
+     *
+     * @param[in] session - XDMA session, e.g. one over a mock device
+     */
+    explicit DMA(XdmaSession& session) : session(session)
+    {}
+
     /** @brief API to transfer data between BMC and host using DMA
      *
      * @param[in] path     - pathname of the file to transfer data from or to
@@ -63,6 +253,9 @@ class DMA
                          uint64_t address, bool upstream);
 
     /** @brief API to transfer data on to unix socket from host using DMA
+     *
+     * The data is copied out of the window, and written to the socket on a
+     * thread of its own.
      *
      * @param[in] path     - pathname of the file to transfer data from or to
      * @param[in] length   - length of the data to transfer
@@ -71,6 +264,9 @@ class DMA
      * @return returns 0 on success, negative errno on failure
      */
     int transferHostDataToSocket(int fd, uint32_t length, uint64_t address);
+
+  private:
+    XdmaSession& session;
 };
 
 /** @brief Transfer the data between BMC and host using DMA.
@@ -93,9 +289,9 @@ class DMA
  */
 
 template <class DMAInterface>
-Response transferAll(DMAInterface* intf, uint8_t command, fs::path& path,
-                     uint32_t offset, uint32_t length, uint64_t address,
-                     bool upstream, uint8_t instanceId)
+Response transferAll(DMAInterface* intf, uint8_t command,
+                     const fs::path& path, uint32_t offset, uint32_t length,
+                     uint64_t address, bool upstream, uint8_t instanceId)
 {
     uint32_t origLength = length;
     Response response(sizeof(pldm_msg_hdr) + PLDM_RW_FILE_MEM_RESP_BYTES, 0);
@@ -480,6 +676,41 @@ class Handler : public CmdHandler
                                           size_t payloadLength);
 
   private:
+    /** @brief Handler for the readFileByTypeIntoMemory and
+     *         writeFileByTypeFromMemory commands
+     *
+     *  @param[in] cmd - PLDM command
+     *  @param[in] request - pointer to PLDM request payload
+     *  @param[in] payloadLength - length of the message
+     *
+     *  @return PLDM response message, empty if it is deferred
+     */
+    Response rwFileByTypeIntoMemory(uint8_t cmd, const pldm_msg* request,
+                                    size_t payloadLength);
+
+    /** @brief Transfer a file to or from host memory, for the
+     *         readFileIntoMemory and writeFileFromMemory commands
+     *
+     *  The transfer runs through the DMA pipeline on the worker and the
+     *  response is deferred, unless responses can't be deferred.
+     *
+     *  @param[in] command  - PLDM command
+     *  @param[in] path     - pathname of the file to transfer data from or to
+     *  @param[in] offset   - offset in the file
+     *  @param[in] length   - length of the data to transfer
+     *  @param[in] address  - DMA address on the host
+     *  @param[in] upstream - indicates direction of the transfer; true
+     *                        indicates transfer to the host
+     *  @param[in] instanceId - Message's instance id
+     *
+     *  @return PLDM response message, empty if it is deferred
+     */
+    Response transferFileMemory(uint8_t command,
+                                const std::filesystem::path& path,
+                                uint32_t offset, uint32_t length,
+                                uint64_t address, bool upstream,
+                                uint8_t instanceId);
+
     oem_platform::Handler* oemPlatformHandler;
     int hostSockFd;
     uint8_t hostEid;
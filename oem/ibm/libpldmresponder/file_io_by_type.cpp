@@ -13,6 +13,7 @@
 #include "file_io_type_pcie.hpp"
 #include "file_io_type_pel.hpp"
 #include "file_io_type_progress_src.hpp"
+#include "pldmd/worker.hpp"
 #include "xyz/openbmc_project/Common/error.hpp"
 
 #include <stdint.h>
@@ -20,6 +21,7 @@
 
 #include <xyz/openbmc_project/Logging/Entry/server.hpp>
 
+#include <algorithm>
 #include <exception>
 #include <filesystem>
 #include <fstream>
@@ -36,22 +38,33 @@ using namespace sdbusplus::xyz::openbmc_project::Common::Error;
 int FileHandler::transferFileData(int32_t fd, bool upstream, uint32_t offset,
                                   uint32_t& length, uint64_t address)
 {
+    // The pipeline is held for the whole of a transfer, so the event loop
+    // never waits on it behind the worker. It goes one DMA operation at a
+    // time, and only waits for the window between the chunks of a worker
+    // transfer.
+    if (Worker::onWorkerThread())
+    {
+        auto rc = dma::Pipeline::get().transfer(fd, offset, length, address,
+                                                upstream);
+        return rc < 0 ? PLDM_ERROR : PLDM_SUCCESS;
+    }
+
     dma::DMA xdmaInterface;
-    while (length > dma::maxSize)
+    uint32_t remaining = length;
+    while (remaining > 0)
     {
-        auto rc = xdmaInterface.transferDataHost(fd, offset, dma::maxSize,
-                                                 address, upstream);
+        auto chunk = std::min<uint32_t>(remaining, dma::maxSize);
+        auto rc = xdmaInterface.transferDataHost(fd, offset, chunk, address,
+                                                 upstream);
         if (rc < 0)
         {
             return PLDM_ERROR;
         }
-        offset += dma::maxSize;
-        length -= dma::maxSize;
-        address += dma::maxSize;
+        offset += chunk;
+        address += chunk;
+        remaining -= chunk;
     }
-    auto rc =
-        xdmaInterface.transferDataHost(fd, offset, length, address, upstream);
-    return rc < 0 ? PLDM_ERROR : PLDM_SUCCESS;
+    return PLDM_SUCCESS;
 }
 
 int FileHandler::transferFileDataToSocket(int32_t fd, uint32_t& length,
@@ -2,6 +2,9 @@
 
 #include "file_io.hpp"
 
+#include <functional>
+#include <optional>
+
 namespace pldm
 {
 
@@ -46,6 +49,38 @@ class FileHandler
                                uint64_t address,
                                oem_platform::Handler* oemPlatformHandler) = 0;
 
+    /** @brief Path of the file readIntoMemory transfers, for file types
+     *  whose read into host memory is nothing more than a file transfer. The
+     *  transfer then runs off the event loop.
+     *  @param[in] oemPlatformHandler - oem handler for PLDM platform related
+     *                                  tasks
+     *  @return the path, std::nullopt to read with readIntoMemory
+     */
+    virtual std::optional<fs::path>
+        memoryReadPath(oem_platform::Handler* /*oemPlatformHandler*/)
+    {
+        return std::nullopt;
+    }
+
+    /** @brief The work of writeFromMemory as a job for the worker, for file
+     *  types whose write from host memory is nothing more than file I/O and
+     *  DMA. What the job needs from the event loop is looked up here.
+     *  @param[in] offset - offset to write
+     *  @param[in] length - length to be written mentioned by Host
+     *  @param[in] address - DMA address
+     *  @param[in] oemPlatformHandler - oem handler for PLDM platform related
+     *                                  tasks
+     *  @return the job, returning a PLDM status code; an empty function to
+     *          write with writeFromMemory
+     */
+    virtual std::function<int()>
+        memoryWriteJob(uint32_t /*offset*/, uint32_t /*length*/,
+                       uint64_t /*address*/,
+                       oem_platform::Handler* /*oemPlatformHandler*/)
+    {
+        return {};
+    }
+
     /** @brief Method to read an oem file type's content into the PLDM response.
      *  @param[in] offset - offset to read
      *  @param[in/out] length - length to be read
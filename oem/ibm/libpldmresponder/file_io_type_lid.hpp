@@ -3,8 +3,11 @@
 #include "config.h"
 
 #include "file_io_by_type.hpp"
+#include "open_file_cache.hpp"
 
 #include <filesystem>
+#include <functional>
+#include <optional>
 #include <sstream>
 #include <string>
 
@@ -117,47 +120,10 @@ class LidHandler : public FileHandler
                                 uint64_t address,
                                 oem_platform::Handler* oemPlatformHandler)
     {
-        int rc = PLDM_SUCCESS;
-        bool codeUpdateInProgress = false;
-        if (oemPlatformHandler != nullptr)
-        {
-            pldm::responder::oem_ibm_platform::Handler* oemIbmPlatformHandler =
-                dynamic_cast<pldm::responder::oem_ibm_platform::Handler*>(
-                    oemPlatformHandler);
-            codeUpdateInProgress =
-                oemIbmPlatformHandler->codeUpdate->isCodeUpdateInProgress();
-            if (codeUpdateInProgress || lidType == PLDM_FILE_TYPE_LID_MARKER)
-            {
-                std::string dir = LID_STAGING_DIR;
-                std::stringstream stream;
-                stream << std::hex << fileHandle;
-                auto lidName = stream.str() + ".lid";
-                lidPath = std::move(dir) + '/' + lidName;
-            }
-        }
-        bool fileExists = fs::exists(lidPath);
-        int flags{};
-        if (fileExists)
-        {
-            flags = O_RDWR;
-        }
-        else
-        {
-            flags = O_WRONLY | O_CREAT | O_TRUNC | O_SYNC;
-        }
-        auto fd = open(lidPath.c_str(), flags, S_IRUSR);
-        if (fd == -1)
-        {
-            std::cerr << "Could not open file for writing  " << lidPath.c_str()
-                      << "\n";
-            return PLDM_ERROR;
-        }
-        close(fd);
-
-        rc = transferFileData(lidPath, false, offset, length, address);
+        auto rc = writeLidFromMemory(offset, length, address,
+                                     setWritePath(oemPlatformHandler));
         if (rc != PLDM_SUCCESS)
         {
-            std::cerr << "writeFileFromMemory failed with rc= " << rc << " \n";
             return rc;
         }
         if (lidType == PLDM_FILE_TYPE_LID_MARKER)
@@ -178,11 +144,23 @@ class LidHandler : public FileHandler
                 rc = PLDM_SUCCESS;
             }
         }
-        else if (codeUpdateInProgress)
+        return rc;
+    }
+
+    virtual std::function<int()>
+        memoryWriteJob(uint32_t offset, uint32_t length, uint64_t address,
+                       oem_platform::Handler* oemPlatformHandler)
+    {
+        // The marker LID, once complete, is announced with a sensor event
+        if (lidType == PLDM_FILE_TYPE_LID_MARKER)
         {
-            rc = processCodeUpdateLid(lidPath);
+            return {};
         }
-        return rc;
+        auto codeUpdateInProgress = setWritePath(oemPlatformHandler);
+        return [this, offset, length, address, codeUpdateInProgress] {
+            return writeLidFromMemory(offset, length, address,
+                                      codeUpdateInProgress);
+        };
     }
 
     virtual int readIntoMemory(uint32_t offset, uint32_t length,
@@ -196,6 +174,16 @@ class LidHandler : public FileHandler
         return PLDM_ERROR;
     }
 
+    virtual std::optional<fs::path>
+        memoryReadPath(oem_platform::Handler* oemPlatformHandler)
+    {
+        if (constructLIDPath(oemPlatformHandler))
+        {
+            return lidPath;
+        }
+        return std::nullopt;
+    }
+
     virtual int write(const char* buffer, uint32_t offset, uint32_t& length,
                       oem_platform::Handler* oemPlatformHandler)
     {
@@ -217,6 +205,10 @@ class LidHandler : public FileHandler
                 lidPath = std::move(dir) + '/' + lidName;
             }
         }
+        if (codeUpdateInProgress && lidType != PLDM_FILE_TYPE_LID_MARKER)
+        {
+            return writeCodeUpdateLid(lidPath, offset, buffer, length);
+        }
         bool fileExists = fs::exists(lidPath);
         int flags{};
         if (fileExists)
@@ -287,10 +279,6 @@ class LidHandler : public FileHandler
                 rc = PLDM_SUCCESS;
             }
         }
-        else if (codeUpdateInProgress)
-        {
-            rc = processCodeUpdateLid(lidPath);
-        }
 
         return rc;
     }
@@ -300,11 +288,48 @@ class LidHandler : public FileHandler
     {
         if (constructLIDPath(oemPlatformHandler))
         {
-            return readFile(lidPath, offset, length, response);
+            return OpenFileCache::get().read(lidPath, offset, length,
+                                             response);
         }
         return PLDM_ERROR;
     }
 
+    using FileHandler::transferFileData;
+
+    /** @brief Transfer a LID over DMA, a LID is read from the descriptor
+     *         kept open across its chunks
+     */
+    virtual int transferFileData(const fs::path& path, bool upstream,
+                                 uint32_t offset, uint32_t& length,
+                                 uint64_t address)
+    {
+        if (!upstream)
+        {
+            return FileHandler::transferFileData(path, upstream, offset,
+                                                 length, address);
+        }
+
+        auto file = OpenFileCache::get().open(path);
+        if (!file)
+        {
+            std::cerr << "File does not exist. PATH=" << path.c_str()
+                      << " ERROR=" << errno << "\n";
+            return PLDM_INVALID_FILE_HANDLE;
+        }
+        if (offset >= file->size)
+        {
+            std::cerr << "Offset exceeds file size, OFFSET=" << offset
+                      << " FILE_SIZE=" << file->size << "\n";
+            return PLDM_DATA_OUT_OF_RANGE;
+        }
+        if (offset + length > file->size)
+        {
+            length = file->size - offset;
+        }
+        return transferFileData(file->fd(), upstream, offset, length,
+                                address);
+    }
+
     virtual int fileAck(uint8_t /*fileStatus*/)
     {
         return PLDM_ERROR_UNSUPPORTED_PLDM_CMD;
@@ -345,6 +370,81 @@ class LidHandler : public FileHandler
     {}
 
   protected:
+    /** @brief Point lidPath at the staging directory for a LID written
+     *         during a code update, and for the marker LID
+     *  @param[in] oemPlatformHandler - OEM platform handler
+     *  @return bool - true if a code update is in progress
+     */
+    bool setWritePath(oem_platform::Handler* oemPlatformHandler)
+    {
+        bool codeUpdateInProgress = false;
+        if (oemPlatformHandler != nullptr)
+        {
+            pldm::responder::oem_ibm_platform::Handler* oemIbmPlatformHandler =
+                dynamic_cast<pldm::responder::oem_ibm_platform::Handler*>(
+                    oemPlatformHandler);
+            codeUpdateInProgress =
+                oemIbmPlatformHandler->codeUpdate->isCodeUpdateInProgress();
+            if (codeUpdateInProgress || lidType == PLDM_FILE_TYPE_LID_MARKER)
+            {
+                std::string dir = LID_STAGING_DIR;
+                std::stringstream stream;
+                stream << std::hex << fileHandle;
+                auto lidName = stream.str() + ".lid";
+                lidPath = std::move(dir) + '/' + lidName;
+            }
+        }
+        return codeUpdateInProgress;
+    }
+
+    /** @brief Write a chunk of the LID at lidPath from host memory, only
+     *         file I/O and DMA so that it can run on the worker
+     *  @param[in] offset - offset to write
+     *  @param[in] length - length to be written
+     *  @param[in] address - DMA address
+     *  @param[in] codeUpdateInProgress - whether the LID is part of a code
+     *                                    update
+     *  @return PLDM status code
+     */
+    int writeLidFromMemory(uint32_t offset, uint32_t length, uint64_t address,
+                           bool codeUpdateInProgress)
+    {
+        if (codeUpdateInProgress && lidType != PLDM_FILE_TYPE_LID_MARKER)
+        {
+            return writeCodeUpdateLid(
+                lidPath, offset, length,
+                [this, length, address](int fd, uint32_t fdOffset) mutable {
+                    return transferFileData(fd, false, fdOffset, length,
+                                            address);
+                });
+        }
+        bool fileExists = fs::exists(lidPath);
+        int flags{};
+        if (fileExists)
+        {
+            flags = O_RDWR;
+        }
+        else
+        {
+            flags = O_WRONLY | O_CREAT | O_TRUNC | O_SYNC;
+        }
+        auto fd = open(lidPath.c_str(), flags, S_IRUSR);
+        if (fd == -1)
+        {
+            std::cerr << "Could not open file for writing  " << lidPath.c_str()
+                      << "\n";
+            return PLDM_ERROR;
+        }
+        close(fd);
+
+        auto rc = transferFileData(lidPath, false, offset, length, address);
+        if (rc != PLDM_SUCCESS)
+        {
+            std::cerr << "writeFileFromMemory failed with rc= " << rc << " \n";
+        }
+        return rc;
+    }
+
     std::string lidPath;
     std::string sideToRead;
     std::string currBootSide;
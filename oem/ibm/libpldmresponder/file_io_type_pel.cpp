@@ -8,16 +8,20 @@
 #include "common/utils.hpp"
 #include "xyz/openbmc_project/Common/error.hpp"
 
+#include <fcntl.h>
 #include <stdint.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include <systemd/sd-bus.h>
 #include <unistd.h>
 
 #include <sdbusplus/server.hpp>
 #include <xyz/openbmc_project/Logging/Entry/server.hpp>
 
+#include <algorithm>
+#include <cerrno>
 #include <exception>
 #include <filesystem>
-#include <fstream>
 #include <iostream>
 #include <vector>
 
@@ -31,18 +35,7 @@ using namespace sdbusplus::xyz::openbmc_project::Logging::server;
 namespace detail
 {
 
-/**
- * @brief Finds the Entry::Level value for the severity of the PEL
- *        passed in.
- *
- * The severity byte is at offset 10 in the User Header section,
- * which is always after the 48 byte Private Header section.
- *
- * @param[in] pelFileName - The file containing the PEL
- *
- * @return Entry::Level - The severity value for the Entry
- */
-Entry::Level getEntryLevelFromPEL(const std::string& pelFileName)
+Entry::Level getEntryLevelFromPEL(int pelFd)
 {
     const std::map<uint8_t, Entry::Level> severityMap{
         {0x00, Entry::Level::Informational}, // Informational event
@@ -56,82 +49,126 @@ Entry::Level getEntryLevelFromPEL(const std::string& pelFileName)
 
     const size_t severityOffset = 0x3A;
 
-    size_t size = 0;
-    if (fs::exists(pelFileName))
+    uint8_t sev;
+    if (pread(pelFd, &sev, sizeof(sev), severityOffset) == sizeof(sev))
     {
-        size = fs::file_size(pelFileName);
-    }
+        // Get the type
+        sev = sev & 0xF0;
 
-    if (size > severityOffset)
-    {
-        std::ifstream pel{pelFileName};
-        if (pel.good())
+        auto entry = severityMap.find(sev);
+        if (entry != severityMap.end())
         {
-            pel.seekg(severityOffset);
-
-            uint8_t sev;
-            pel.read(reinterpret_cast<char*>(&sev), 1);
+            return entry->second;
+        }
+    }
 
-            // Get the type
-            sev = sev & 0xF0;
+    return Entry::Level::Error;
+}
 
-            auto entry = severityMap.find(sev);
-            if (entry != severityMap.end())
-            {
-                return entry->second;
-            }
-        }
-        else
+PelStage::PelStage(bool useMemfd)
+{
+#ifdef PEL_MEMFD
+    if (useMemfd)
+    {
+        fd = memfd_create("pel", MFD_CLOEXEC | MFD_ALLOW_SEALING);
+        if (fd != -1)
         {
-            std::cerr << "Unable to open PEL file " << pelFileName << "\n";
+            memfd = true;
+            pelPath = "/proc/" + std::to_string(getpid()) + "/fd/" +
+                      std::to_string(fd);
+            return;
         }
+        std::cerr << "failed to create a memfd for a pel, ERROR=" << errno
+                  << "\n";
     }
+#else
+    (void)useMemfd;
+#endif
+    char tmpFile[] = "/tmp/pel.XXXXXX";
+    fd = mkostemp(tmpFile, O_CLOEXEC);
+    if (fd == -1)
+    {
+        std::cerr << "failed to create a temporary pel, ERROR=" << errno
+                  << "\n";
+        return;
+    }
+    pelPath = tmpFile;
+}
 
-    return Entry::Level::Error;
+PelStage::~PelStage()
+{
+    if (fd != -1)
+    {
+        close(fd);
+    }
 }
-} // namespace detail
 
-int PelHandler::readIntoMemory(uint32_t offset, uint32_t length,
-                               uint64_t address,
-                               oem_platform::Handler* /*oemPlatformHandler*/)
+void PelStage::seal()
 {
-    static constexpr auto logObjPath = "/xyz/openbmc_project/logging";
-    static constexpr auto logInterface = "org.open_power.Logging.PEL";
+    if (memfd && fcntl(fd, F_ADD_SEALS,
+                       F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_WRITE |
+                           F_SEAL_SEAL) == -1)
+    {
+        std::cerr << "failed to seal a pel memfd, ERROR=" << errno << "\n";
+    }
+}
 
-    auto& bus = pldm::utils::DBusHandler::getBus();
+void PelStage::discard()
+{
+    if (!memfd)
+    {
+        fs::remove(pelPath);
+    }
+}
 
-    try
+} // namespace detail
+
+PelFdCache& PelFdCache::get()
+{
+    static PelFdCache cache;
+    return cache;
+}
+
+const PelFdCache::Entry* PelFdCache::find(uint32_t pelId)
+{
+    auto it = std::find_if(entries.begin(), entries.end(),
+                           [pelId](const auto& e) { return e.pelId == pelId; });
+    if (it == entries.end())
     {
-        auto service =
-            pldm::utils::DBusHandler().getService(logObjPath, logInterface);
-        auto method = bus.new_method_call(service.c_str(), logObjPath,
-                                          logInterface, "GetPEL");
-        method.append(fileHandle);
-        auto reply = bus.call(
-            method,
-            std::chrono::duration_cast<microsec>(sec(DBUS_TIMEOUT)).count());
-        sdbusplus::message::unix_fd fd{};
-        reply.read(fd);
-        auto rc = transferFileData(fd, true, offset, length, address);
-        return rc;
+        return nullptr;
     }
-    catch (const std::exception& e)
+    entries.splice(entries.begin(), entries, it);
+    return &entries.front();
+}
+
+const PelFdCache::Entry& PelFdCache::insert(uint32_t pelId, int fd,
+                                            off_t size)
+{
+    erase(pelId);
+    if (entries.size() >= maxEntries)
     {
-        std::cerr << "GetPEL D-Bus call failed, PEL id = 0x" << std::hex
-                  << fileHandle << ", error = " << e.what() << "\n";
-        return PLDM_ERROR;
+        entries.pop_back();
     }
+    return entries.emplace_front(pelId, fd, size);
+}
 
-    return PLDM_SUCCESS;
+void PelFdCache::erase(uint32_t pelId)
+{
+    entries.remove_if([pelId](const auto& e) { return e.pelId == pelId; });
 }
 
-int PelHandler::read(uint32_t offset, uint32_t& length, Response& response,
-                     oem_platform::Handler* /*oemPlatformHandler*/)
+const PelFdCache::Entry* PelHandler::openPel()
 {
     static constexpr auto logObjPath = "/xyz/openbmc_project/logging";
     static constexpr auto logInterface = "org.open_power.Logging.PEL";
-    auto& bus = pldm::utils::DBusHandler::getBus();
 
+    auto& cache = PelFdCache::get();
+    if (auto entry = cache.find(fileHandle))
+    {
+        return entry;
+    }
+
+    auto& bus = pldm::utils::DBusHandler::getBus();
     try
     {
         auto service =
@@ -145,50 +182,85 @@ int PelHandler::read(uint32_t offset, uint32_t& length, Response& response,
         sdbusplus::message::unix_fd fd{};
         reply.read(fd);
 
-        off_t fileSize = lseek(fd, 0, SEEK_END);
-        if (fileSize == -1)
-        {
-            std::cerr << "file seek failed";
-            return PLDM_ERROR;
-        }
-        if (offset >= fileSize)
-        {
-            std::cerr << "Offset exceeds file size, OFFSET=" << offset
-                      << " FILE_SIZE=" << fileSize << std::endl;
-            return PLDM_DATA_OUT_OF_RANGE;
-        }
-        if (offset + length > fileSize)
-        {
-            length = fileSize - offset;
-        }
-        auto rc = lseek(fd, offset, SEEK_SET);
-        if (rc == -1)
+        // The descriptor in the reply is closed along with the reply
+        int pelFd = fcntl(fd, F_DUPFD_CLOEXEC, 0);
+        if (pelFd == -1)
         {
-            std::cerr << "file seek failed";
-            return PLDM_ERROR;
+            std::cerr << "Failed to duplicate the PEL descriptor, PEL id = 0x"
+                      << std::hex << fileHandle << std::dec
+                      << ", ERROR=" << errno << "\n";
+            return nullptr;
         }
-        size_t currSize = response.size();
-        response.resize(currSize + length);
-        auto filePos = reinterpret_cast<char*>(response.data());
-        filePos += currSize;
-        rc = ::read(fd, filePos, length);
-        if (rc == -1)
+        struct stat st;
+        if (fstat(pelFd, &st) == -1)
         {
-            std::cerr << "file read failed";
-            return PLDM_ERROR;
-        }
-        if (rc != length)
-        {
-            std::cerr << "mismatch between number of characters to read and "
-                      << "the length read, LENGTH=" << length << " COUNT=" << rc
-                      << std::endl;
-            return PLDM_ERROR;
+            std::cerr << "Failed to get the PEL size, PEL id = 0x" << std::hex
+                      << fileHandle << std::dec << ", ERROR=" << errno << "\n";
+            close(pelFd);
+            return nullptr;
         }
+        return &cache.insert(fileHandle, pelFd, st.st_size);
     }
     catch (const std::exception& e)
     {
-        std::cerr << "GetPEL D-Bus call failed on PEL ID 0x" << std::hex
+        std::cerr << "GetPEL D-Bus call failed, PEL id = 0x" << std::hex
                   << fileHandle << ", error = " << e.what() << "\n";
+        return nullptr;
+    }
+}
+
+int PelHandler::readIntoMemory(uint32_t offset, uint32_t length,
+                               uint64_t address,
+                               oem_platform::Handler* /*oemPlatformHandler*/)
+{
+    auto pel = openPel();
+    if (!pel)
+    {
+        return PLDM_ERROR;
+    }
+    return transferFileData(pel->fd(), true, offset, length, address);
+}
+
+int PelHandler::read(uint32_t offset, uint32_t& length, Response& response,
+                     oem_platform::Handler* /*oemPlatformHandler*/)
+{
+    auto pel = openPel();
+    if (!pel)
+    {
+        return PLDM_ERROR;
+    }
+
+    if (offset >= pel->size)
+    {
+        std::cerr << "Offset exceeds file size, OFFSET=" << offset
+                  << " FILE_SIZE=" << pel->size << std::endl;
+        return PLDM_DATA_OUT_OF_RANGE;
+    }
+    if (offset + length > pel->size)
+    {
+        length = pel->size - offset;
+    }
+
+    // The chunk is read straight into the response, the descriptor is
+    // shared by the chunks so its file offset is left alone
+    size_t currSize = response.size();
+    response.resize(currSize + length);
+    auto filePos = reinterpret_cast<char*>(response.data()) + currSize;
+    ssize_t rc;
+    do
+    {
+        rc = pread(pel->fd(), filePos, length, offset);
+    } while (rc == -1 && errno == EINTR);
+    if (rc == -1)
+    {
+        std::cerr << "file read failed, ERROR=" << errno << "\n";
+        return PLDM_ERROR;
+    }
+    if (rc != length)
+    {
+        std::cerr << "mismatch between number of characters to read and "
+                  << "the length read, LENGTH=" << length << " COUNT=" << rc
+                  << std::endl;
         return PLDM_ERROR;
     }
     return PLDM_SUCCESS;
@@ -198,21 +270,21 @@ int PelHandler::writeFromMemory(uint32_t offset, uint32_t length,
                                 uint64_t address,
                                 oem_platform::Handler* /*oemPlatformHandler*/)
 {
-    char tmpFile[] = "/tmp/pel.XXXXXX";
-    int fd = mkstemp(tmpFile);
-    if (fd == -1)
+    detail::PelStage pel;
+    if (!pel)
     {
-        std::cerr << "failed to create a temporary pel, ERROR=" << errno
-                  << "\n";
         return PLDM_ERROR;
     }
-    close(fd);
-    fs::path path(tmpFile);
 
-    auto rc = transferFileData(path, false, offset, length, address);
+    auto rc = transferFileData(pel(), false, offset, length, address);
     if (rc == PLDM_SUCCESS)
     {
-        rc = storePel(path.string());
+        pel.seal();
+        rc = storePel(pel(), std::string(pel.path()));
+    }
+    else
+    {
+        pel.discard();
     }
     return rc;
 }
@@ -221,6 +293,10 @@ int PelHandler::fileAck(uint8_t /*fileStatus*/)
 {
     static constexpr auto logObjPath = "/xyz/openbmc_project/logging";
     static constexpr auto logInterface = "org.open_power.Logging.PEL";
+
+    // The host is done reading the PEL
+    PelFdCache::get().erase(fileHandle);
+
     auto& bus = pldm::utils::DBusHandler::getBus();
 
     try
@@ -242,7 +318,7 @@ int PelHandler::fileAck(uint8_t /*fileStatus*/)
     return PLDM_SUCCESS;
 }
 
-int PelHandler::storePel(std::string&& pelFileName)
+int PelHandler::storePel(int pelFd, std::string&& pelFileName)
 {
     static constexpr auto logObjPath = "/xyz/openbmc_project/logging";
     static constexpr auto logInterface = "xyz.openbmc_project.Logging.Create";
@@ -257,7 +333,7 @@ int PelHandler::storePel(std::string&& pelFileName)
         std::map<std::string, std::string> addlData{};
         auto severity =
             sdbusplus::xyz::openbmc_project::Logging::server::convertForMessage(
-                detail::getEntryLevelFromPEL(pelFileName));
+                detail::getEntryLevelFromPEL(pelFd));
         addlData.emplace("RAWPEL", std::move(pelFileName));
 
         auto method = bus.new_method_call(service.c_str(), logObjPath,
@@ -289,43 +365,39 @@ int PelHandler::write(const char* buffer, uint32_t offset, uint32_t& length,
         return PLDM_ERROR;
     }
 
-    char tmpFile[] = "/tmp/pel.XXXXXX";
-    auto fd = mkstemp(tmpFile);
-    if (fd == -1)
+    detail::PelStage pel;
+    if (!pel)
     {
-        std::cerr << "failed to create a temporary pel, ERROR=" << errno
-                  << "\n";
         return PLDM_ERROR;
     }
 
     size_t written = 0;
     do
     {
-        if ((rc = ::write(fd, buffer, length - written)) == -1)
+        if ((rc = ::write(pel(), buffer, length - written)) == -1)
         {
             break;
         }
         written += rc;
         buffer += rc;
     } while (rc && written < length);
-    close(fd);
 
     if (rc == -1)
     {
         std::cerr << "file write failed, ERROR=" << errno
                   << ", LENGTH=" << length << ", OFFSET=" << offset << "\n";
-        fs::remove(tmpFile);
+        pel.discard();
         return PLDM_ERROR;
     }
 
     if (written == length)
     {
-        fs::path path(tmpFile);
-        rc = storePel(path.string());
+        pel.seal();
+        rc = storePel(pel(), std::string(pel.path()));
         if (rc != PLDM_SUCCESS)
         {
             std::cerr << "save PEL failed, ERROR = " << rc
-                      << "tmpFile = " << tmpFile << "\n";
+                      << "tmpFile = " << pel.path() << "\n";
         }
     }
 
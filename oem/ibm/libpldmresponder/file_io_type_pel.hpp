@@ -2,11 +2,167 @@
 
 #include "file_io_by_type.hpp"
 
+#include <sys/types.h>
+
+#include <xyz/openbmc_project/Logging/Entry/server.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <string>
+
 namespace pldm
 {
 namespace responder
 {
 
+/** @class PelFdCache
+ *
+ *  The host reads a PEL in chunks, with one ReadFileByType or
+ *  ReadFileByTypeIntoMemory per chunk. Rather than asking the PEL daemon
+ *  for the PEL again with every chunk, the descriptor GetPEL returns is kept
+ *  here, with the size of the PEL, until the host acknowledges the PEL. The
+ *  least recently used descriptor is closed once maxEntries PELs are open,
+ *  so a PEL the host never acknowledges does not hold its descriptor for
+ *  good.
+ */
+class PelFdCache
+{
+  public:
+    static constexpr size_t maxEntries = 8;
+
+    struct Entry
+    {
+        Entry(uint32_t pelId, int fd, off_t size) :
+            pelId(pelId), fd(fd), size(size)
+        {}
+
+        uint32_t pelId;
+        pldm::utils::CustomFD fd;
+        off_t size;
+    };
+
+    PelFdCache() = default;
+    PelFdCache(const PelFdCache&) = delete;
+    PelFdCache& operator=(const PelFdCache&) = delete;
+
+    /** @brief The cache shared by the PEL handlers */
+    static PelFdCache& get();
+
+    /** @brief Look up the descriptor of a PEL, making it the most recently
+     *         used one
+     *
+     *  @param[in] pelId - PEL ID
+     *
+     *  @return pointer to the entry, nullptr on a miss
+     */
+    const Entry* find(uint32_t pelId);
+
+    /** @brief Add the descriptor of a PEL, closing the least recently used
+     *         one if the cache is full
+     *
+     *  @param[in] pelId - PEL ID
+     *  @param[in] fd - descriptor of the PEL, owned by the cache from now on
+     *  @param[in] size - size of the PEL
+     *
+     *  @return the new entry
+     */
+    const Entry& insert(uint32_t pelId, int fd, off_t size);
+
+    /** @brief Close the descriptor of a PEL, if cached
+     *
+     *  @param[in] pelId - PEL ID
+     */
+    void erase(uint32_t pelId);
+
+    size_t size() const
+    {
+        return entries.size();
+    }
+
+  private:
+    /** @brief Cached descriptors, the most recently used first */
+    std::list<Entry> entries;
+};
+
+namespace detail
+{
+
+/**
+ * @brief Finds the Entry::Level value for the severity of the PEL
+ *        passed in.
+ *
+ * The severity byte is at offset 10 in the User Header section,
+ * which is always after the 48 byte Private Header section.
+ *
+ * @param[in] pelFd - Descriptor of the PEL
+ *
+ * @return Entry::Level - The severity value for the Entry
+ */
+sdbusplus::xyz::openbmc_project::Logging::server::Entry::Level
+    getEntryLevelFromPEL(int pelFd);
+
+/** @class PelStage
+ *
+ *  Holds a PEL from the host until the PEL daemon has taken it in. The PEL
+ *  goes in a memfd, which the daemon reads through its /proc path while
+ *  Logging.Create runs, so a PEL never touches the filesystem. A file in
+ *  /tmp is used when memfds are disabled or can't be created, the daemon
+ *  removes it once read.
+ */
+class PelStage
+{
+  public:
+    /** @brief Create the stage of a PEL
+     *
+     *  @param[in] useMemfd - stage the PEL in a memfd if memfds are
+     *                        enabled, else in a file in /tmp
+     */
+    explicit PelStage(bool useMemfd = true);
+
+    PelStage(const PelStage&) = delete;
+    PelStage& operator=(const PelStage&) = delete;
+
+    ~PelStage();
+
+    explicit operator bool() const
+    {
+        return fd != -1;
+    }
+
+    int operator()() const
+    {
+        return fd;
+    }
+
+    /** @brief Freeze the PEL before the daemon reads it, a memfd is sealed
+     *         against any further change
+     */
+    void seal();
+
+    /** @brief Drop a PEL the daemon is not given */
+    void discard();
+
+    /** @brief Path for the daemon to read the PEL from */
+    const std::string& path() const
+    {
+        return pelPath;
+    }
+
+    /** @brief Whether the PEL is staged in a memfd */
+    bool isMemfd() const
+    {
+        return memfd;
+    }
+
+  private:
+    std::string pelPath;
+    int fd = -1;
+    bool memfd = false;
+};
+
+} // namespace detail
+
 /** @class PelHandler
  *
  *  @brief Inherits and implements FileHandler. This class is used
@@ -37,12 +193,13 @@ class PelHandler : public FileHandler
 
     virtual int fileAck(uint8_t fileStatus);
 
-    /** @brief method to store a pel file in tempfs and send
-     *  d-bus notification to pel daemon that it is ready for consumption
+    /** @brief method to send d-bus notification to pel daemon that a pel
+     *  from the host is ready for consumption
      *
-     *  @param[in] pelFileName - the pel file path
+     *  @param[in] pelFd - descriptor of the staged pel
+     *  @param[in] pelFileName - the path the pel daemon reads the pel from
      */
-    virtual int storePel(std::string&& pelFileName);
+    virtual int storePel(int pelFd, std::string&& pelFileName);
 
     virtual int newFileAvailable(uint64_t /*length*/)
     {
@@ -71,6 +228,14 @@ class PelHandler : public FileHandler
      */
     ~PelHandler()
     {}
+
+  private:
+    /** @brief Get the descriptor and size of the PEL, from the cache or
+     *         else from the PEL daemon
+     *
+     *  @return pointer to the cache entry of the PEL, nullptr on failure
+     */
+    const PelFdCache::Entry* openPel();
 };
 
 } // namespace responder
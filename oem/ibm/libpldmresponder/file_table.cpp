@@ -2,8 +2,13 @@
 
 #include "libpldm/utils.h"
 
+#include <sys/inotify.h>
+#include <unistd.h>
+
+#include <cerrno>
 #include <fstream>
 #include <iostream>
+#include <utility>
 
 namespace pldm
 {
@@ -70,6 +75,9 @@ FileTable::FileTable(const std::string& fileTableConfigPath)
             static_cast<uint16_t>(fsPath.filename().string().size());
         fileSize = static_cast<uint32_t>(fs::file_size(fsPath));
         tableSize = fileTable.size();
+        sizeOffsets.emplace(handle, tableSize + sizeof(handle) +
+                                        sizeof(fileNameLength) +
+                                        fileNameLength);
 
         fileTable.resize(tableSize + sizeof(handle) + sizeof(fileNameLength) +
                          fileNameLength + sizeof(fileSize) + sizeof(traits));
@@ -105,6 +113,11 @@ FileTable::FileTable(const std::string& fileTableConfigPath)
         handle++;
     }
 
+    if (fileTable.empty())
+    {
+        return;
+    }
+
     constexpr uint8_t padWidth = 4;
     tableSize = fileTable.size();
     // Add pad bytes
@@ -115,17 +128,190 @@ FileTable::FileTable(const std::string& fileTableConfigPath)
     }
 
     // Calculate the checksum
-    checkSum = crc32(fileTable.data(), fileTable.size());
+    tableSize = fileTable.size();
+    checkSum = crc32(fileTable.data(), tableSize);
+    fileTable.resize(tableSize + sizeof(checkSum));
+    std::copy_n(reinterpret_cast<uint8_t*>(&checkSum), sizeof(checkSum),
+                fileTable.begin() + tableSize);
+
+    // Watch the files for size changes
+    inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (inotifyFd == -1)
+    {
+        std::cerr << "Failed to watch the files of the file table, ERROR="
+                  << errno << "\n";
+    }
+    for (const auto& [handle, entry] : tableEntries)
+    {
+        if (!watch(handle))
+        {
+            unwatched.emplace(handle);
+        }
+    }
 }
 
-Table FileTable::operator()() const
+FileTable::~FileTable()
 {
-    Table table(fileTable);
-    table.resize(fileTable.size() + sizeof(checkSum));
-    auto iter = table.begin() + fileTable.size();
-    std::copy_n(reinterpret_cast<const uint8_t*>(&checkSum), sizeof(checkSum),
-                iter);
-    return table;
+    clear();
+}
+
+FileTable::FileTable(FileTable&& other) noexcept :
+    tableEntries(std::move(other.tableEntries)),
+    fileTable(std::move(other.fileTable)), padCount(other.padCount),
+    checkSum(other.checkSum), sizeOffsets(std::move(other.sizeOffsets)),
+    inotifyFd(std::exchange(other.inotifyFd, -1)),
+    watches(std::move(other.watches)), unwatched(std::move(other.unwatched))
+{}
+
+FileTable& FileTable::operator=(FileTable&& other) noexcept
+{
+    if (this != &other)
+    {
+        clear();
+        tableEntries = std::move(other.tableEntries);
+        fileTable = std::move(other.fileTable);
+        padCount = other.padCount;
+        checkSum = other.checkSum;
+        sizeOffsets = std::move(other.sizeOffsets);
+        inotifyFd = std::exchange(other.inotifyFd, -1);
+        watches = std::move(other.watches);
+        unwatched = std::move(other.unwatched);
+    }
+    return *this;
+}
+
+void FileTable::clear()
+{
+    if (inotifyFd != -1)
+    {
+        close(inotifyFd);
+        inotifyFd = -1;
+    }
+    tableEntries.clear();
+    fileTable.clear();
+    padCount = 0;
+    checkSum = 0;
+    sizeOffsets.clear();
+    watches.clear();
+    unwatched.clear();
+}
+
+bool FileTable::watch(Handle handle)
+{
+    if (inotifyFd == -1)
+    {
+        return false;
+    }
+    auto wd = inotify_add_watch(inotifyFd,
+                                tableEntries.at(handle).fsPath.c_str(),
+                                IN_MODIFY | IN_ATTRIB | IN_MOVE_SELF |
+                                    IN_DELETE_SELF);
+    if (wd == -1)
+    {
+        return false;
+    }
+    watches[wd] = handle;
+    return true;
+}
+
+void FileTable::updateSize(Handle handle)
+{
+    // A file that is gone is listed with a size of 0 until it is back
+    std::error_code ec;
+    auto size = fs::file_size(tableEntries.at(handle).fsPath, ec);
+    auto fileSize = ec ? 0 : static_cast<uint32_t>(size);
+    std::copy_n(reinterpret_cast<uint8_t*>(&fileSize), sizeof(fileSize),
+                fileTable.begin() + sizeOffsets.at(handle));
+}
+
+const Table& FileTable::operator()()
+{
+    if (fileTable.empty())
+    {
+        return fileTable;
+    }
+
+    // Files that can't be watched are checked every time
+    std::set<Handle> changed;
+    for (auto it = unwatched.begin(); it != unwatched.end();)
+    {
+        changed.emplace(*it);
+        it = watch(*it) ? unwatched.erase(it) : std::next(it);
+    }
+
+    alignas(struct inotify_event) char buffer[4096];
+    ssize_t count = 0;
+    bool overflow = false;
+    while (inotifyFd != -1 &&
+           (count = read(inotifyFd, buffer, sizeof(buffer))) > 0)
+    {
+        for (auto event = buffer; event < buffer + count;
+             event += sizeof(struct inotify_event) +
+                      reinterpret_cast<struct inotify_event*>(event)->len)
+        {
+            auto e = reinterpret_cast<struct inotify_event*>(event);
+            if (e->mask & IN_Q_OVERFLOW)
+            {
+                overflow = true;
+                continue;
+            }
+            auto watched = watches.find(e->wd);
+            if (watched == watches.end())
+            {
+                continue;
+            }
+            auto handle = watched->second;
+            changed.emplace(handle);
+
+            // The file was removed, replaced or moved away, watch the file
+            // the path names now
+            if (e->mask & (IN_ATTRIB | IN_MOVE_SELF | IN_DELETE_SELF |
+                           IN_IGNORED))
+            {
+                if (!(e->mask & IN_IGNORED))
+                {
+                    inotify_rm_watch(inotifyFd, e->wd);
+                }
+                watches.erase(watched);
+                if (!watch(handle))
+                {
+                    unwatched.emplace(handle);
+                }
+            }
+        }
+    }
+
+    // Events were lost, a file may even have been replaced unseen. Every
+    // file is watched again by its path and its size checked.
+    if (overflow)
+    {
+        for (const auto& [wd, handle] : watches)
+        {
+            inotify_rm_watch(inotifyFd, wd);
+        }
+        watches.clear();
+        for (const auto& [handle, offset] : sizeOffsets)
+        {
+            changed.emplace(handle);
+            if (!watch(handle))
+            {
+                unwatched.emplace(handle);
+            }
+        }
+    }
+
+    if (!changed.empty())
+    {
+        for (auto handle : changed)
+        {
+            updateSize(handle);
+        }
+        auto tableSize = fileTable.size() - sizeof(checkSum);
+        checkSum = crc32(fileTable.data(), tableSize);
+        std::copy_n(reinterpret_cast<uint8_t*>(&checkSum), sizeof(checkSum),
+                    fileTable.begin() + tableSize);
+    }
+    return fileTable;
 }
 
 FileTable& buildFileTable(const std::string& fileTablePath)
@@ -7,6 +7,8 @@
 #include <nlohmann/json.hpp>
 
 #include <filesystem>
+#include <set>
+#include <unordered_map>
 #include <vector>
 
 namespace pldm
@@ -41,6 +43,12 @@ struct FileEntry
  *  file handle and extract the file attribute table. The file attribute table
  *  comprises of metadata for files. Metadata includes the file handle, file
  *  name, current file size and file traits.
+ *
+ *  The encoded table, pad bytes and checksum included, is kept as it goes in
+ *  a GetFileTable response. The files in the table are watched with inotify,
+ *  and the size of a file that changed is patched into the table, with the
+ *  checksum, the next time the table is asked for. Should the inotify queue
+ *  overflow, every file is watched again and its size checked.
  */
 class FileTable
 {
@@ -53,17 +61,17 @@ class FileTable
      */
     FileTable(const std::string& fileTableConfigPath);
     FileTable() = default;
-    ~FileTable() = default;
-    FileTable(const FileTable&) = default;
-    FileTable& operator=(const FileTable&) = default;
-    FileTable(FileTable&&) = default;
-    FileTable& operator=(FileTable&&) = default;
+    ~FileTable();
+    FileTable(const FileTable&) = delete;
+    FileTable& operator=(const FileTable&) = delete;
+    FileTable(FileTable&& other) noexcept;
+    FileTable& operator=(FileTable&& other) noexcept;
 
-    /** @brief Get the file attribute table
+    /** @brief Get the file attribute table, with the current file sizes
      *
-     * @return Table- contents of the file attribute table
+     * @return const Table& - contents of the file attribute table
      */
-    Table operator()() const;
+    const Table& operator()();
 
     /** @brief Get the FileEntry at the file handle
      *
@@ -88,19 +96,27 @@ class FileTable
     /** @brief Clear the file table contents
      *
      */
-    void clear()
-    {
-        tableEntries.clear();
-        fileTable.clear();
-        padCount = 0;
-        checkSum = 0;
-    }
+    void clear();
 
   private:
+    /** @brief Watch a file of the table for changes of its size
+     *
+     * @param[in] handle - file handle
+     *
+     * @return bool - true if the file is being watched
+     */
+    bool watch(Handle handle);
+
+    /** @brief Patch the current size of a file into the table
+     *
+     * @param[in] handle - file handle
+     */
+    void updateSize(Handle handle);
+
     /** @brief handle to FileEntry mappings for lookups based on file handle */
     std::unordered_map<Handle, FileEntry> tableEntries;
 
-    /** @brief file attribute table including the pad bytes, except the checksum
+    /** @brief file attribute table including the pad bytes and the checksum
      */
     std::vector<uint8_t> fileTable;
 
@@ -110,6 +126,20 @@ class FileTable
 
     /** @brief the checksum of the file attribute table */
     uint32_t checkSum = 0;
+
+    /** @brief handle to the offset of the file size in the table */
+    std::unordered_map<Handle, size_t> sizeOffsets;
+
+    /** @brief inotify descriptor watching the files of the table */
+    int inotifyFd = -1;
+
+    /** @brief inotify watch to file handle mappings */
+    std::unordered_map<int, Handle> watches;
+
+    /** @brief files that could not be watched, their size is checked every
+     *         time the table is asked for
+     */
+    std::set<Handle> unwatched;
 };
 
 /** @brief Build the file attribute table if not already built using the
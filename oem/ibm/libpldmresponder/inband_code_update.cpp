@@ -7,12 +7,24 @@
 #include "xyz/openbmc_project/Common/error.hpp"
 
 #include <arpa/inet.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 #include <sdbusplus/server.hpp>
 #include <xyz/openbmc_project/Dump/NewDump/server.hpp>
 
+#include <algorithm>
+#include <array>
+#include <bitset>
 #include <exception>
 #include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <sstream>
+
 namespace pldm
 {
 using namespace utils;
@@ -21,11 +33,9 @@ namespace responder
 {
 using namespace oem_ibm_platform;
 
-/** @brief Directory where the lid files without a header are stored */
-auto lidDirPath = fs::path(LID_STAGING_DIR) / "lid";
+fs::path lidDirPath = fs::path(LID_STAGING_DIR) / "lid";
 
-/** @brief Directory where the image files are stored as they are built */
-auto imageDirPath = fs::path(LID_STAGING_DIR) / "image";
+fs::path imageDirPath = fs::path(LID_STAGING_DIR) / "image";
 
 /** @brief Directory where the code update tarball files are stored */
 auto updateDirPath = fs::path(LID_STAGING_DIR) / "update";
@@ -42,8 +52,7 @@ constexpr auto bootSideFileName = "bootSide";
 constexpr auto bootSideAttrName = "fw_boot_side_current";
 constexpr auto bootNextSideAttrName = "fw_boot_side";
 
-/** @brief The path to the code update tarball file */
-auto tarImagePath = fs::path(imageDirPath) / tarImageName;
+fs::path tarImagePath = fs::path(imageDirPath) / tarImageName;
 
 /** @brief The path to the hostfw image */
 auto hostfwImagePath = fs::path(imageDirPath) / hostfwImageName;
@@ -541,6 +550,15 @@ void CodeUpdate::setOemPlatformHandler(
     oemPlatformHandler = handler;
 }
 
+void CodeUpdate::setCodeUpdateProgress(bool progress)
+{
+    if (progress != codeUpdateInProgress)
+    {
+        resetCodeUpdateLids();
+    }
+    codeUpdateInProgress = progress;
+}
+
 void CodeUpdate::clearDirPath(const std::string& dirPath)
 {
     if (std::filesystem::is_directory(dirPath))
@@ -658,49 +676,88 @@ int executeCmd(T const&... t)
     return 0;
 }
 
-int processCodeUpdateLid(const std::string& filePath)
+namespace
 {
-    struct LidHeader
-    {
-        uint16_t magicNumber;
-        uint16_t headerVersion;
-        uint32_t lidNumber;
-        uint32_t lidDate;
-        uint16_t lidTime;
-        uint16_t lidClass;
-        uint32_t lidCrc;
-        uint32_t lidSize;
-        uint32_t headerSize;
-    };
-    LidHeader header;
 
-    std::ifstream ifs(filePath, std::ios::in | std::ios::binary);
-    if (!ifs)
-    {
-        std::cerr << "ifstream open error: " << filePath << "\n";
-        return PLDM_ERROR;
-    }
-    ifs.seekg(0);
-    ifs.read(reinterpret_cast<char*>(&header), sizeof(header));
+struct LidHeader
+{
+    uint16_t magicNumber;
+    uint16_t headerVersion;
+    uint32_t lidNumber;
+    uint32_t lidDate;
+    uint16_t lidTime;
+    uint16_t lidClass;
+    uint32_t lidCrc;
+    uint32_t lidSize;
+    uint32_t headerSize;
+};
+
+/** @brief A LID of an inband update being received */
+struct CodeUpdateLid
+{
+    CodeUpdateLid() = default;
+    CodeUpdateLid(const CodeUpdateLid&) = delete;
+    CodeUpdateLid& operator=(const CodeUpdateLid&) = delete;
 
-    // File size should be the value of lid size minus the header size
-    auto fileSize = fs::file_size(filePath);
-    fileSize -= htonl(header.headerSize);
-    if (fileSize < htonl(header.lidSize))
+    ~CodeUpdateLid()
     {
-        // File is not completely written yet
-        ifs.close();
-        return PLDM_SUCCESS;
+        if (stagingFd >= 0)
+        {
+            close(stagingFd);
+        }
     }
 
-    constexpr auto magicNumber = 0x0222;
-    if (htons(header.magicNumber) != magicNumber)
-    {
-        std::cerr << "Invalid magic number: " << filePath << "\n";
-        ifs.close();
-        return PLDM_ERROR;
-    }
+    /** @brief Guards the members below. It is held while the chunks that
+     *         hold the header are staged, not while the payload is written
+     */
+    std::mutex mutex;
+    /** @brief The staged LID file, it holds the chunks received until the
+     *         header is complete
+     */
+    int stagingFd = -1;
+    /** @brief The bytes of the header staged so far, the chunks may come in
+     *         any order
+     */
+    std::bitset<sizeof(LidHeader)> headerStaged;
+    bool headerKnown = false;
+    uint32_t lidNumber = 0;
+    uint32_t headerSize = 0;
+    uint32_t lidSize = 0;
+    /** @brief Where the payload goes, the BMC tarball or a LID file. A chunk
+     *         being written holds a reference, so that the file stays open
+     *         if the LID is started over meanwhile.
+     */
+    std::shared_ptr<CustomFD> payload;
+    /** @brief The LID file without header, empty for a BMC LID */
+    fs::path payloadPath;
+    /** @brief Offset of the payload in its file */
+    uint32_t payloadBase = 0;
+    /** @brief End of the payload received so far */
+    uint32_t payloadEnd = 0;
+};
+
+/** @brief Guards codeUpdateLids and tarImage. LIDs written from host memory
+ *         are written on the worker, and the lock is only held to look up a
+ *         LID and to place a BMC LID in the tarball.
+ */
+std::mutex codeUpdateLidsMutex;
+
+/** @brief The LIDs being received, by staged LID file */
+std::map<std::string, std::shared_ptr<CodeUpdateLid>> codeUpdateLids;
+
+/** @brief The BMC tarball the BMC LIDs are concatenated into. A BMC LID gets
+ *         its place in the tarball as soon as its header is known, so that
+ *         its payload can be written there as it comes.
+ */
+struct
+{
+    dev_t dev = 0;
+    ino_t ino = 0;
+    uint32_t end = 0;
+} tarImage;
 
+int createImageDirs()
+{
     if (!fs::exists(imageDirPath))
     {
         fs::create_directories(imageDirPath);
@@ -720,46 +777,408 @@ int processCodeUpdateLid(const std::string& filePath)
             return PLDM_ERROR;
         }
     }
+    return PLDM_SUCCESS;
+}
+
+/** @brief Copy a range of the staged LID file to where the payload goes,
+ *         within the kernel where the file systems allow it
+ */
+int copyPayload(int inFd, off_t inOffset, int outFd, off_t outOffset,
+                size_t length)
+{
+    while (length > 0)
+    {
+        auto n = copy_file_range(inFd, &inOffset, outFd, &outOffset, length,
+                                 0);
+        if (n > 0)
+        {
+            length -= n;
+            continue;
+        }
+        if (n < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (n < 0 && errno != EXDEV && errno != ENOSYS && errno != EINVAL &&
+            errno != EOPNOTSUPP)
+        {
+            std::cerr << "Failed to copy the LID payload, ERROR=" << errno
+                      << "\n";
+            return PLDM_ERROR;
+        }
+
+        std::array<char, 64 * 1024> buffer;
+        auto count = pread(inFd, buffer.data(),
+                           std::min(length, buffer.size()), inOffset);
+        if (count <= 0 || pwrite(outFd, buffer.data(), count, outOffset) !=
+                              count)
+        {
+            std::cerr << "Failed to copy the LID payload, ERROR=" << errno
+                      << "\n";
+            return PLDM_ERROR;
+        }
+        inOffset += count;
+        outOffset += count;
+        length -= count;
+    }
+    return PLDM_SUCCESS;
+}
+
+/** @brief Read the header of a staged LID back, header is left empty while
+ *         it is not completely written yet
+ */
+int readLidHeader(const std::string& filePath, int fd,
+                  std::optional<LidHeader>& header)
+{
+    LidHeader lidHeader;
+    auto count = pread(fd, &lidHeader, sizeof(lidHeader), 0);
+    if (count < 0)
+    {
+        std::cerr << "Failed to read the LID header: " << filePath
+                  << " ERROR=" << errno << "\n";
+        return PLDM_ERROR;
+    }
+    if (static_cast<size_t>(count) < sizeof(lidHeader))
+    {
+        // The header is not completely written yet
+        return PLDM_SUCCESS;
+    }
+
+    constexpr auto magicNumber = 0x0222;
+    if (ntohs(lidHeader.magicNumber) != magicNumber)
+    {
+        std::cerr << "Invalid magic number: " << filePath << "\n";
+        return PLDM_ERROR;
+    }
+    header = lidHeader;
+    return PLDM_SUCCESS;
+}
+
+/** @brief Whether a header read back is the one of the LID being received */
+bool isSameLid(const LidHeader& header, const CodeUpdateLid& lid)
+{
+    return ntohl(header.lidNumber) == lid.lidNumber &&
+           ntohl(header.lidSize) == lid.lidSize &&
+           ntohl(header.headerSize) == lid.headerSize;
+}
+
+/** @brief Open the file the payload of a LID goes to, once its header is
+ *         known
+ */
+int openLidPayload(const LidHeader& header, CodeUpdateLid& lid)
+{
+    auto rc = createImageDirs();
+    if (rc != PLDM_SUCCESS)
+    {
+        return rc;
+    }
 
     constexpr auto bmcClass = 0x2000;
-    if (htons(header.lidClass) == bmcClass)
+    constexpr auto mode =
+        S_IRUSR | S_IWUSR | S_IRGRP | S_IWGRP | S_IROTH | S_IWOTH;
+    if (ntohs(header.lidClass) == bmcClass)
     {
         // Skip the header and concatenate the BMC LIDs into a tar file
-        std::ofstream ofs(tarImagePath,
-                          std::ios::out | std::ios::binary | std::ios::app);
-        ifs.seekg(htonl(header.headerSize));
-        ofs << ifs.rdbuf();
-        ofs.flush();
-        ofs.close();
+        lid.payload = std::make_shared<CustomFD>(
+            open(tarImagePath.c_str(), O_WRONLY | O_CREAT | O_CLOEXEC, mode));
+        std::lock_guard lock(codeUpdateLidsMutex);
+        struct stat st;
+        if ((*lid.payload)() == -1 || fstat((*lid.payload)(), &st) == -1)
+        {
+            std::cerr << "Failed to open the BMC tarball, ERROR=" << errno
+                      << "\n";
+            return PLDM_ERROR;
+        }
+        if (st.st_dev != tarImage.dev || st.st_ino != tarImage.ino)
+        {
+            tarImage = {st.st_dev, st.st_ino,
+                        static_cast<uint32_t>(st.st_size)};
+        }
+        lid.payloadBase = tarImage.end;
+        tarImage.end += ntohl(header.lidSize);
     }
     else
     {
         std::stringstream lidFileName;
-        lidFileName << std::hex << htonl(header.lidNumber) << ".lid";
-        auto lidNoHeaderPath = fs::path(lidDirPath) / lidFileName.str();
-        std::ofstream ofs(lidNoHeaderPath,
-                          std::ios::out | std::ios::binary | std::ios::trunc);
-        ifs.seekg(htonl(header.headerSize));
-        ofs << ifs.rdbuf();
-        ofs.flush();
-        ofs.close();
+        lidFileName << std::hex << ntohl(header.lidNumber) << ".lid";
+        lid.payloadPath = fs::path(lidDirPath) / lidFileName.str();
+        lid.payload = std::make_shared<CustomFD>(
+            open(lid.payloadPath.c_str(),
+                 O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, mode));
+        if ((*lid.payload)() == -1)
+        {
+            std::cerr << "Failed to create the LID file: " << lid.payloadPath
+                      << " ERROR=" << errno << "\n";
+            return PLDM_ERROR;
+        }
+    }
+
+    lid.headerKnown = true;
+    lid.lidNumber = ntohl(header.lidNumber);
+    lid.headerSize = ntohl(header.headerSize);
+    lid.lidSize = ntohl(header.lidSize);
+    return PLDM_SUCCESS;
+}
+
+/** @brief Give up on the payload of a LID received in part: a partial LID
+ *         file is removed, and the place of a BMC LID in the tarball is
+ *         taken back when nothing was placed after it
+ */
+void releasePayload(CodeUpdateLid& lid)
+{
+    if (lid.headerKnown)
+    {
+        if (!lid.payloadPath.empty())
+        {
+            std::error_code ec;
+            fs::remove(lid.payloadPath, ec);
+        }
+        else
+        {
+            std::lock_guard lock(codeUpdateLidsMutex);
+            if (lid.payloadBase + lid.lidSize == tarImage.end &&
+                ftruncate((*lid.payload)(), lid.payloadBase) == 0)
+            {
+                tarImage.end = lid.payloadBase;
+            }
+        }
+    }
+    lid.payload.reset();
+    lid.headerKnown = false;
+    lid.lidNumber = 0;
+    lid.headerSize = 0;
+    lid.lidSize = 0;
+    lid.payloadPath.clear();
+    lid.payloadBase = 0;
+    lid.payloadEnd = 0;
+}
 
+/** @brief Stop tracking a LID, unless it was replaced meanwhile */
+void eraseLid(const std::string& filePath,
+              const std::shared_ptr<CodeUpdateLid>& lid)
+{
+    std::lock_guard lock(codeUpdateLidsMutex);
+    auto it = codeUpdateLids.find(filePath);
+    if (it != codeUpdateLids.end() && it->second == lid)
+    {
+        codeUpdateLids.erase(it);
+    }
+}
+
+/** @brief Forget a LID that failed to be written */
+void forgetLid(const std::string& filePath,
+               const std::shared_ptr<CodeUpdateLid>& lid)
+{
+    releasePayload(*lid);
+    eraseLid(filePath, lid);
+}
+
+/** @brief Close a LID whose payload is all written */
+int finishLid(const std::string& filePath,
+              const std::shared_ptr<CodeUpdateLid>& entry)
+{
+    auto& lid = *entry;
+    int rc = PLDM_SUCCESS;
+    if (!lid.payloadPath.empty())
+    {
         // Set the lid file permissions to 440
         std::error_code ec;
-        fs::permissions(lidNoHeaderPath,
+        fs::permissions(lid.payloadPath,
                         fs::perms::owner_read | fs::perms::group_read,
                         fs::perm_options::replace, ec);
         if (ec)
         {
             std::cerr << "Failed to set the lid file permissions: "
                       << ec.message() << std::endl;
+            rc = PLDM_ERROR;
+        }
+    }
+    eraseLid(filePath, entry);
+    fs::remove(filePath);
+    return rc;
+}
+
+} // namespace
+
+int writeCodeUpdateLid(const std::string& filePath, uint32_t offset,
+                       uint32_t length, const LidChunkWriter& writeChunk)
+{
+    std::shared_ptr<CodeUpdateLid> entry;
+    {
+        std::lock_guard lock(codeUpdateLidsMutex);
+        auto& slot = codeUpdateLids[filePath];
+        if (!slot)
+        {
+            slot = std::make_shared<CodeUpdateLid>();
+        }
+        entry = slot;
+    }
+    auto& lid = *entry;
+    std::unique_lock lidLock(lid.mutex);
+
+    // The payload of a BMC LID has a fixed place in the tarball, so nothing
+    // is written past the end of the LID. Chunk 0 may start another LID, it
+    // is checked once its header is read back.
+    uint64_t end = static_cast<uint64_t>(offset) + length;
+    if (lid.headerKnown && offset != 0 &&
+        end > uint64_t{lid.headerSize} + lid.lidSize)
+    {
+        std::cerr << "LID chunk past the end of the LID: " << filePath
+                  << " OFFSET=" << offset << " LENGTH=" << length << "\n";
+        return PLDM_ERROR;
+    }
+
+    int rc = PLDM_SUCCESS;
+    if (lid.headerKnown && offset >= lid.headerSize)
+    {
+        // The payload is written with no lock held, chunks of this LID may
+        // be written at the same time
+        auto payload = lid.payload;
+        uint32_t at = lid.payloadBase + offset - lid.headerSize;
+        lidLock.unlock();
+        rc = writeChunk((*payload)(), at);
+        lidLock.lock();
+        if (payload != lid.payload)
+        {
+            std::cerr << "LID started over while a chunk was written: "
+                      << filePath << " OFFSET=" << offset << "\n";
             return PLDM_ERROR;
         }
     }
+    else
+    {
+        if (lid.stagingFd == -1)
+        {
+            lid.stagingFd = open(filePath.c_str(),
+                                 O_RDWR | O_CREAT | O_CLOEXEC, S_IRUSR);
+            if (lid.stagingFd == -1)
+            {
+                std::cerr << "could not open file " << filePath
+                          << " ERROR=" << errno << "\n";
+                forgetLid(filePath, entry);
+                return PLDM_ERROR;
+            }
+        }
+        rc = writeChunk(lid.stagingFd, offset);
+        for (auto i = offset; i < std::min<uint64_t>(end, sizeof(LidHeader));
+             ++i)
+        {
+            lid.headerStaged.set(i);
+        }
 
-    ifs.close();
-    fs::remove(filePath);
-    return PLDM_SUCCESS;
+        uint64_t from = offset;
+        if (rc == PLDM_SUCCESS && lid.headerStaged.all() &&
+            (!lid.headerKnown || offset == 0))
+        {
+            std::optional<LidHeader> header;
+            rc = readLidHeader(filePath, lid.stagingFd, header);
+            if (rc == PLDM_SUCCESS && lid.headerKnown &&
+                !(header && isSameLid(*header, lid)))
+            {
+                // Chunk 0 of another LID, the LID starts over without what
+                // was staged after the chunk
+                releasePayload(lid);
+                if (ftruncate(lid.stagingFd, end) == -1)
+                {
+                    std::cerr << "Failed to truncate the LID file: "
+                              << filePath << " ERROR=" << errno << "\n";
+                    rc = PLDM_ERROR;
+                }
+                if (end < sizeof(LidHeader))
+                {
+                    // The rest of the header staged was the previous LID's
+                    for (auto i = end; i < sizeof(LidHeader); ++i)
+                    {
+                        lid.headerStaged.reset(i);
+                    }
+                    header.reset();
+                }
+            }
+            if (rc == PLDM_SUCCESS && header && !lid.headerKnown)
+            {
+                // The header is just known, move all of the payload staged
+                // so far
+                struct stat st;
+                rc = openLidPayload(*header, lid);
+                if (rc == PLDM_SUCCESS && fstat(lid.stagingFd, &st) == -1)
+                {
+                    std::cerr << "file stat failed: " << filePath
+                              << " ERROR=" << errno << "\n";
+                    rc = PLDM_ERROR;
+                }
+                else if (rc == PLDM_SUCCESS)
+                {
+                    from = 0;
+                    end = std::max<uint64_t>(end, st.st_size);
+                }
+            }
+        }
+        if (rc == PLDM_SUCCESS && lid.headerKnown)
+        {
+            from = std::max<uint64_t>(from, lid.headerSize);
+            end = std::min(end, uint64_t{lid.headerSize} + lid.lidSize);
+            if (end > from)
+            {
+                rc = copyPayload(lid.stagingFd, from, (*lid.payload)(),
+                                 lid.payloadBase + from - lid.headerSize,
+                                 end - from);
+            }
+        }
+    }
+    if (rc != PLDM_SUCCESS)
+    {
+        forgetLid(filePath, entry);
+        return rc;
+    }
+    if (!lid.headerKnown)
+    {
+        return PLDM_SUCCESS;
+    }
+
+    if (end > lid.headerSize)
+    {
+        lid.payloadEnd = std::max<uint32_t>(lid.payloadEnd,
+                                            end - lid.headerSize);
+    }
+    if (lid.payloadEnd < lid.lidSize)
+    {
+        // File is not completely written yet
+        return PLDM_SUCCESS;
+    }
+    return finishLid(filePath, entry);
+}
+
+int writeCodeUpdateLid(const std::string& filePath, uint32_t offset,
+                       const char* buffer, uint32_t length)
+{
+    return writeCodeUpdateLid(
+        filePath, offset, length, [buffer, length](int fd, uint32_t at) {
+            uint32_t written = 0;
+            while (written < length)
+            {
+                auto n = pwrite(fd, buffer + written, length - written,
+                                at + written);
+                if (n < 0 && errno == EINTR)
+                {
+                    continue;
+                }
+                if (n < 0)
+                {
+                    std::cerr << "file write failed, ERROR=" << errno
+                              << ", LENGTH=" << length << "\n";
+                    return PLDM_ERROR;
+                }
+                written += n;
+            }
+            return PLDM_SUCCESS;
+        });
+}
+
+void resetCodeUpdateLids()
+{
+    std::lock_guard lock(codeUpdateLidsMutex);
+    codeUpdateLids.clear();
+    tarImage = {};
 }
 
 int CodeUpdate::assembleCodeUpdateImage()
@@ -825,11 +1244,10 @@ int CodeUpdate::assembleCodeUpdateImage()
                 return PLDM_ERROR;
             }
 
-            // Add the hostfw image to the directory where the contents were
-            // extracted
-            fs::copy_file(hostfwImagePath,
-                          fs::path(updateDirPath) / hostfwImageName,
-                          fs::copy_options::overwrite_existing);
+            // Move the hostfw image to the directory where the contents were
+            // extracted, both are in the staging directory
+            fs::rename(hostfwImagePath,
+                       fs::path(updateDirPath) / hostfwImageName);
 
             // Remove the tarball file, then re-generate it with so that the
             // hostfw image becomes part of the tarball
@@ -4,6 +4,8 @@
 #include "libpldmresponder/pdr_utils.hpp"
 #include "libpldmresponder/platform.hpp"
 
+#include <filesystem>
+#include <functional>
 #include <string>
 
 namespace pldm
@@ -99,10 +101,7 @@ class CodeUpdate
      *        is going on
      * @param[in] progress - yes/no
      */
-    void setCodeUpdateProgress(bool progress)
-    {
-        codeUpdateInProgress = progress;
-    }
+    void setCodeUpdateProgress(bool progress);
 
     /* @brief Method to indicate whether out of band code update
      *        is going on
@@ -284,12 +283,51 @@ int setBootSide(uint16_t entityInstance, uint8_t currState,
                 const std::vector<set_effecter_state_field>& stateField,
                 CodeUpdate* codeUpdate);
 
-/* @brief Method to process LIDs during inband update, such as verifying and
- *        removing the header to get them ready to be written to flash
- * @param[in] filePath - Path to the LID file
+/** @brief Directory where the lid files without a header are stored */
+extern std::filesystem::path lidDirPath;
+
+/** @brief Directory where the image files are stored as they are built */
+extern std::filesystem::path imageDirPath;
+
+/** @brief The path to the code update tarball file */
+extern std::filesystem::path tarImagePath;
+
+/** @brief Writes a chunk of a LID at an offset of a file
+ *  @param[in] fd - the file to write to
+ *  @param[in] offset - offset in the file
+ *  @return - PLDM_SUCCESS codes
+ */
+using LidChunkWriter = std::function<int(int fd, uint32_t offset)>;
+
+/* @brief Method to write a chunk of a LID received during inband update.
+ *        The chunks before the LID header is complete are staged in the
+ *        LID file, the payload that follows goes straight to where it is
+ *        needed: the BMC tarball for a BMC LID, else a LID file without the
+ *        header. The staged LID file is removed once the whole payload is
+ *        received. Chunk 0 sent again starts the LID over only if it holds
+ *        the header of another LID, and a chunk past the end of the LID is
+ *        rejected. Safe to call from the worker.
+ * @param[in] filePath - Path to the staged LID file
+ * @param[in] offset - offset of the chunk in the LID
+ * @param[in] length - length of the chunk
+ * @param[in] writeChunk - writes the chunk where it is asked to
  * @return - PLDM_SUCCESS codes
  */
-int processCodeUpdateLid(const std::string& filePath);
+int writeCodeUpdateLid(const std::string& filePath, uint32_t offset,
+                       uint32_t length, const LidChunkWriter& writeChunk);
+
+/* @brief Method to write a chunk of a LID received during inband update
+ * @param[in] filePath - Path to the staged LID file
+ * @param[in] offset - offset of the chunk in the LID
+ * @param[in] buffer - the chunk
+ * @param[in] length - length of the chunk
+ * @return - PLDM_SUCCESS codes
+ */
+int writeCodeUpdateLid(const std::string& filePath, uint32_t offset,
+                       const char* buffer, uint32_t length);
+
+/* @brief Method to forget the LIDs of an inband update being received */
+void resetCodeUpdateLids();
 
 /** @brief Method to assemble the code update tarball and trigger the
  *         phosphor software manager to create a version interface
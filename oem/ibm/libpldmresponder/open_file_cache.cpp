@@ -0,0 +1,135 @@
+#include "open_file_cache.hpp"
+
+#include "libpldm/base.h"
+#include "oem/ibm/libpldm/file_io.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <iostream>
+
+namespace pldm
+{
+namespace responder
+{
+
+OpenFileCache& OpenFileCache::get()
+{
+    static OpenFileCache cache;
+    return cache;
+}
+
+std::shared_ptr<const OpenFileCache::File>
+    OpenFileCache::open(const std::string& path)
+{
+    struct stat st;
+    if (stat(path.c_str(), &st) == -1)
+    {
+        auto err = errno;
+        erase(path);
+        errno = err;
+        return nullptr;
+    }
+
+    std::lock_guard lock(mutex);
+    auto it = std::find_if(files.begin(), files.end(),
+                           [&path](const auto& f) { return f.first == path; });
+    if (it != files.end())
+    {
+        if (it->second->matches(st))
+        {
+            files.splice(files.begin(), files, it);
+            return files.front().second;
+        }
+        files.erase(it);
+    }
+
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd == -1)
+    {
+        return nullptr;
+    }
+    if (fstat(fd, &st) == -1)
+    {
+        auto err = errno;
+        close(fd);
+        errno = err;
+        return nullptr;
+    }
+    posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+
+    if (files.size() >= maxEntries)
+    {
+        files.pop_back();
+    }
+    files.emplace_front(path, std::make_shared<const File>(fd, st));
+    return files.front().second;
+}
+
+int OpenFileCache::read(const std::string& path, uint32_t offset,
+                        uint32_t& length, Response& response)
+{
+    auto file = open(path);
+    if (!file)
+    {
+        if (errno == ENOENT)
+        {
+            std::cerr << "File does not exist, PATH=" << path << "\n";
+            return PLDM_INVALID_FILE_HANDLE;
+        }
+        std::cerr << "Unable to open file, FILE=" << path
+                  << " ERROR=" << errno << "\n";
+        return PLDM_ERROR;
+    }
+
+    if (offset >= file->size)
+    {
+        std::cerr << "Offset exceeds file size, OFFSET=" << offset
+                  << " FILE_SIZE=" << file->size << "\n";
+        return PLDM_DATA_OUT_OF_RANGE;
+    }
+    if (offset + length > file->size)
+    {
+        length = file->size - offset;
+    }
+
+    size_t currSize = response.size();
+    response.resize(currSize + length);
+    auto filePos = reinterpret_cast<char*>(response.data()) + currSize;
+    size_t done = 0;
+    while (done < length)
+    {
+        auto rc = pread(file->fd(), filePos + done, length - done,
+                        offset + done);
+        if (rc == -1 && errno == EINTR)
+        {
+            continue;
+        }
+        if (rc <= 0)
+        {
+            std::cerr << "Unable to read file, FILE=" << path
+                      << " ERROR=" << (rc ? errno : 0) << "\n";
+            response.resize(currSize);
+            return PLDM_ERROR;
+        }
+        done += rc;
+    }
+    return PLDM_SUCCESS;
+}
+
+void OpenFileCache::erase(const std::string& path)
+{
+    std::lock_guard lock(mutex);
+    files.remove_if([&path](const auto& f) { return f.first == path; });
+}
+
+size_t OpenFileCache::size()
+{
+    std::lock_guard lock(mutex);
+    return files.size();
+}
+
+} // namespace responder
+} // namespace pldm
@@ -0,0 +1,107 @@
+#pragma once
+
+#include "common/utils.hpp"
+#include "pldmd/handler.hpp"
+
+#include <sys/stat.h>
+#include <sys/types.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+
+namespace pldm
+{
+namespace responder
+{
+
+/** @class OpenFileCache
+ *
+ *  Hostboot reads hundreds of LIDs during an IPL, each one in many chunks
+ *  with a request per chunk. Rather than opening the LID again for every
+ *  chunk, the descriptor is kept here, opened with a sequential read-ahead
+ *  hint, and the chunks are read from it with pread.
+ *
+ *  A cached descriptor is only handed out while the path still names the
+ *  same file with the same size and modification time, so a LID replaced
+ *  or rewritten by a code update is opened afresh. Past maxEntries files
+ *  the least recently used descriptor is closed.
+ *
+ *  The cache is shared by the event loop and the DMA worker threads, an
+ *  entry stays open for as long as a user holds it, even once evicted.
+ */
+class OpenFileCache
+{
+  public:
+    static constexpr size_t maxEntries = 16;
+
+    struct File
+    {
+        File(int fd, const struct stat& st) :
+            fd(fd), dev(st.st_dev), ino(st.st_ino), mtime(st.st_mtim),
+            size(st.st_size)
+        {}
+
+        /** @brief Whether the file is still the one described by st */
+        bool matches(const struct stat& st) const
+        {
+            return dev == st.st_dev && ino == st.st_ino &&
+                   mtime.tv_sec == st.st_mtim.tv_sec &&
+                   mtime.tv_nsec == st.st_mtim.tv_nsec && size == st.st_size;
+        }
+
+        pldm::utils::CustomFD fd;
+        dev_t dev;
+        ino_t ino;
+        struct timespec mtime;
+        off_t size;
+    };
+
+    OpenFileCache() = default;
+    OpenFileCache(const OpenFileCache&) = delete;
+    OpenFileCache& operator=(const OpenFileCache&) = delete;
+
+    /** @brief The cache shared by the file handlers */
+    static OpenFileCache& get();
+
+    /** @brief Get an open descriptor for a file
+     *
+     *  @param[in] path - path of the file
+     *
+     *  @return the open file, nullptr with errno set if the file can't be
+     *          opened
+     */
+    std::shared_ptr<const File> open(const std::string& path);
+
+    /** @brief Read a chunk of a file at the end of a PLDM response
+     *
+     *  @param[in] path - path of the file
+     *  @param[in] offset - offset to read
+     *  @param[in/out] length - length to be read, trimmed to the end of file
+     *  @param[in] response - PLDM response
+     *
+     *  @return PLDM status code
+     */
+    int read(const std::string& path, uint32_t offset, uint32_t& length,
+             Response& response);
+
+    /** @brief Close the cached descriptor of a file, if any
+     *
+     *  @param[in] path - path of the file
+     */
+    void erase(const std::string& path);
+
+    size_t size();
+
+  private:
+    /** @brief Cached files by path, the most recently used first */
+    std::list<std::pair<std::string, std::shared_ptr<const File>>> files;
+    std::mutex mutex;
+};
+
+} // namespace responder
+} // namespace pldm
@@ -1,5 +1,6 @@
 #include "libpldm/base.h"
 #include "libpldm/file_io.h"
+#include "libpldm/utils.h"
 
 #include "libpldmresponder/file_io.hpp"
 #include "libpldmresponder/file_io_by_type.hpp"
@@ -8,10 +9,13 @@
 #include "libpldmresponder/file_io_type_lid.hpp"
 #include "libpldmresponder/file_io_type_pel.hpp"
 #include "libpldmresponder/file_table.hpp"
+#include "libpldmresponder/open_file_cache.hpp"
 #include "xyz/openbmc_project/Common/error.hpp"
 
 #include <nlohmann/json.hpp>
 
+#include <sys/socket.h>
+
 #include <filesystem>
 #include <fstream>
 
@@ -202,6 +206,313 @@ TEST(TransferDataHost, BadPath)
     ASSERT_EQ(responsePtr->payload[0], PLDM_ERROR);
 }
 
+class TestXdmaSession : public testing::Test
+{
+  public:
+    void SetUp() override
+    {
+        // A regular file stands in for the XDMA device: the window maps its
+        // start and the DMA operations are appended after it.
+        char tmpdev[] = "/tmp/pldm_xdma_dev.XXXXXX";
+        int fd = mkstemp(tmpdev);
+        close(fd);
+        devPath = tmpdev;
+        fs::resize_file(devPath, dma::XdmaSession::windowSize());
+        devFd = open(devPath.c_str(), O_RDWR | O_APPEND);
+        ASSERT_GE(devFd, 0);
+    }
+
+    void TearDown() override
+    {
+        fs::remove(devPath);
+    }
+
+    std::vector<dma::AspeedXdmaOp> readOps()
+    {
+        std::vector<dma::AspeedXdmaOp> ops(
+            (fs::file_size(devPath) - dma::XdmaSession::windowSize()) /
+            sizeof(dma::AspeedXdmaOp));
+        std::ifstream dev(devPath, std::ios::binary);
+        dev.seekg(dma::XdmaSession::windowSize());
+        dev.read(reinterpret_cast<char*>(ops.data()),
+                 ops.size() * sizeof(dma::AspeedXdmaOp));
+        return ops;
+    }
+
+    fs::path devPath;
+    int devFd = -1;
+};
+
+TEST_F(TestXdmaSession, Upstream)
+{
+    using namespace pldm::responder::dma;
+
+    std::vector<char> data(4096 * 3 + 32);
+    for (size_t i = 0; i < data.size(); ++i)
+    {
+        data[i] = i % 251;
+    }
+    char tmpfile[] = "/tmp/pldm_xdma_src.XXXXXX";
+    int fd = mkstemp(tmpfile);
+    ASSERT_EQ(write(fd, data.data(), data.size()),
+              static_cast<ssize_t>(data.size()));
+
+    {
+        XdmaSession session(devFd);
+        DMA dmaObj(session);
+        EXPECT_EQ(
+            dmaObj.transferDataHost(fd, 16, data.size() - 16, 0x1000, true),
+            0);
+        // The session keeps the same window for the next operation
+        EXPECT_EQ(dmaObj.transferDataHost(fd, 0, 16, 0x2000, true), 0);
+        // Reading past the end of the file fails
+        EXPECT_EQ(dmaObj.transferDataHost(fd, data.size(), 16, 0x3000, true),
+                  -1);
+    }
+
+    std::vector<char> window(data.size() - 16);
+    std::ifstream dev(devPath, std::ios::binary);
+    dev.read(window.data(), window.size());
+    EXPECT_TRUE(std::equal(data.begin(), data.begin() + 16, window.begin()));
+    EXPECT_TRUE(
+        std::equal(data.begin() + 32, data.end(), window.begin() + 16));
+
+    auto ops = readOps();
+    ASSERT_EQ(ops.size(), 2);
+    EXPECT_EQ(ops[0].hostAddr, 0x1000);
+    EXPECT_EQ(ops[0].len, data.size() - 16);
+    EXPECT_EQ(ops[0].upstream, 1);
+    EXPECT_EQ(ops[1].hostAddr, 0x2000);
+    EXPECT_EQ(ops[1].len, 16);
+    EXPECT_EQ(ops[1].upstream, 1);
+
+    close(fd);
+    fs::remove(tmpfile);
+}
+
+TEST_F(TestXdmaSession, Downstream)
+{
+    using namespace pldm::responder::dma;
+
+    std::vector<char> data(4096 * 2);
+    for (size_t i = 0; i < data.size(); ++i)
+    {
+        data[i] = i % 251;
+    }
+    {
+        std::fstream dev(devPath,
+                         std::ios::binary | std::ios::in | std::ios::out);
+        dev.write(data.data(), data.size());
+    }
+    char tmpfile[] = "/tmp/pldm_xdma_dst.XXXXXX";
+    int fd = mkstemp(tmpfile);
+
+    {
+        XdmaSession session(devFd);
+        DMA dmaObj(session);
+        EXPECT_EQ(dmaObj.transferDataHost(fd, 16, data.size(), 0x4000, false),
+                  0);
+    }
+
+    std::vector<char> out(data.size() + 16);
+    ASSERT_EQ(pread(fd, out.data(), out.size(), 0),
+              static_cast<ssize_t>(out.size()));
+    EXPECT_TRUE(std::equal(data.begin(), data.end(), out.begin() + 16));
+
+    auto ops = readOps();
+    ASSERT_EQ(ops.size(), 1);
+    EXPECT_EQ(ops[0].hostAddr, 0x4000);
+    EXPECT_EQ(ops[0].len, data.size());
+    EXPECT_EQ(ops[0].upstream, 0);
+
+    close(fd);
+    fs::remove(tmpfile);
+}
+
+TEST_F(TestXdmaSession, ToSocket)
+{
+    using namespace pldm::responder::dma;
+
+    std::vector<char> data(4096 + 32);
+    for (size_t i = 0; i < data.size(); ++i)
+    {
+        data[i] = i % 251;
+    }
+    {
+        std::fstream dev(devPath,
+                         std::ios::binary | std::ios::in | std::ios::out);
+        dev.write(data.data(), data.size());
+    }
+    int socks[2];
+    ASSERT_EQ(socketpair(AF_UNIX, SOCK_STREAM, 0, socks), 0);
+
+    XdmaSession session(devFd);
+    DMA dmaObj(session);
+    EXPECT_EQ(dmaObj.transferHostDataToSocket(socks[0], maxSize + minSize,
+                                              0x5000),
+              -EINVAL);
+    EXPECT_EQ(dmaObj.transferHostDataToSocket(socks[0], data.size(), 0x5000),
+              0);
+    // The data is copied out of the window before the call returns, so the
+    // window is free for the next operation
+    memset(session.window(), 0, data.size());
+
+    std::vector<char> received(data.size());
+    size_t count = 0;
+    while (count < received.size())
+    {
+        auto n = read(socks[1], received.data() + count,
+                      received.size() - count);
+        ASSERT_GT(n, 0);
+        count += n;
+    }
+    EXPECT_EQ(received, data);
+
+    auto ops = readOps();
+    ASSERT_EQ(ops.size(), 1);
+    EXPECT_EQ(ops[0].hostAddr, 0x5000);
+    EXPECT_EQ(ops[0].len, data.size());
+    EXPECT_EQ(ops[0].upstream, 0);
+
+    close(socks[0]);
+    close(socks[1]);
+}
+
+class TestPipeline : public testing::Test
+{
+  public:
+    static constexpr uint32_t chunkSize = 4096;
+
+    void SetUp() override
+    {
+        // A regular file stands in for the XDMA device, as for the session
+        char tmpdev[] = "/tmp/pldm_xdma_dev.XXXXXX";
+        int fd = mkstemp(tmpdev);
+        close(fd);
+        devPath = tmpdev;
+        fs::resize_file(devPath, dma::XdmaSession::windowSize(chunkSize));
+        session = std::make_unique<dma::XdmaSession>(
+            open(devPath.c_str(), O_RDWR | O_APPEND), chunkSize);
+    }
+
+    void TearDown() override
+    {
+        session.reset();
+        fs::remove(devPath);
+    }
+
+    std::vector<dma::AspeedXdmaOp> readOps()
+    {
+        auto windowSize = dma::XdmaSession::windowSize(chunkSize);
+        std::vector<dma::AspeedXdmaOp> ops(
+            (fs::file_size(devPath) - windowSize) / sizeof(dma::AspeedXdmaOp));
+        std::ifstream dev(devPath, std::ios::binary);
+        dev.seekg(windowSize);
+        dev.read(reinterpret_cast<char*>(ops.data()),
+                 ops.size() * sizeof(dma::AspeedXdmaOp));
+        return ops;
+    }
+
+    fs::path devPath;
+    std::unique_ptr<dma::XdmaSession> session;
+};
+
+TEST_F(TestPipeline, Upstream)
+{
+    std::vector<char> data(chunkSize * 4 + 32);
+    for (size_t i = 0; i < data.size(); ++i)
+    {
+        data[i] = i % 251;
+    }
+    char tmpfile[] = "/tmp/pldm_xdma_src.XXXXXX";
+    int fd = mkstemp(tmpfile);
+    ASSERT_EQ(write(fd, data.data(), data.size()),
+              static_cast<ssize_t>(data.size()));
+
+    {
+        dma::Pipeline pipeline(*session);
+        EXPECT_EQ(pipeline.transfer(fd, 0, data.size(), 0x10000, true), 0);
+    }
+
+    // The chunks go through the window one after the other
+    auto ops = readOps();
+    ASSERT_EQ(ops.size(), 5);
+    for (size_t i = 0; i < ops.size(); ++i)
+    {
+        EXPECT_EQ(ops[i].hostAddr, 0x10000 + i * chunkSize);
+        EXPECT_EQ(ops[i].len, i == 4 ? 32 : chunkSize);
+        EXPECT_EQ(ops[i].upstream, 1);
+    }
+
+    // and the window holds the last one
+    std::vector<char> window(chunkSize);
+    std::ifstream dev(devPath, std::ios::binary);
+    dev.read(window.data(), window.size());
+    EXPECT_TRUE(std::equal(data.begin() + chunkSize * 4, data.end(),
+                           window.begin()));
+
+    close(fd);
+    fs::remove(tmpfile);
+}
+
+TEST_F(TestPipeline, UpstreamPastEndOfFile)
+{
+    std::vector<char> data(chunkSize * 3);
+    char tmpfile[] = "/tmp/pldm_xdma_src.XXXXXX";
+    int fd = mkstemp(tmpfile);
+    ASSERT_EQ(write(fd, data.data(), data.size()),
+              static_cast<ssize_t>(data.size()));
+
+    {
+        dma::Pipeline pipeline(*session);
+        EXPECT_EQ(pipeline.transfer(fd, 16, data.size(), 0x10000, true), -1);
+    }
+
+    // Nothing is sent from the chunk that could not be read on
+    EXPECT_LE(readOps().size(), 2);
+
+    close(fd);
+    fs::remove(tmpfile);
+}
+
+TEST_F(TestPipeline, Downstream)
+{
+    // The mock device leaves the window as is, so every chunk of the file
+    // gets its contents
+    {
+        std::vector<char> window(chunkSize, 'A');
+        std::fstream dev(devPath,
+                         std::ios::binary | std::ios::in | std::ios::out);
+        dev.write(window.data(), chunkSize);
+    }
+    char tmpfile[] = "/tmp/pldm_xdma_dst.XXXXXX";
+    int fd = mkstemp(tmpfile);
+
+    uint32_t length = chunkSize * 3 + 32;
+    {
+        dma::Pipeline pipeline(*session);
+        EXPECT_EQ(pipeline.transfer(fd, 16, length, 0x20000, false), 0);
+    }
+
+    std::vector<char> out(length + 16);
+    ASSERT_EQ(pread(fd, out.data(), out.size(), 0),
+              static_cast<ssize_t>(out.size()));
+    EXPECT_TRUE(std::all_of(out.begin() + 16, out.end(),
+                            [](char c) { return c == 'A'; }));
+
+    auto ops = readOps();
+    ASSERT_EQ(ops.size(), 4);
+    for (size_t i = 0; i < ops.size(); ++i)
+    {
+        EXPECT_EQ(ops[i].hostAddr, 0x20000 + i * chunkSize);
+        EXPECT_EQ(ops[i].len, i == 3 ? 32 : chunkSize);
+        EXPECT_EQ(ops[i].upstream, 0);
+    }
+
+    close(fd);
+    fs::remove(tmpfile);
+}
+
 TEST(ReadFileIntoMemory, BadPath)
 {
     uint32_t fileHandle = 0;
@@ -522,6 +833,78 @@ TEST_F(TestFileTable, ValidateFileTable)
               std::equal(attrTable.begin(), attrTable.end(), table.begin()));
 }
 
+TEST_F(TestFileTable, ValidateFileSizeUpdate)
+{
+    FileTable tableObj(fileTableConfig.c_str());
+    constexpr size_t imageSizeOffset = 17;
+    constexpr size_t cksumSizeOffset = 48;
+    constexpr size_t checksumOffset = 56;
+    auto fileSize = [&tableObj](size_t offset) {
+        uint32_t size{};
+        memcpy(&size, tableObj().data() + offset, sizeof(size));
+        return size;
+    };
+    auto checkSumValid = [&tableObj]() {
+        const auto& table = tableObj();
+        uint32_t checkSum{};
+        memcpy(&checkSum, table.data() + checksumOffset, sizeof(checkSum));
+        return checkSum == crc32(table.data(), checksumOffset);
+    };
+    ASSERT_EQ(tableObj(), attrTable);
+
+    // A file written to
+    std::ofstream(cksumFile, std::ios::app) << std::string(16, 'x');
+    EXPECT_EQ(fileSize(cksumSizeOffset), 32);
+    EXPECT_TRUE(checkSumValid());
+
+    // A file replaced, then written to
+    auto newImage = dir / "NVRAM-IMAGE.new";
+    std::ofstream(newImage) << std::string(10, 'x');
+    fs::rename(newImage, imageFile);
+    EXPECT_EQ(fileSize(imageSizeOffset), 10);
+    std::ofstream(imageFile, std::ios::app) << std::string(10, 'x');
+    EXPECT_EQ(fileSize(imageSizeOffset), 20);
+    EXPECT_EQ(fileSize(cksumSizeOffset), 32);
+    EXPECT_TRUE(checkSumValid());
+}
+
+TEST_F(TestFileTable, ValidateFileSizeUpdateAfterOverflow)
+{
+    FileTable tableObj(fileTableConfig.c_str());
+    constexpr size_t imageSizeOffset = 17;
+    constexpr size_t cksumSizeOffset = 48;
+    auto fileSize = [&tableObj](size_t offset) {
+        uint32_t size{};
+        memcpy(&size, tableObj().data() + offset, sizeof(size));
+        return size;
+    };
+    ASSERT_EQ(tableObj(), attrTable);
+
+    // Overflow the inotify queue, alternating between the files so that
+    // their events are not merged
+    size_t maxEvents = 0;
+    std::ifstream("/proc/sys/fs/inotify/max_queued_events") >> maxEvents;
+    ASSERT_NE(maxEvents, 0);
+    {
+        std::ofstream image(imageFile, std::ios::app);
+        std::ofstream cksum(cksumFile, std::ios::app);
+        for (size_t i = 0; i <= maxEvents / 2; i++)
+        {
+            image.put('x').flush();
+            cksum.put('x').flush();
+        }
+    }
+
+    // The file replaced once events are lost, then written to
+    auto newImage = dir / "NVRAM-IMAGE.new";
+    std::ofstream(newImage) << std::string(10, 'x');
+    fs::rename(newImage, imageFile);
+    EXPECT_EQ(fileSize(imageSizeOffset), 10);
+    EXPECT_EQ(fileSize(cksumSizeOffset), 16 + maxEvents / 2 + 1);
+    std::ofstream(imageFile, std::ios::app) << std::string(10, 'x');
+    EXPECT_EQ(fileSize(imageSizeOffset), 20);
+}
+
 TEST_F(TestFileTable, GetFileTableCommand)
 {
     // Initialise the file table with a valid handle of 0 & 1
@@ -846,6 +1229,108 @@ TEST(writeFileByTypeFromMemory, testBadPath)
     ASSERT_EQ(PLDM_ERROR_INVALID_LENGTH, resp->completion_code);
 }
 
+TEST(PelFdCache, LeastRecentlyUsed)
+{
+    auto openFd = [] { return open("/dev/null", O_RDONLY | O_CLOEXEC); };
+
+    PelFdCache cache;
+    for (uint32_t pelId = 0; pelId < PelFdCache::maxEntries; ++pelId)
+    {
+        auto& entry = cache.insert(pelId, openFd(), 100 + pelId);
+        EXPECT_EQ(entry.pelId, pelId);
+        EXPECT_EQ(entry.size, 100 + pelId);
+    }
+    ASSERT_EQ(cache.size(), PelFdCache::maxEntries);
+
+    // PEL 0 is used again, so PEL 1 is the least recently used one
+    auto entry = cache.find(0);
+    ASSERT_NE(entry, nullptr);
+    EXPECT_EQ(entry->size, 100);
+    int fd = entry->fd();
+    EXPECT_NE(fcntl(fd, F_GETFD), -1);
+
+    cache.insert(PelFdCache::maxEntries, openFd(), 42);
+    EXPECT_EQ(cache.size(), PelFdCache::maxEntries);
+    EXPECT_EQ(cache.find(1), nullptr);
+    ASSERT_NE(cache.find(0), nullptr);
+    EXPECT_EQ(cache.find(0)->fd(), fd);
+
+    // Acknowledging a PEL closes its descriptor
+    cache.erase(0);
+    EXPECT_EQ(cache.find(0), nullptr);
+    EXPECT_EQ(fcntl(fd, F_GETFD), -1);
+    EXPECT_EQ(cache.size(), PelFdCache::maxEntries - 1);
+}
+
+/** @brief A PEL of a recoverable error, the severity byte is at 0x3A */
+static std::vector<uint8_t> recoverablePel()
+{
+    std::vector<uint8_t> pel(0x40, 0);
+    pel[0x3A] = 0x10;
+    return pel;
+}
+
+TEST(PelStage, SeverityFromMemfd)
+{
+    detail::PelStage pel;
+    ASSERT_TRUE(pel);
+    if (!pel.isMemfd())
+    {
+        GTEST_SKIP() << "memfds are disabled";
+    }
+    EXPECT_EQ(pel.path().rfind("/proc/", 0), 0);
+
+    auto data = recoverablePel();
+    ASSERT_EQ(write(pel(), data.data(), data.size()),
+              static_cast<ssize_t>(data.size()));
+    pel.seal();
+    EXPECT_EQ(detail::getEntryLevelFromPEL(pel()),
+              sdbusplus::xyz::openbmc_project::Logging::server::Entry::Level::
+                  Warning);
+}
+
+TEST(PelStage, SealedMemfdRejectsWrites)
+{
+    detail::PelStage pel;
+    ASSERT_TRUE(pel);
+    if (!pel.isMemfd())
+    {
+        GTEST_SKIP() << "memfds are disabled";
+    }
+
+    auto data = recoverablePel();
+    ASSERT_EQ(write(pel(), data.data(), data.size()),
+              static_cast<ssize_t>(data.size()));
+    pel.seal();
+
+    uint8_t sev = 0x40;
+    EXPECT_EQ(pwrite(pel(), &sev, sizeof(sev), 0x3A), -1);
+    EXPECT_EQ(errno, EPERM);
+    EXPECT_EQ(ftruncate(pel(), 0), -1);
+    EXPECT_EQ(write(pel(), data.data(), data.size()), -1);
+
+    uint8_t readBack{};
+    ASSERT_EQ(pread(pel(), &readBack, sizeof(readBack), 0x3A), 1);
+    EXPECT_EQ(readBack, 0x10);
+}
+
+TEST(PelStage, DiscardRemovesFile)
+{
+    detail::PelStage pel(false);
+    ASSERT_TRUE(pel);
+    EXPECT_FALSE(pel.isMemfd());
+    ASSERT_TRUE(fs::exists(pel.path()));
+
+    // The file is not sealed, the daemon removes it once read
+    pel.seal();
+    auto data = recoverablePel();
+    EXPECT_EQ(write(pel(), data.data(), data.size()),
+              static_cast<ssize_t>(data.size()));
+
+    pel.discard();
+    EXPECT_FALSE(fs::exists(pel.path()));
+}
+
 TEST(getHandlerByType, allPaths)
 {
     uint32_t fileHandle{};
@@ -987,3 +1472,52 @@ TEST(readFileByType, testReadFile)
     ASSERT_EQ(response.size(), in.size());
     ASSERT_EQ(std::equal(in.begin(), in.end(), response.begin()), true);
 }
+
+TEST(OpenFileCache, ReadsFromCachedDescriptor)
+{
+    OpenFileCache cache;
+    Response response;
+    uint32_t length = 4;
+    ASSERT_EQ(cache.read("/tmp/lid.missing", 0, length, response),
+              PLDM_INVALID_FILE_HANDLE);
+
+    char tmplt[] = "/tmp/lid.XXXXXX";
+    auto fd = mkstemp(tmplt);
+    std::vector<uint8_t> in = {100, 10, 56, 78, 34, 56, 79, 235, 111};
+    ASSERT_EQ(write(fd, in.data(), in.size()),
+              static_cast<ssize_t>(in.size()));
+    close(fd);
+
+    // Chunks of the file come from the same descriptor
+    auto file = cache.open(tmplt);
+    ASSERT_NE(file, nullptr);
+    EXPECT_EQ(file->size, static_cast<off_t>(in.size()));
+    EXPECT_EQ(cache.open(tmplt), file);
+    ASSERT_EQ(cache.read(tmplt, 0, length, response), PLDM_SUCCESS);
+    length = 100;
+    ASSERT_EQ(cache.read(tmplt, 4, length, response), PLDM_SUCCESS);
+    EXPECT_EQ(length, in.size() - 4);
+    EXPECT_EQ(response, in);
+    length = 1;
+    EXPECT_EQ(cache.read(tmplt, in.size(), length, response),
+              PLDM_DATA_OUT_OF_RANGE);
+
+    // A file replaced under the same path is opened again
+    char replacement[] = "/tmp/lid.XXXXXX";
+    fd = mkstemp(replacement);
+    std::vector<uint8_t> newIn = {1, 2, 3};
+    ASSERT_EQ(write(fd, newIn.data(), newIn.size()),
+              static_cast<ssize_t>(newIn.size()));
+    close(fd);
+    ASSERT_EQ(rename(replacement, tmplt), 0);
+    response.clear();
+    length = 100;
+    ASSERT_EQ(cache.read(tmplt, 0, length, response), PLDM_SUCCESS);
+    EXPECT_EQ(response, newIn);
+    EXPECT_NE(cache.open(tmplt), file);
+    EXPECT_EQ(cache.size(), 1);
+
+    fs::remove(tmplt);
+    EXPECT_EQ(cache.open(tmplt), nullptr);
+    EXPECT_EQ(cache.size(), 0);
+}
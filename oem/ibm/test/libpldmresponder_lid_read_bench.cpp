@@ -0,0 +1,215 @@
+#include "libpldm/base.h"
+#include "oem/ibm/libpldm/file_io.h"
+
+#include "libpldmresponder/open_file_cache.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace pldm;
+using namespace pldm::responder;
+namespace fs = std::filesystem;
+
+namespace
+{
+
+constexpr size_t lidCount = 64;
+constexpr uint32_t chunkSize = 4096;
+constexpr size_t rounds = 8;
+
+/** @brief One ReadFileByType of a LID */
+struct LidRead
+{
+    std::string path;
+    uint32_t offset;
+    uint32_t length;
+};
+
+/** @brief How FileHandler::readFile reads a chunk, opening the file anew */
+int readByPath(const std::string& path, uint32_t offset, uint32_t& length,
+               Response& response)
+{
+    if (!fs::exists(path))
+    {
+        return PLDM_INVALID_FILE_HANDLE;
+    }
+    size_t fileSize = fs::file_size(path);
+    if (offset >= fileSize)
+    {
+        return PLDM_DATA_OUT_OF_RANGE;
+    }
+    if (offset + length > fileSize)
+    {
+        length = fileSize - offset;
+    }
+    size_t currSize = response.size();
+    response.resize(currSize + length);
+    std::ifstream stream(path, std::ios::in | std::ios::binary);
+    if (stream)
+    {
+        stream.seekg(offset);
+        stream.read(reinterpret_cast<char*>(response.data()) + currSize,
+                    length);
+        return PLDM_SUCCESS;
+    }
+    return PLDM_ERROR;
+}
+
+/** @brief Load a recorded LID read sequence, one "<file handle in hex>
+ *         <offset> <length>" line per ReadFileByType
+ */
+std::vector<LidRead> loadTrace(const std::string& trace, const fs::path& dir)
+{
+    std::vector<LidRead> reads;
+    std::ifstream file(trace);
+    std::string line;
+    while (std::getline(file, line))
+    {
+        std::istringstream fields(line);
+        std::string handle;
+        uint32_t offset{};
+        uint32_t length{};
+        if (fields >> handle >> offset >> length)
+        {
+            reads.push_back({dir / (handle + ".lid"), offset, length});
+        }
+    }
+    return reads;
+}
+
+/** @brief Write LIDs of IPL sizes to dir and the sequence hostboot reads
+ *         them in: the header of every LID first, then each LID in chunks,
+ *         with a few LIDs loaded a second time later in the IPL
+ */
+std::vector<LidRead> makeTrace(const fs::path& dir)
+{
+    std::mt19937 gen(1);
+    std::uniform_int_distribution<uint32_t> size(16 * 1024, 1024 * 1024);
+    std::vector<uint8_t> data(1024 * 1024, 0x5a);
+    std::vector<std::pair<std::string, uint32_t>> lids;
+    for (size_t i = 0; i < lidCount; ++i)
+    {
+        std::stringstream name;
+        name << std::hex << 0x80a00000 + i << ".lid";
+        auto path = dir / name.str();
+        auto lidSize = size(gen);
+        std::ofstream(path, std::ios::binary)
+            .write(reinterpret_cast<const char*>(data.data()), lidSize);
+        lids.emplace_back(path, lidSize);
+    }
+
+    std::vector<LidRead> reads;
+    for (const auto& [path, lidSize] : lids)
+    {
+        reads.push_back({path, 0, 256});
+    }
+    auto load = [&reads](const std::string& path, uint32_t lidSize) {
+        for (uint32_t offset = 0; offset < lidSize; offset += chunkSize)
+        {
+            reads.push_back({path, offset, chunkSize});
+        }
+    };
+    for (const auto& [path, lidSize] : lids)
+    {
+        load(path, lidSize);
+    }
+    for (size_t i = 0; i < lids.size(); i += 8)
+    {
+        load(lids[i].first, lids[i].second);
+    }
+    return reads;
+}
+
+uint64_t replay(
+    const std::vector<LidRead>& reads,
+    const std::function<int(const std::string&, uint32_t, uint32_t&,
+                            Response&)>& read,
+    size_t& bytes)
+{
+    Response response;
+    bytes = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t round = 0; round < rounds; ++round)
+    {
+        for (const auto& lidRead : reads)
+        {
+            response.resize(sizeof(pldm_msg_hdr) + 5);
+            auto length = lidRead.length;
+            if (read(lidRead.path, lidRead.offset, length, response) ==
+                PLDM_SUCCESS)
+            {
+                bytes += length;
+            }
+        }
+    }
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now() - start)
+        .count();
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    if (argc != 1 && argc != 3)
+    {
+        std::cerr << "Usage: " << argv[0] << " [<trace> <LID directory>]\n";
+        return EXIT_FAILURE;
+    }
+
+    fs::path tmpDir;
+    std::vector<LidRead> reads;
+    if (argc == 3)
+    {
+        reads = loadTrace(argv[1], argv[2]);
+    }
+    else
+    {
+        char tmplt[] = "/tmp/lid_read_bench.XXXXXX";
+        if (!mkdtemp(tmplt))
+        {
+            std::cerr << "Failed to create a directory for the LIDs\n";
+            return EXIT_FAILURE;
+        }
+        tmpDir = tmplt;
+        reads = makeTrace(tmpDir);
+    }
+    if (reads.empty())
+    {
+        std::cerr << "No LID reads to replay\n";
+        return EXIT_FAILURE;
+    }
+
+    auto& cache = OpenFileCache::get();
+    auto cached = [&cache](const std::string& path, uint32_t offset,
+                           uint32_t& length, Response& response) {
+        return cache.read(path, offset, length, response);
+    };
+
+    // Warm the page cache so that both runs read from memory
+    size_t bytes{};
+    replay(reads, readByPath, bytes);
+
+    auto byPath = replay(reads, readByPath, bytes);
+    auto byCache = replay(reads, cached, bytes);
+
+    auto total = reads.size() * rounds;
+    std::cout << "LID reads: " << total << " chunks, " << bytes
+              << " bytes\n";
+    std::cout << "  open per chunk:  " << byPath / total << " ns/chunk\n";
+    std::cout << "  open file cache: " << byCache / total << " ns/chunk\n";
+
+    if (!tmpDir.empty())
+    {
+        fs::remove_all(tmpDir);
+    }
+    return 0;
+}
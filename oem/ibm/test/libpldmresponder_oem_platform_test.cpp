@@ -10,9 +10,18 @@
 #include "oem/ibm/libpldmresponder/inband_code_update.hpp"
 #include "oem/ibm/libpldmresponder/oem_ibm_handler.hpp"
 
+#include <arpa/inet.h>
+
 #include <sdeventplus/event.hpp>
 
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <future>
 #include <iostream>
+#include <iterator>
+#include <vector>
 
 using namespace pldm::dbus_api;
 using namespace pldm::utils;
@@ -404,3 +413,262 @@ TEST(generateStateSensorOEMPDR, testGoodRequest)
 
     pldm_pdr_destroy(inPDRRepo);
 }
+
+/** @brief Stages the LIDs of an inband update in a directory of its own */
+class CodeUpdateLidTest : public testing::Test
+{
+  protected:
+    static constexpr uint16_t bmcClass = 0x2000;
+    static constexpr uint16_t hostClass = 0x0001;
+    static constexpr uint32_t headerSize = 64;
+
+    void SetUp() override
+    {
+        char tmpDir[] = "/tmp/codeUpdateLid.XXXXXX";
+        ASSERT_NE(mkdtemp(tmpDir), nullptr);
+        dir = tmpDir;
+        lidDirPath = dir / "lid";
+        imageDirPath = dir / "image";
+        tarImagePath = imageDirPath / "image.tar";
+        resetCodeUpdateLids();
+    }
+
+    void TearDown() override
+    {
+        resetCodeUpdateLids();
+        lidDirPath = savedLidDirPath;
+        imageDirPath = savedImageDirPath;
+        tarImagePath = savedTarImagePath;
+        fs::remove_all(dir);
+    }
+
+    /** @brief A LID with its header, the payload filled from fill */
+    static std::vector<char> makeLid(uint32_t lidNumber, uint16_t lidClass,
+                                     uint32_t lidSize, char fill)
+    {
+        std::vector<char> lid(headerSize + lidSize);
+        auto put16 = [&lid](size_t at, uint16_t value) {
+            value = htons(value);
+            memcpy(lid.data() + at, &value, sizeof(value));
+        };
+        auto put32 = [&lid](size_t at, uint32_t value) {
+            value = htonl(value);
+            memcpy(lid.data() + at, &value, sizeof(value));
+        };
+        put16(0, 0x0222);
+        put32(4, lidNumber);
+        put16(14, lidClass);
+        put32(20, lidSize);
+        put32(24, headerSize);
+        for (uint32_t i = 0; i < lidSize; ++i)
+        {
+            lid[headerSize + i] = fill + i % 7;
+        }
+        return lid;
+    }
+
+    static std::vector<char> payload(const std::vector<char>& lid)
+    {
+        return {lid.begin() + headerSize, lid.end()};
+    }
+
+    int send(const fs::path& path, const std::vector<char>& lid,
+             uint32_t offset, uint32_t length)
+    {
+        return writeCodeUpdateLid(path, offset, lid.data() + offset, length);
+    }
+
+    /** @brief Send a LID in chunks, in order */
+    void sendAll(const fs::path& path, const std::vector<char>& lid,
+                 uint32_t chunkSize)
+    {
+        for (uint32_t offset = 0; offset < lid.size(); offset += chunkSize)
+        {
+            auto length =
+                std::min<uint32_t>(chunkSize, lid.size() - offset);
+            ASSERT_EQ(send(path, lid, offset, length), PLDM_SUCCESS);
+        }
+    }
+
+    static std::vector<char> contents(const fs::path& path)
+    {
+        std::ifstream file(path, std::ios::binary);
+        return {std::istreambuf_iterator<char>(file),
+                std::istreambuf_iterator<char>()};
+    }
+
+    fs::path dir;
+
+  private:
+    fs::path savedLidDirPath = lidDirPath;
+    fs::path savedImageDirPath = imageDirPath;
+    fs::path savedTarImagePath = tarImagePath;
+};
+
+TEST_F(CodeUpdateLidTest, HeaderSplitAcrossChunks)
+{
+    auto lid = makeLid(0x80a00001, hostClass, 100, 'a');
+    auto staged = dir / "80a00001.lid";
+    sendAll(staged, lid, 16);
+
+    EXPECT_EQ(contents(lidDirPath / "80a00001.lid"), payload(lid));
+    EXPECT_FALSE(fs::exists(staged));
+    EXPECT_FALSE(fs::exists(tarImagePath));
+}
+
+TEST_F(CodeUpdateLidTest, ChunksBeforeTheHeader)
+{
+    // The payload arrives last chunk first, and the header after it
+    auto lid = makeLid(0x80a00002, bmcClass, 96, 'b');
+    auto staged = dir / "80a00002.lid";
+    for (uint32_t offset = lid.size() - 32; offset >= headerSize;
+         offset -= 32)
+    {
+        ASSERT_EQ(send(staged, lid, offset, 32), PLDM_SUCCESS);
+        EXPECT_TRUE(fs::exists(staged));
+    }
+    ASSERT_EQ(send(staged, lid, 0, headerSize), PLDM_SUCCESS);
+
+    EXPECT_EQ(contents(tarImagePath), payload(lid));
+    EXPECT_FALSE(fs::exists(staged));
+}
+
+TEST_F(CodeUpdateLidTest, BmcAndHostLids)
+{
+    auto bmcLid = makeLid(0x81e00001, bmcClass, 80, 'c');
+    auto hostLid = makeLid(0x80a00003, hostClass, 80, 'd');
+    sendAll(dir / "81e00001.lid", bmcLid, 24);
+    sendAll(dir / "80a00003.lid", hostLid, 24);
+
+    // Only the payload of the BMC LID goes into the tarball
+    EXPECT_EQ(contents(tarImagePath), payload(bmcLid));
+    EXPECT_EQ(contents(lidDirPath / "80a00003.lid"), payload(hostLid));
+    EXPECT_FALSE(fs::exists(lidDirPath / "81e00001.lid"));
+}
+
+TEST_F(CodeUpdateLidTest, TwoBmcLidsInFlight)
+{
+    auto first = makeLid(0x81e00002, bmcClass, 100, 'e');
+    auto second = makeLid(0x81e00003, bmcClass, 60, 'f');
+    auto firstStaged = dir / "81e00002.lid";
+    auto secondStaged = dir / "81e00003.lid";
+
+    // Each gets its place in the tarball from its header, in the order the
+    // headers come, whatever the order of the payload chunks
+    ASSERT_EQ(send(firstStaged, first, 0, headerSize), PLDM_SUCCESS);
+    ASSERT_EQ(send(secondStaged, second, 0, headerSize), PLDM_SUCCESS);
+    for (uint32_t offset = headerSize; offset < first.size(); offset += 20)
+    {
+        if (offset < second.size())
+        {
+            ASSERT_EQ(send(secondStaged, second, offset, 20), PLDM_SUCCESS);
+        }
+        ASSERT_EQ(send(firstStaged, first, offset, 20), PLDM_SUCCESS);
+    }
+
+    auto expected = payload(first);
+    auto secondPayload = payload(second);
+    expected.insert(expected.end(), secondPayload.begin(),
+                    secondPayload.end());
+    EXPECT_EQ(contents(tarImagePath), expected);
+}
+
+TEST_F(CodeUpdateLidTest, ChunkPastTheLid)
+{
+    auto first = makeLid(0x81e00004, bmcClass, 40, 'g');
+    auto second = makeLid(0x81e00005, bmcClass, 40, 'h');
+    auto firstStaged = dir / "81e00004.lid";
+    ASSERT_EQ(send(firstStaged, first, 0, headerSize), PLDM_SUCCESS);
+    sendAll(dir / "81e00005.lid", second, 32);
+
+    // A chunk running past the first LID would land on the second one
+    auto longer = first;
+    longer.resize(first.size() + 16, 'x');
+    EXPECT_EQ(send(firstStaged, longer, headerSize, 56), PLDM_ERROR);
+    ASSERT_EQ(send(firstStaged, first, headerSize, 40), PLDM_SUCCESS);
+
+    auto expected = payload(first);
+    auto secondPayload = payload(second);
+    expected.insert(expected.end(), secondPayload.begin(),
+                    secondPayload.end());
+    EXPECT_EQ(contents(tarImagePath), expected);
+}
+
+TEST_F(CodeUpdateLidTest, ChunkZeroSentAgain)
+{
+    auto lid = makeLid(0x81e00006, bmcClass, 90, 'i');
+    auto staged = dir / "81e00006.lid";
+    ASSERT_EQ(send(staged, lid, 0, 80), PLDM_SUCCESS);
+    ASSERT_EQ(send(staged, lid, 80, 40), PLDM_SUCCESS);
+
+    // The same LID keeps its place in the tarball and what it received
+    ASSERT_EQ(send(staged, lid, 0, 80), PLDM_SUCCESS);
+    ASSERT_EQ(send(staged, lid, 120, lid.size() - 120), PLDM_SUCCESS);
+
+    EXPECT_EQ(contents(tarImagePath), payload(lid));
+    EXPECT_FALSE(fs::exists(staged));
+}
+
+TEST_F(CodeUpdateLidTest, ChunkZeroOfAnotherLid)
+{
+    auto lid = makeLid(0x81e00007, bmcClass, 90, 'j');
+    auto other = makeLid(0x81e00008, bmcClass, 50, 'k');
+    auto staged = dir / "81e00007.lid";
+    ASSERT_EQ(send(staged, lid, 0, 100), PLDM_SUCCESS);
+
+    // The LID starts over as the other one, in the place of the first
+    sendAll(staged, other, 32);
+
+    EXPECT_EQ(contents(tarImagePath), payload(other));
+    EXPECT_FALSE(fs::exists(staged));
+}
+
+TEST_F(CodeUpdateLidTest, ResetByCodeUpdateProgress)
+{
+    auto mockDbusHandler = std::make_unique<MockdBusHandler>();
+    auto codeUpdate = std::make_unique<MockCodeUpdate>(mockDbusHandler.get());
+    auto lid = makeLid(0x81e00009, bmcClass, 90, 'l');
+    auto staged = dir / "81e00009.lid";
+
+    // An update aborted part way through the LID
+    codeUpdate->setCodeUpdateProgress(true);
+    ASSERT_EQ(send(staged, lid, 0, 100), PLDM_SUCCESS);
+    codeUpdate->setCodeUpdateProgress(false);
+    codeUpdate->clearDirPath(dir);
+
+    // The next update receives the LID from the start
+    codeUpdate->setCodeUpdateProgress(true);
+    sendAll(staged, lid, 32);
+
+    EXPECT_EQ(contents(tarImagePath), payload(lid));
+    EXPECT_FALSE(fs::exists(staged));
+}
+
+TEST_F(CodeUpdateLidTest, PayloadWrittenWithoutLock)
+{
+    auto bmcLid = makeLid(0x81e0000a, bmcClass, 64, 'm');
+    auto hostLid = makeLid(0x80a00005, hostClass, 64, 'n');
+    auto bmcStaged = dir / "81e0000a.lid";
+    ASSERT_EQ(send(bmcStaged, bmcLid, 0, headerSize), PLDM_SUCCESS);
+
+    // Another LID is received while a payload chunk is being written, as
+    // the worker writes the chunks it gets from host memory
+    std::future<void> other;
+    auto rc = writeCodeUpdateLid(
+        bmcStaged, headerSize, 64, [&](int fd, uint32_t at) {
+            other = std::async(std::launch::async, [&]() {
+                sendAll(dir / "80a00005.lid", hostLid, 32);
+            });
+            EXPECT_EQ(other.wait_for(std::chrono::seconds(5)),
+                      std::future_status::ready);
+            return pwrite(fd, bmcLid.data() + headerSize, 64, at) == 64
+                       ? PLDM_SUCCESS
+                       : PLDM_ERROR;
+        });
+    other.wait();
+    ASSERT_EQ(rc, PLDM_SUCCESS);
+
+    EXPECT_EQ(contents(tarImagePath), payload(bmcLid));
+    EXPECT_EQ(contents(lidDirPath / "80a00005.lid"), payload(hostLid));
+    EXPECT_FALSE(fs::exists(bmcStaged));
+}
@@ -2,9 +2,14 @@
 
 #include "libpldm/base.h"
 
+#include "worker.hpp"
+
+#include <array>
 #include <cassert>
 #include <functional>
-#include <map>
+#include <limits>
+#include <optional>
+#include <utility>
 #include <vector>
 
 namespace pldm
@@ -20,20 +25,152 @@ class CmdHandler;
 using HandlerFunc =
     std::function<Response(const pldm_msg* request, size_t reqMsgLen)>;
 
+/** @brief Sends a response message to the endpoint with the given EID */
+using ResponseSender =
+    std::function<void(uint8_t eid, const Response& response)>;
+
+/** @class DeferredResponse
+ *
+ *  Completes a request whose handler finishes its work after returning. The
+ *  handler takes the token with CmdHandler::deferResponse() and returns an
+ *  empty response, then calls complete() once the response is ready, either
+ *  on the event loop or on another thread. pldmd sends the response from the
+ *  event loop, to the EID the request came from.
+ *
+ *  The request message is gone once the handler returns, the token keeps
+ *  what is needed of its header.
+ */
+class DeferredResponse
+{
+  public:
+    /** @brief Constructor
+     *
+     *  @param[in] eid - EID of the endpoint the request came from
+     *  @param[in] hdr - header of the request
+     *  @param[in] sender - sends the response
+     */
+    DeferredResponse(uint8_t eid, const pldm_msg_hdr& hdr,
+                     ResponseSender sender) :
+        eid(eid),
+        hdr(hdr), sender(std::move(sender))
+    {}
+
+    /** @brief Send the response of the request
+     *
+     *  @param[in] response - PLDM response message
+     */
+    void complete(const Response& response) const
+    {
+        sender(eid, response);
+    }
+
+    /** @brief Send a response containing only cc
+     *
+     *  @param[in] cc - Completion Code
+     */
+    void complete(uint8_t cc) const
+    {
+        Response response(sizeof(pldm_msg), 0);
+        auto ptr = reinterpret_cast<pldm_msg*>(response.data());
+        auto rc = encode_cc_only_resp(hdr.instance_id, hdr.type, hdr.command,
+                                      cc, ptr);
+        assert(rc == PLDM_SUCCESS);
+        sender(eid, response);
+    }
+
+    /** @brief Instance ID of the request */
+    uint8_t instanceId() const
+    {
+        return hdr.instance_id;
+    }
+
+  private:
+    /** @brief EID of the endpoint the request came from */
+    uint8_t eid;
+
+    /** @brief Header of the request */
+    pldm_msg_hdr hdr;
+
+    ResponseSender sender;
+};
+
+/** @class HandlerTable
+ *
+ *  Flat table of command handlers, indexed by the command code, so looking
+ *  up a command costs one array access whether it is supported or not
+ */
+class HandlerTable
+{
+  public:
+    /** @brief Register the handler of a command, a command keeps the first
+     *         handler registered for it
+     *
+     *  @param[in] pldmCommand - PLDM command code
+     *  @param[in] handler - command handler
+     */
+    void emplace(Command pldmCommand, HandlerFunc handler)
+    {
+        if (!table[pldmCommand])
+        {
+            table[pldmCommand] = std::move(handler);
+        }
+    }
+
+    /** @brief Look up the handler of a command
+     *
+     *  @param[in] pldmCommand - PLDM command code
+     *  @return the handler, nullptr if the command is not supported
+     */
+    const HandlerFunc* find(Command pldmCommand) const
+    {
+        const auto& handler = table[pldmCommand];
+        return handler ? &handler : nullptr;
+    }
+
+  private:
+    std::array<HandlerFunc, std::numeric_limits<Command>::max() + 1> table;
+};
+
 class CmdHandler
 {
   public:
+    virtual ~CmdHandler() = default;
+
     /** @brief Invoke a PLDM command handler
      *
+     *  @param[in] eid - EID of the endpoint the request came from
      *  @param[in] pldmCommand - PLDM command code
      *  @param[in] request - PLDM request message
      *  @param[in] reqMsgLen - PLDM request message size
-     *  @return PLDM response message
+     *  @return PLDM response message, empty if the handler deferred it,
+     *          std::nullopt if the command is not supported
      */
-    Response handle(Command pldmCommand, const pldm_msg* request,
-                    size_t reqMsgLen)
+    std::optional<Response> handle(uint8_t eid, Command pldmCommand,
+                                   const pldm_msg* request, size_t reqMsgLen)
     {
-        return handlers.at(pldmCommand)(request, reqMsgLen);
+        auto handler = handlers.find(pldmCommand);
+        if (!handler)
+        {
+            return std::nullopt;
+        }
+        requestEid = eid;
+        requestHdr = request ? request->hdr : pldm_msg_hdr{};
+        deferred = false;
+        auto response = (*handler)(request, reqMsgLen);
+        if (deferred)
+        {
+            return Response{};
+        }
+        return response;
+    }
+
+    /** @brief Set the function deferred responses are sent with
+     *
+     *  @param[in] sender - sends a response to an endpoint
+     */
+    void setResponseSender(ResponseSender sender)
+    {
+        responseSender = std::move(sender);
     }
 
     /** @brief Create a response message containing only cc
@@ -54,10 +191,65 @@ class CmdHandler
     }
 
   protected:
-    /** @brief map of PLDM command code to handler - to be populated by derived
-     *         classes.
+    /** @brief Whether the request being handled can have its response
+     *         deferred, a handler answers synchronously otherwise
+     */
+    bool canDeferResponse() const
+    {
+        return static_cast<bool>(responseSender);
+    }
+
+    /** @brief Defer the response of the request being handled
+     *
+     *  Only valid from within a handler, when canDeferResponse() is true.
+     *  The handler then returns an empty response.
+     *
+     *  @return token to send the response with
+     */
+    DeferredResponse deferResponse()
+    {
+        deferred = true;
+        return DeferredResponse(requestEid, requestHdr, responseSender);
+    }
+
+    /** @brief Answer the request being handled from the shared worker
+     *
+     *  The response is deferred and work() runs on the worker thread, see
+     *  Worker for what it may touch. It must not use the request message,
+     *  which is gone by then. If the response can't be deferred, work() runs
+     *  right away instead.
+     *
+     *  @param[in] work - builds the response
+     *
+     *  @return PLDM response message, empty if it is deferred
      */
-    std::map<Command, HandlerFunc> handlers;
+    Response respondFromWorker(std::function<Response()> work)
+    {
+        if (!canDeferResponse())
+        {
+            return work();
+        }
+        Worker::get().post(
+            [deferred = deferResponse(), work = std::move(work)] {
+                deferred.complete(work());
+            });
+        return {};
+    }
+
+    /** @brief table of PLDM command code to handler - to be populated by
+     *         derived classes.
+     */
+    HandlerTable handlers;
+
+  private:
+    ResponseSender responseSender;
+
+    /** @brief EID and header of the request being handled */
+    uint8_t requestEid = 0;
+    pldm_msg_hdr requestHdr{};
+
+    /** @brief Whether the handler of the request deferred its response */
+    bool deferred = false;
 };
 
 } // namespace responder
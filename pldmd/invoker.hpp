@@ -4,8 +4,10 @@
 
 #include "handler.hpp"
 
-#include <map>
+#include <array>
+#include <limits>
 #include <memory>
+#include <optional>
 
 namespace pldm
 {
@@ -25,25 +27,59 @@ class Invoker
      */
     void registerHandler(Type pldmType, std::unique_ptr<CmdHandler> handler)
     {
-        handlers.emplace(pldmType, std::move(handler));
+        if (!handlers[pldmType])
+        {
+            handler->setResponseSender(responseSender);
+            handlers[pldmType] = std::move(handler);
+        }
+    }
+
+    /** @brief Set the function deferred responses are sent with, for the
+     *         handlers registered so far and the ones registered later
+     *
+     *  @param[in] sender - sends a response to an endpoint
+     */
+    void setResponseSender(ResponseSender sender)
+    {
+        responseSender = std::move(sender);
+        for (auto& handler : handlers)
+        {
+            if (handler)
+            {
+                handler->setResponseSender(responseSender);
+            }
+        }
     }
 
     /** @brief Invoke a PLDM command handler
      *
+     *  @param[in] eid - EID of the endpoint the request came from
      *  @param[in] pldmType - PLDM type code
      *  @param[in] pldmCommand - PLDM command code
      *  @param[in] request - PLDM request message
      *  @param[in] reqMsgLen - PLDM request message size
-     *  @return PLDM response message
+     *  @return PLDM response message, empty if the handler deferred it,
+     *          std::nullopt if the PLDM type or the command is not supported
      */
-    Response handle(Type pldmType, Command pldmCommand, const pldm_msg* request,
-                    size_t reqMsgLen)
+    std::optional<Response> handle(uint8_t eid, Type pldmType,
+                                   Command pldmCommand,
+                                   const pldm_msg* request, size_t reqMsgLen)
     {
-        return handlers.at(pldmType)->handle(pldmCommand, request, reqMsgLen);
+        const auto& handler = handlers[pldmType];
+        if (!handler)
+        {
+            return std::nullopt;
+        }
+        return handler->handle(eid, pldmCommand, request, reqMsgLen);
     }
 
   private:
-    std::map<Type, std::unique_ptr<CmdHandler>> handlers;
+    ResponseSender responseSender;
+
+    /** @brief PLDM type handlers, indexed by the PLDM type code */
+    std::array<std::unique_ptr<CmdHandler>,
+               std::numeric_limits<Type>::max() + 1>
+        handlers;
 };
 
 } // namespace responder
@@ -10,11 +10,13 @@
 #include "invoker.hpp"
 #include "requester/handler.hpp"
 #include "requester/request.hpp"
+#include "worker.hpp"
 
 #include <err.h>
 #include <getopt.h>
 #include <poll.h>
 #include <stdlib.h>
+#include <sys/eventfd.h>
 #include <sys/socket.h>
 #include <sys/types.h>
 #include <sys/un.h>
@@ -32,10 +34,13 @@
 #include <iostream>
 #include <iterator>
 #include <memory>
+#include <mutex>
 #include <optional>
 #include <sstream>
 #include <stdexcept>
 #include <string>
+#include <thread>
+#include <utility>
 #include <vector>
 
 #ifdef LIBPLDMRESPONDER
@@ -63,6 +68,11 @@
 #include "host-bmc/dbus/custom_dbus.hpp"
 
 constexpr uint8_t MCTP_MSG_TYPE_PLDM = 1;
+// Largest message the MCTP demux daemon hands over, MCTP_MAX_MESSAGE_SIZE in
+// libmctp
+constexpr size_t maxMctpMessageSize = 64 * 1024;
+// Receive buffer size: the EID and MCTP message type come ahead of the message
+constexpr size_t maxRxMessageSize = maxMctpMessageSize + sizeof(uint8_t) * 2;
 
 using namespace pldm;
 using namespace sdeventplus;
@@ -79,10 +89,18 @@ void interruptFlightRecorderCallBack(Signal& /*signal*/,
 
     // obtain the flight recorder instance and dump the recorder
     FlightRecorder::GetInstance().playRecorder();
+
+    const auto& stats = DBusHandler::getStats();
+    std::cerr << "D-Bus mapper calls: " << stats.mapperCalls
+              << ", avoided by the service cache: " << stats.serviceCacheHits
+              << ", property gets: " << stats.propertyGets
+              << ", property getalls: " << stats.propertyGetAlls
+              << " returning " << stats.batchedProperties << " properties\n";
 }
 
 static std::optional<Response>
-    processRxMsg(const std::vector<uint8_t>& requestMsg, Invoker& invoker,
+    processRxMsg(const uint8_t* requestMsg, size_t requestMsgLen,
+                 Invoker& invoker,
                  requester::Handler<requester::Request>& handler)
 {
     using type = uint8_t;
@@ -90,7 +108,7 @@ static std::optional<Response>
 
     pldm_header_info hdrFields{};
     auto hdr = reinterpret_cast<const pldm_msg_hdr*>(
-        requestMsg.data() + sizeof(eid) + sizeof(type));
+        requestMsg + sizeof(eid) + sizeof(type));
     if (PLDM_SUCCESS != unpack_pldm_header(hdr, &hdrFields))
     {
         std::cerr << "Empty PLDM request header \n";
@@ -99,38 +117,22 @@ static std::optional<Response>
 
     if (PLDM_RESPONSE != hdrFields.msg_type)
     {
-        Response response;
         auto request = reinterpret_cast<const pldm_msg*>(hdr);
-        size_t requestLen = requestMsg.size() - sizeof(struct pldm_msg_hdr) -
+        size_t requestLen = requestMsgLen - sizeof(struct pldm_msg_hdr) -
                             sizeof(eid) - sizeof(type);
-        try
-        {
-            response = invoker.handle(hdrFields.pldm_type, hdrFields.command,
-                                      request, requestLen);
-        }
-        catch (const std::out_of_range& e)
+        auto response = invoker.handle(eid, hdrFields.pldm_type,
+                                       hdrFields.command, request, requestLen);
+        if (!response)
         {
-            uint8_t completion_code = PLDM_ERROR_UNSUPPORTED_PLDM_CMD;
-            response.resize(sizeof(pldm_msg_hdr));
-            auto responseHdr = reinterpret_cast<pldm_msg_hdr*>(response.data());
-            pldm_header_info header{};
-            header.msg_type = PLDM_RESPONSE;
-            header.instance = hdrFields.instance;
-            header.pldm_type = hdrFields.pldm_type;
-            header.command = hdrFields.command;
-            if (PLDM_SUCCESS != pack_pldm_header(&header, responseHdr))
-            {
-                std::cerr << "Failed adding response header \n";
-                return std::nullopt;
-            }
-            response.insert(response.end(), completion_code);
+            response = CmdHandler::ccOnlyResponse(
+                request, PLDM_ERROR_UNSUPPORTED_PLDM_CMD);
         }
         return response;
     }
     else if (PLDM_RESPONSE == hdrFields.msg_type)
     {
         auto response = reinterpret_cast<const pldm_msg*>(hdr);
-        size_t responseLen = requestMsg.size() - sizeof(struct pldm_msg_hdr) -
+        size_t responseLen = requestMsgLen - sizeof(struct pldm_msg_hdr) -
                              sizeof(eid) - sizeof(type);
         handler.handleResponse(eid, hdrFields.instance, hdrFields.pldm_type,
                                hdrFields.command, response, responseLen);
@@ -149,6 +151,10 @@ void optionUsage(void)
 
 int main(int argc, char** argv)
 {
+    // Blocked before any thread is started, so that every thread leaves
+    // them to the event loop
+    stdplus::signal::block(SIGTERM);
+    stdplus::signal::block(SIGINT);
 
     bool verbose = false;
     static struct option long_options[] = {
@@ -218,8 +224,10 @@ int main(int argc, char** argv)
 #ifdef LIBPLDMRESPONDER
     using namespace pldm::state_sensor;
     dbus_api::Host dbusImplHost(bus, "/xyz/openbmc_project/pldm");
+    // Arena-backed, host PDRs are dropped and refetched on every host
+    // power cycle
     std::unique_ptr<pldm_pdr, decltype(&pldm_pdr_destroy)> pdrRepo(
-        pldm_pdr_init(), pldm_pdr_destroy);
+        pldm_pdr_init_arena(0), pldm_pdr_destroy);
     std::unique_ptr<pldm_entity_association_tree,
                     decltype(&pldm_entity_association_tree_destroy)>
         entityTree(pldm_entity_association_tree_init(),
@@ -354,14 +362,19 @@ int main(int argc, char** argv)
         exit(EXIT_FAILURE);
     }
 
-    auto callback = [verbose, &invoker, &reqHandler, currentSendbuffSize](
-                        IO& io, int fd, uint32_t revents) mutable {
-        if (!(revents & EPOLLIN))
+    // Sends the responses of the handlers, the ones they return as well as
+    // the ones they defer
+    auto sendResponse = [verbose, &currentSendbuffSize,
+                         fd = socketFd()](uint8_t eid,
+                                          const Response& response) {
+        FlightRecorder::GetInstance().saveRecord(response, true);
+        if (verbose)
         {
-            return;
+            printBuffer(Tx, response);
         }
 
         // Outgoing message.
+        uint8_t header[] = {eid, MCTP_MSG_TYPE_PLDM};
         struct iovec iov[2]{};
 
         // This structure contains the parameter information for the response
@@ -369,9 +382,101 @@ int main(int argc, char** argv)
         struct msghdr msg
         {};
 
+        iov[0].iov_base = header;
+        iov[0].iov_len = sizeof(header);
+        iov[1].iov_base = const_cast<uint8_t*>(response.data());
+        iov[1].iov_len = response.size();
+
+        msg.msg_iov = iov;
+        msg.msg_iovlen = sizeof(iov) / sizeof(iov[0]);
+        if (currentSendbuffSize >= 0 &&
+            (size_t)currentSendbuffSize < response.size())
+        {
+            currentSendbuffSize = response.size();
+            int res = setsockopt(fd, SOL_SOCKET, SO_SNDBUF,
+                                 &currentSendbuffSize,
+                                 sizeof(currentSendbuffSize));
+            if (res == -1)
+                std::cerr << "Tx: Error calling setsockopt. RC = " << res
+                          << ", errno = " << errno << std::endl;
+        }
+
+        int result = sendmsg(fd, &msg, 0);
+        if (-1 == result)
+        {
+            std::cerr << "sendto system call failed, RC= " << -errno << "\n";
+        }
+    };
+
+    // Deferred responses completed on another thread are handed over to the
+    // event loop, which sends them
+    auto loopThread = std::this_thread::get_id();
+    std::mutex completedMutex;
+    std::vector<std::pair<uint8_t, Response>> completed;
+    pldm::utils::CustomFD completedFd(eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK));
+    if (completedFd() < 0)
+    {
+        returnCode = -errno;
+        std::cerr << "Failed to create the completion eventfd, RC= "
+                  << returnCode << "\n";
+        exit(EXIT_FAILURE);
+    }
+    IO completedIO(event, completedFd(), EPOLLIN,
+                   [&completedMutex, &completed,
+                    &sendResponse](IO&, int fd, uint32_t) {
+                       uint64_t count = 0;
+                       if (read(fd, &count, sizeof(count)) < 0 &&
+                           errno != EAGAIN)
+                       {
+                           std::cerr << "Failed to read the completion "
+                                        "eventfd, errno = "
+                                     << errno << "\n";
+                       }
+                       std::vector<std::pair<uint8_t, Response>> responses;
+                       {
+                           std::lock_guard lock(completedMutex);
+                           responses.swap(completed);
+                       }
+                       for (const auto& [eid, response] : responses)
+                       {
+                           sendResponse(eid, response);
+                       }
+                   });
+    invoker.setResponseSender([loopThread, &completedMutex, &completed,
+                               &completedFd, &sendResponse](
+                                  uint8_t eid, const Response& response) {
+        if (std::this_thread::get_id() == loopThread)
+        {
+            sendResponse(eid, response);
+            return;
+        }
+        {
+            std::lock_guard lock(completedMutex);
+            completed.emplace_back(eid, response);
+        }
+        uint64_t one = 1;
+        if (write(completedFd(), &one, sizeof(one)) < 0)
+        {
+            std::cerr << "Failed to signal a completed response, errno = "
+                      << errno << "\n";
+        }
+    });
+
+    // Every message is received straight into rxBuffer, with one recv() and
+    // no allocation. The buffer fits the largest MCTP message, anything
+    // longer is not from the demux daemon and is dropped.
+    auto callback = [verbose, &invoker, &reqHandler, &sendResponse,
+                     rxBuffer = std::vector<uint8_t>(maxRxMessageSize)](
+                        IO& io, int fd, uint32_t revents) mutable {
+        if (!(revents & EPOLLIN))
+        {
+            return;
+        }
+
         int returnCode = 0;
-        ssize_t peekedLength = recv(fd, nullptr, 0, MSG_PEEK | MSG_TRUNC);
-        if (0 == peekedLength)
+        ssize_t recvDataLength =
+            recv(fd, rxBuffer.data(), rxBuffer.size(), MSG_TRUNC);
+        if (0 == recvDataLength)
         {
             // MCTP daemon has closed the socket this daemon is connected to.
             // This may or may not be an error scenario, in either case the
@@ -380,82 +485,52 @@ int main(int argc, char** argv)
             // failure code.
             io.get_event().exit(0);
         }
-        else if (peekedLength <= -1)
+        else if (recvDataLength <= -1)
         {
             returnCode = -errno;
             std::cerr << "recv system call failed, RC= " << returnCode << "\n";
         }
+        else if (static_cast<size_t>(recvDataLength) > rxBuffer.size())
+        {
+            std::cerr << "Dropped a message longer than the MCTP maximum, "
+                         "length="
+                      << recvDataLength << "\n";
+        }
+        else if (static_cast<size_t>(recvDataLength) <
+                 sizeof(uint8_t) * 2 + sizeof(pldm_msg_hdr))
+        {
+            std::cerr << "Dropped a message too short for a PLDM header, "
+                         "length="
+                      << recvDataLength << "\n";
+        }
         else
         {
-            std::vector<uint8_t> requestMsg(peekedLength);
-            auto recvDataLength = recv(
-                fd, static_cast<void*>(requestMsg.data()), peekedLength, 0);
-            if (recvDataLength == peekedLength)
+            const uint8_t* requestMsg = rxBuffer.data();
+            FlightRecorder::GetInstance().saveRecord(requestMsg,
+                                                     recvDataLength, false);
+            if (verbose)
             {
-                FlightRecorder::GetInstance().saveRecord(requestMsg, false);
-                if (verbose)
-                {
-                    printBuffer(Rx, requestMsg);
-                }
+                printBuffer(Rx, std::vector<uint8_t>(
+                                    requestMsg, requestMsg + recvDataLength));
+            }
 
-                if (MCTP_MSG_TYPE_PLDM != requestMsg[1])
-                {
-                    // Skip this message and continue.
-                    std::cerr << "Encountered Non-PLDM type message"
-                              << "\n";
-                }
-                else
-                {
-                    // process message and send response
-                    auto response =
-                        processRxMsg(requestMsg, invoker, reqHandler);
-                    if (response.has_value())
-                    {
-                        FlightRecorder::GetInstance().saveRecord(*response,
-                                                                 true);
-                        if (verbose)
-                        {
-                            printBuffer(Tx, *response);
-                        }
-
-                        iov[0].iov_base = &requestMsg[0];
-                        iov[0].iov_len =
-                            sizeof(requestMsg[0]) + sizeof(requestMsg[1]);
-                        iov[1].iov_base = (*response).data();
-                        iov[1].iov_len = (*response).size();
-
-                        msg.msg_iov = iov;
-                        msg.msg_iovlen = sizeof(iov) / sizeof(iov[0]);
-                        if (currentSendbuffSize >= 0 &&
-                            (size_t)currentSendbuffSize < (*response).size())
-                        {
-                            currentSendbuffSize = (*response).size();
-                            int res = setsockopt(fd, SOL_SOCKET, SO_SNDBUF,
-                                                 &currentSendbuffSize,
-                                                 sizeof(currentSendbuffSize));
-                            if (res == -1)
-                                std::cerr
-                                    << "Tx: Error calling setsockopt. RC = "
-                                    << res << ", errno = " << errno
-                                    << std::endl;
-                        }
-
-                        int result = sendmsg(fd, &msg, 0);
-                        if (-1 == result)
-                        {
-                            returnCode = -errno;
-                            std::cerr << "sendto system call failed, RC= "
-                                      << returnCode << "\n";
-                        }
-                    }
-                }
+            if (MCTP_MSG_TYPE_PLDM != requestMsg[1])
+            {
+                // Skip this message and continue.
+                std::cerr << "Encountered Non-PLDM type message"
+                          << "\n";
             }
             else
             {
-                std::cerr
-                    << "Failure to read peeked length packet. peekedLength= "
-                    << peekedLength << " recvDataLength=" << recvDataLength
-                    << "\n";
+                // process message and send response
+                auto response = processRxMsg(requestMsg, recvDataLength,
+                                             invoker, reqHandler);
+                // An empty response was deferred by its handler, which
+                // sends it once ready
+                if (response.has_value() && !response->empty())
+                {
+                    sendResponse(requestMsg[0], *response);
+                }
             }
         }
     };
@@ -474,14 +549,23 @@ int main(int argc, char** argv)
     stdplus::signal::block(SIGUSR1);
     sdeventplus::source::Signal sigUsr1(
         event, SIGUSR1, std::bind_front(&interruptFlightRecorderCallBack));
+
+    // Stopping the daemon leaves the event loop, so that main returns and
+    // the handlers get to write out what they hold, such as the BIOS tables
+    auto stopDaemon = [](Signal& signal, const struct signalfd_siginfo*) {
+        signal.get_event().exit(0);
+    };
+    Signal sigTerm(event, SIGTERM, stopDaemon);
+    Signal sigInt(event, SIGINT, stopDaemon);
+
     returnCode = event.loop();
     if (shutdown(sockfd, SHUT_RDWR))
     {
         std::perror("Failed to shutdown the socket");
     }
-    if (returnCode)
-    {
-        exit(EXIT_FAILURE);
-    }
-    exit(EXIT_SUCCESS);
+
+    // A job still running may send a response, through the locals of main
+    Worker::get().stop();
+
+    return returnCode ? EXIT_FAILURE : EXIT_SUCCESS;
 }
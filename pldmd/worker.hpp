@@ -0,0 +1,111 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace pldm
+{
+
+namespace responder
+{
+
+/** @class Worker
+ *
+ *  Runs jobs on a thread of its own, one at a time and in the order they are
+ *  posted, for work too slow for the event loop. A job must not touch the
+ *  state the event loop works on, such as the D-Bus connection or the PDR
+ *  repo.
+ */
+class Worker
+{
+  public:
+    Worker() : thread(&Worker::run, this)
+    {}
+
+    Worker(const Worker&) = delete;
+    Worker& operator=(const Worker&) = delete;
+    Worker(Worker&&) = delete;
+    Worker& operator=(Worker&&) = delete;
+
+    ~Worker()
+    {
+        stop();
+    }
+
+    /** @brief The worker shared by the command handlers */
+    static Worker& get()
+    {
+        static Worker worker;
+        return worker;
+    }
+
+    /** @brief Whether the calling thread is a worker thread */
+    static bool onWorkerThread()
+    {
+        return isWorkerThread;
+    }
+
+    /** @brief Stop the thread once the running job is done, the jobs still
+     *         queued are dropped. The jobs posted from then on never run.
+     */
+    void stop()
+    {
+        {
+            std::lock_guard lock(mutex);
+            stopping = true;
+        }
+        queued.notify_one();
+        if (thread.joinable())
+        {
+            thread.join();
+        }
+    }
+
+    /** @brief Queue a job
+     *
+     *  @param[in] job - job to run on the worker thread
+     */
+    void post(std::function<void()> job)
+    {
+        {
+            std::lock_guard lock(mutex);
+            jobs.push_back(std::move(job));
+        }
+        queued.notify_one();
+    }
+
+  private:
+    void run()
+    {
+        isWorkerThread = true;
+        std::unique_lock lock(mutex);
+        while (true)
+        {
+            queued.wait(lock, [this] { return stopping || !jobs.empty(); });
+            if (stopping)
+            {
+                return;
+            }
+
+            auto job = std::move(jobs.front());
+            jobs.pop_front();
+            lock.unlock();
+            job();
+            lock.lock();
+        }
+    }
+
+    std::mutex mutex;
+    std::condition_variable queued;
+    std::deque<std::function<void()>> jobs;
+    bool stopping = false;
+    static inline thread_local bool isWorkerThread = false;
+
+    std::thread thread;
+};
+
+} // namespace responder
+} // namespace pldm
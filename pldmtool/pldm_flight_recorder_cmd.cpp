@@ -0,0 +1,98 @@
+#include "pldm_flight_recorder_cmd.hpp"
+
+#include "common/flight_recorder.hpp"
+#include "pldm_cmd_helper.hpp"
+
+#include <ctime>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+namespace pldmtool
+{
+
+namespace flightrecorder
+{
+
+namespace
+{
+
+using namespace pldmtool::helper;
+using namespace pldm::flightrecorder;
+
+std::string dumpFile = flightRecorderDumpPath;
+
+/** @brief Format a CLOCK_REALTIME time in ns the way pldmd logs time */
+std::string formatTime(uint64_t realTime)
+{
+    std::time_t seconds = realTime / 1000000000;
+    auto micros = (realTime % 1000000000) / 1000;
+    std::stringstream ss;
+    ss << std::put_time(std::localtime(&seconds), "%F %Z %T.")
+       << std::setfill('0') << std::setw(6) << micros;
+    return ss.str();
+}
+
+/** @brief Decode a dump written by FlightRecorder::playRecorder() */
+void decode()
+{
+    std::ifstream dump(dumpFile, std::ios::binary);
+    if (!dump)
+    {
+        std::cerr << "Failed to open " << dumpFile << "\n";
+        return;
+    }
+
+    FlightRecorderFileHeader header{};
+    if (!dump.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+        std::memcmp(header.magic, flightRecorderMagic, sizeof(header.magic)) ||
+        header.version != flightRecorderVersion ||
+        header.slotSize != sizeof(FlightRecorderSlot))
+    {
+        std::cerr << dumpFile << " is not a flight recorder dump\n";
+        return;
+    }
+
+    ordered_json data = ordered_json::array();
+    FlightRecorderSlot slot{};
+    for (uint32_t i = 0; i < header.entries; ++i)
+    {
+        if (!dump.read(reinterpret_cast<char*>(&slot), sizeof(slot)))
+        {
+            std::cerr << dumpFile << " is truncated\n";
+            break;
+        }
+
+        std::stringstream bytes;
+        auto captured = std::min<size_t>(slot.length, sizeof(slot.data));
+        for (size_t j = 0; j < captured; ++j)
+        {
+            bytes << (j ? " " : "") << std::setfill('0') << std::setw(2)
+                  << std::hex << (unsigned)slot.data[j];
+        }
+
+        ordered_json record;
+        record["Time"] = formatTime(header.realTime -
+                                    (header.monotonicTime - slot.timestamp));
+        record["Direction"] = slot.isTx ? "Tx" : "Rx";
+        record["Length"] = slot.length;
+        record["Data"] = bytes.str();
+        data.emplace_back(std::move(record));
+    }
+    DisplayInJson(data);
+}
+
+} // namespace
+
+void registerCommand(CLI::App& app)
+{
+    auto flightRecorder = app.add_subcommand(
+        "flightrecorder", "decode a flight recorder dump of pldmd");
+    flightRecorder->add_option("-f,--file", dumpFile,
+                               "flight recorder dump, written by pldmd on "
+                               "SIGUSR1");
+    flightRecorder->callback(decode);
+}
+
+} // namespace flightrecorder
+} // namespace pldmtool
@@ -1,5 +1,6 @@
 #include "libpldm/entity.h"
 #include "libpldm/state_set.h"
+#include "libpldm/utils.h"
 
 #include "common/types.hpp"
 #include "pldm_cmd_helper.hpp"
@@ -101,7 +102,7 @@ class GetPDR : public CommandInterface
             uint32_t prevRecordHandle = 0;
             do
             {
-                CommandInterface::exec();
+                getRecord();
                 // recordHandle is updated to nextRecord when
                 // CommandInterface::exec() is successful.
                 // In case of any error, return.
@@ -114,19 +115,36 @@ class GetPDR : public CommandInterface
         }
         else
         {
-            CommandInterface::exec();
+            getRecord();
         }
     }
 
+    /** @brief Retrieve the PDR at recordHandle, one GetPDR command per part
+     *  of a multipart transfer
+     */
+    void getRecord()
+    {
+        pdrData.clear();
+        dataTransferHandle = 0;
+        transferOpFlag = PLDM_GET_FIRSTPART;
+        do
+        {
+            // parseResponseMsg() sets it again if there is another part
+            transferPending = false;
+            CommandInterface::exec();
+        } while (transferPending);
+    }
+
     std::pair<int, std::vector<uint8_t>> createRequestMsg() override
     {
         std::vector<uint8_t> requestMsg(sizeof(pldm_msg_hdr) +
                                         PLDM_GET_PDR_REQ_BYTES);
         auto request = reinterpret_cast<pldm_msg*>(requestMsg.data());
 
-        auto rc =
-            encode_get_pdr_req(instanceId, recordHandle, 0, PLDM_GET_FIRSTPART,
-                               UINT16_MAX, 0, request, PLDM_GET_PDR_REQ_BYTES);
+        auto rc = encode_get_pdr_req(instanceId, recordHandle,
+                                     dataTransferHandle, transferOpFlag,
+                                     UINT16_MAX, 0, request,
+                                     PLDM_GET_PDR_REQ_BYTES);
         return {rc, requestMsg};
     }
 
@@ -153,7 +171,23 @@ class GetPDR : public CommandInterface
             return;
         }
 
-        printPDRMsg(nextRecordHndl, respCnt, recordData);
+        pdrData.insert(pdrData.end(), recordData, recordData + respCnt);
+        if (transferFlag == PLDM_START || transferFlag == PLDM_MIDDLE)
+        {
+            dataTransferHandle = nextDataTransferHndl;
+            transferOpFlag = PLDM_GET_NEXTPART;
+            transferPending = true;
+            return;
+        }
+        if (transferFlag == PLDM_END &&
+            crc8(pdrData.data(), pdrData.size()) != transferCRC)
+        {
+            std::cerr << "Response Message Error: transfer CRC mismatch"
+                      << std::endl;
+            return;
+        }
+
+        printPDRMsg(nextRecordHndl, pdrData.size(), pdrData.data());
         recordHandle = nextRecordHndl;
     }
 
@@ -1023,6 +1057,10 @@ class GetPDR : public CommandInterface
     uint32_t recordHandle;
     bool allPDRs;
     std::string pdrRecType;
+    uint32_t dataTransferHandle = 0;
+    uint8_t transferOpFlag = PLDM_GET_FIRSTPART;
+    bool transferPending = false;
+    std::vector<uint8_t> pdrData;
 };
 
 class SetStateEffecter : public CommandInterface
@@ -0,0 +1,190 @@
+#include "libpldm/base.h"
+
+#include "pldmd/invoker.hpp"
+
+#include <chrono>
+#include <condition_variable>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace pldm;
+using namespace pldm::responder;
+using namespace std::chrono_literals;
+
+constexpr Type testType = PLDM_OEM;
+constexpr Command fastCmd = 0x01;
+constexpr Command slowCmd = 0x02;
+constexpr Command failingCmd = 0x03;
+
+/** @brief Answers the fast command right away, the slow one from the worker
+ *         once released, and fails the failing one from a thread of its own
+ */
+class TestHandler : public CmdHandler
+{
+  public:
+    TestHandler(std::shared_future<void> release) : release(std::move(release))
+    {
+        handlers.emplace(fastCmd,
+                         [](const pldm_msg* request, size_t /*payloadLength*/) {
+                             return ccOnlyResponse(request, PLDM_SUCCESS);
+                         });
+        handlers.emplace(slowCmd, [this](const pldm_msg* request,
+                                         size_t /*payloadLength*/) {
+            auto instanceId = request->hdr.instance_id;
+            return respondFromWorker([this, instanceId] {
+                this->release.wait();
+                Response response(sizeof(pldm_msg_hdr) + 1, 0);
+                auto responsePtr = reinterpret_cast<pldm_msg*>(response.data());
+                encode_cc_only_resp(instanceId, testType, slowCmd,
+                                    PLDM_SUCCESS, responsePtr);
+                return response;
+            });
+        });
+        handlers.emplace(failingCmd, [this](const pldm_msg* /*request*/,
+                                            size_t /*payloadLength*/) {
+            std::thread([deferred = deferResponse()] {
+                deferred.complete(PLDM_ERROR_NOT_READY);
+            }).detach();
+            return Response{};
+        });
+    }
+
+  private:
+    std::shared_future<void> release;
+};
+
+/** @brief Records the responses sent, from whichever thread sends them */
+class Sender
+{
+  public:
+    void operator()(uint8_t eid, const Response& response)
+    {
+        std::lock_guard lock(mutex);
+        sent.emplace_back(eid, response);
+        cv.notify_all();
+    }
+
+    std::vector<std::pair<uint8_t, Response>> waitFor(size_t count)
+    {
+        std::unique_lock lock(mutex);
+        EXPECT_TRUE(
+            cv.wait_for(lock, 5s, [&] { return sent.size() >= count; }));
+        return sent;
+    }
+
+  private:
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::vector<std::pair<uint8_t, Response>> sent;
+};
+
+std::vector<uint8_t> request(Command command, uint8_t instanceId)
+{
+    std::vector<uint8_t> msg(sizeof(pldm_msg_hdr));
+    pldm_header_info header{};
+    header.msg_type = PLDM_REQUEST;
+    header.instance = instanceId;
+    header.pldm_type = testType;
+    header.command = command;
+    pack_pldm_header(&header, reinterpret_cast<pldm_msg_hdr*>(msg.data()));
+    return msg;
+}
+
+std::optional<Response> dispatch(Invoker& invoker, uint8_t eid,
+                                 Command command, uint8_t instanceId)
+{
+    auto msg = request(command, instanceId);
+    return invoker.handle(eid, testType, command,
+                          reinterpret_cast<const pldm_msg*>(msg.data()), 0);
+}
+
+TEST(DeferredResponse, SlowAndFastCommands)
+{
+    std::promise<void> release;
+    Sender sender;
+    Invoker invoker{};
+    invoker.registerHandler(
+        testType,
+        std::make_unique<TestHandler>(release.get_future().share()));
+    invoker.setResponseSender(std::ref(sender));
+
+    // The slow commands are deferred, the fast ones are answered while the
+    // slow ones are still running
+    auto slow = dispatch(invoker, 9, slowCmd, 1);
+    ASSERT_TRUE(slow.has_value());
+    EXPECT_TRUE(slow->empty());
+    slow = dispatch(invoker, 10, slowCmd, 2);
+    ASSERT_TRUE(slow.has_value());
+    EXPECT_TRUE(slow->empty());
+    for (uint8_t instanceId = 3; instanceId < 6; ++instanceId)
+    {
+        auto fast = dispatch(invoker, 9, fastCmd, instanceId);
+        ASSERT_TRUE(fast.has_value());
+        EXPECT_EQ(fast->size(), sizeof(pldm_msg));
+    }
+    std::this_thread::sleep_for(10ms);
+    EXPECT_TRUE(sender.waitFor(0).empty());
+
+    // Once released, they are sent in order, to the endpoint and with the
+    // instance ID of their request
+    release.set_value();
+    auto sent = sender.waitFor(2);
+    ASSERT_EQ(sent.size(), 2);
+    std::pair<uint8_t, uint8_t> expected[] = {{9, 1}, {10, 2}};
+    for (size_t i = 0; i < sent.size(); ++i)
+    {
+        const auto& [eid, response] = sent[i];
+        auto responsePtr = reinterpret_cast<const pldm_msg*>(response.data());
+        EXPECT_EQ(eid, expected[i].first);
+        EXPECT_EQ(responsePtr->hdr.instance_id, expected[i].second);
+        EXPECT_EQ(responsePtr->hdr.request, 0);
+        EXPECT_EQ(responsePtr->hdr.command, slowCmd);
+        EXPECT_EQ(responsePtr->payload[0], PLDM_SUCCESS);
+    }
+}
+
+TEST(DeferredResponse, CompleteWithCc)
+{
+    std::promise<void> release;
+    Sender sender;
+    Invoker invoker{};
+    invoker.setResponseSender(std::ref(sender));
+    invoker.registerHandler(
+        testType,
+        std::make_unique<TestHandler>(release.get_future().share()));
+
+    auto response = dispatch(invoker, 20, failingCmd, 7);
+    ASSERT_TRUE(response.has_value());
+    EXPECT_TRUE(response->empty());
+
+    auto sent = sender.waitFor(1);
+    ASSERT_EQ(sent.size(), 1);
+    EXPECT_EQ(sent[0].first, 20);
+    auto responsePtr = reinterpret_cast<const pldm_msg*>(sent[0].second.data());
+    EXPECT_EQ(responsePtr->hdr.instance_id, 7);
+    EXPECT_EQ(responsePtr->hdr.type, testType);
+    EXPECT_EQ(responsePtr->hdr.command, failingCmd);
+    EXPECT_EQ(responsePtr->payload[0], PLDM_ERROR_NOT_READY);
+}
+
+TEST(DeferredResponse, NoSender)
+{
+    // Without a sender the slow command is answered synchronously
+    std::promise<void> release;
+    release.set_value();
+    Invoker invoker{};
+    invoker.registerHandler(
+        testType,
+        std::make_unique<TestHandler>(release.get_future().share()));
+
+    auto response = dispatch(invoker, 9, slowCmd, 4);
+    ASSERT_TRUE(response.has_value());
+    ASSERT_FALSE(response->empty());
+    auto responsePtr = reinterpret_cast<const pldm_msg*>(response->data());
+    EXPECT_EQ(responsePtr->hdr.instance_id, 4);
+    EXPECT_EQ(responsePtr->payload[0], PLDM_SUCCESS);
+}
@@ -0,0 +1,125 @@
+#include "libpldm/base.h"
+
+#include "pldmd/invoker.hpp"
+
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <vector>
+
+using namespace pldm;
+using namespace pldm::responder;
+
+namespace
+{
+
+constexpr Type registeredTypes = 4;
+constexpr Command registeredCmds = 16;
+constexpr size_t messageCount = 4096;
+constexpr size_t rounds = 256;
+
+class BenchHandler : public CmdHandler
+{
+  public:
+    BenchHandler()
+    {
+        for (Command cmd = 0; cmd < registeredCmds; ++cmd)
+        {
+            handlers.emplace(cmd, [](const pldm_msg* request,
+                                     size_t /*payloadLength*/) {
+                return ccOnlyResponse(request, PLDM_SUCCESS);
+            });
+        }
+    }
+};
+
+/** @brief Build a request as pldmd receives it, MCTP EID and message type
+ *         first
+ */
+std::vector<uint8_t> makeRequest(Type type, Command cmd)
+{
+    std::vector<uint8_t> msg(2 + sizeof(pldm_msg_hdr) + 4, 0);
+    msg[0] = 9;
+    msg[1] = 1;
+    pldm_header_info header{};
+    header.msg_type = PLDM_REQUEST;
+    header.pldm_type = type;
+    header.command = cmd;
+    pack_pldm_header(&header, reinterpret_cast<pldm_msg_hdr*>(&msg[2]));
+    return msg;
+}
+
+/** @brief The responder half of processRxMsg() in pldmd */
+Response dispatch(const std::vector<uint8_t>& requestMsg, Invoker& invoker)
+{
+    pldm_header_info hdrFields{};
+    auto hdr = reinterpret_cast<const pldm_msg_hdr*>(requestMsg.data() + 2);
+    unpack_pldm_header(hdr, &hdrFields);
+    auto request = reinterpret_cast<const pldm_msg*>(hdr);
+    size_t requestLen = requestMsg.size() - sizeof(pldm_msg_hdr) - 2;
+    auto response = invoker.handle(requestMsg[0], hdrFields.pldm_type,
+                                   hdrFields.command, request, requestLen);
+    if (!response)
+    {
+        response = CmdHandler::ccOnlyResponse(request,
+                                              PLDM_ERROR_UNSUPPORTED_PLDM_CMD);
+    }
+    return *response;
+}
+
+} // namespace
+
+int main()
+{
+    Invoker invoker{};
+    for (Type type = 0; type < registeredTypes; ++type)
+    {
+        invoker.registerHandler(type, std::make_unique<BenchHandler>());
+    }
+
+    // 70% supported commands, 20% unsupported commands of a supported type,
+    // 10% unsupported types
+    std::mt19937 gen(1);
+    std::uniform_int_distribution<int> pick(0, 9);
+    std::uniform_int_distribution<int> type(0, registeredTypes - 1);
+    std::uniform_int_distribution<int> cmd(0, registeredCmds - 1);
+    std::vector<std::vector<uint8_t>> messages;
+    for (size_t i = 0; i < messageCount; ++i)
+    {
+        auto p = pick(gen);
+        if (p < 7)
+        {
+            messages.emplace_back(makeRequest(type(gen), cmd(gen)));
+        }
+        else if (p < 9)
+        {
+            messages.emplace_back(
+                makeRequest(type(gen), registeredCmds + cmd(gen)));
+        }
+        else
+        {
+            messages.emplace_back(
+                makeRequest(registeredTypes + type(gen), cmd(gen)));
+        }
+    }
+
+    size_t unsupported = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t round = 0; round < rounds; ++round)
+    {
+        for (const auto& message : messages)
+        {
+            auto response = dispatch(message, invoker);
+            unsupported += response.back() == PLDM_ERROR_UNSUPPORTED_PLDM_CMD;
+        }
+    }
+    auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - start);
+
+    auto total = messageCount * rounds;
+    std::cout << "processRxMsg dispatch: " << total << " messages, "
+              << unsupported << " unsupported, "
+              << elapsed.count() / total << " ns/message, "
+              << total * 1000000000ull / elapsed.count() << " messages/s\n";
+    return 0;
+}
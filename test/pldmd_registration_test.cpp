@@ -2,7 +2,7 @@
 
 #include "pldmd/invoker.hpp"
 
-#include <stdexcept>
+#include <optional>
 
 #include <gtest/gtest.h>
 
@@ -10,6 +10,7 @@ using namespace pldm;
 using namespace pldm::responder;
 constexpr Command testCmd = 0xFF;
 constexpr Type testType = 0xFF;
+constexpr uint8_t testEid = 9;
 
 class TestHandler : public CmdHandler
 {
@@ -43,18 +44,22 @@ TEST(Registration, testSuccess)
 {
     Invoker invoker{};
     invoker.registerHandler(testType, std::make_unique<TestHandler>());
-    auto result = invoker.handle(testType, testCmd, nullptr, 0);
-    ASSERT_EQ(result[0], 100);
-    ASSERT_EQ(result[1], 200);
+    auto result = invoker.handle(testEid, testType, testCmd, nullptr, 0);
+    ASSERT_TRUE(result.has_value());
+    ASSERT_EQ((*result)[0], 100);
+    ASSERT_EQ((*result)[1], 200);
 }
 
 TEST(Registration, testFailure)
 {
     Invoker invoker{};
-    ASSERT_THROW(invoker.handle(testType, testCmd, nullptr, 0),
-                 std::out_of_range);
+    ASSERT_EQ(invoker.handle(testEid, testType, testCmd, nullptr, 0),
+              std::nullopt);
     invoker.registerHandler(testType, std::make_unique<TestHandler>());
     uint8_t badCmd = 0xFE;
-    ASSERT_THROW(invoker.handle(testType, badCmd, nullptr, 0),
-                 std::out_of_range);
+    ASSERT_EQ(invoker.handle(testEid, testType, badCmd, nullptr, 0),
+              std::nullopt);
+    Type badType = 0xFE;
+    ASSERT_EQ(invoker.handle(testEid, badType, testCmd, nullptr, 0),
+              std::nullopt);
 }